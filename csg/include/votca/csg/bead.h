@@ -29,6 +29,7 @@
 
 // Local VOTCA includes
 #include "basebead.h"
+#include "beadcoordinates.h"
 
 namespace votca {
 namespace csg {
@@ -41,8 +42,8 @@ class Molecule;
  *
  * The Bead class describes an atom or a coarse grained bead. It stores
  * information like the id, the name, the mass, the
- * charge and the residue it belongs to. The coordinates are stored in the
- * configuration class.
+ * charge and the residue it belongs to. The position, velocity and force are
+ * stored in the BeadCoordinates of the topology the bead belongs to.
  *
  * \todo change resnr to pointer
  * \todo make sure bead belongs to topology
@@ -85,6 +86,32 @@ class Bead : public BaseBead {
   enum Symmetry { spherical = 1, ellipsoidal = 3 };
   Symmetry getSymmetry() const { return symmetry_; }
 
+  /**
+   * set the position of the bead
+   * @param bead_position bead position
+   */
+  void setPos(const Eigen::Vector3d &bead_position) override;
+
+  /**
+   * get the position of the bead
+   * \return bead position
+   */
+  const Eigen::Vector3d &getPos() const override;
+
+  /**
+   * direct access (read/write) to the position of the bead
+   * \return reference to position
+   */
+  Eigen::Vector3d &Pos() override {
+    assert(bead_position_set_ && "Position is not set.");
+    return coordinates_->pos_[id_];
+  }
+
+  const Eigen::Vector3d &Pos() const override {
+    assert(bead_position_set_ && "Position is not set.");
+    return coordinates_->pos_[id_];
+  }
+
   /**
    * set the velocity of the bead
    * @param r bead velocity
@@ -173,7 +200,7 @@ class Bead : public BaseBead {
   Eigen::Vector3d &Vel() {
     assert(bead_velocity_set_ &&
            "Cannot access velocity, it has not been set.");
-    return velocity_;
+    return coordinates_->vel_[id_];
   }
 
   /**
@@ -209,7 +236,7 @@ class Bead : public BaseBead {
    */
   Eigen::Vector3d &F() {
     assert(bead_force_set_ && "Cannot access bead force, has not been set.");
-    return bead_force_;
+    return coordinates_->force_[id_];
   }
 
   /**
@@ -284,7 +311,10 @@ class Bead : public BaseBead {
 
   Index residue_number_;
 
-  Eigen::Vector3d velocity_, bead_force_, u_, v_, w_;
+  Eigen::Vector3d u_, v_, w_;
+
+  /// coordinates of the topology, indexed by the bead id
+  BeadCoordinates *coordinates_;
 
   bool bead_velocity_set_;
   bool bU_;
@@ -294,8 +324,11 @@ class Bead : public BaseBead {
 
   /// constructor
   Bead(Index id, std::string type, Symmetry symmetry, std::string name,
-       Index resnr, double m, double q)
-      : symmetry_(symmetry), charge_(q), residue_number_(resnr) {
+       Index resnr, double m, double q, BeadCoordinates *coordinates)
+      : symmetry_(symmetry),
+        charge_(q),
+        residue_number_(resnr),
+        coordinates_(coordinates) {
     setId(id);
     setType(type);
     setName(name);
@@ -312,15 +345,26 @@ class Bead : public BaseBead {
   friend class Molecule;
 };
 
+inline void Bead::setPos(const Eigen::Vector3d &bead_position) {
+  bead_position_set_ = true;
+  coordinates_->pos_[id_] = bead_position;
+}
+
+inline const Eigen::Vector3d &Bead::getPos() const {
+  assert(bead_position_set_ &&
+         "Cannot get bead position as it has not been set.");
+  return coordinates_->pos_[id_];
+}
+
 inline void Bead::setVel(const Eigen::Vector3d &r) {
   bead_velocity_set_ = true;
-  velocity_ = r;
+  coordinates_->vel_[id_] = r;
 }
 
 inline const Eigen::Vector3d &Bead::getVel() const {
   assert(bead_velocity_set_ &&
          "Cannot access bead velocity, has not been set.");
-  return velocity_;
+  return coordinates_->vel_[id_];
 }
 
 inline void Bead::setU(const Eigen::Vector3d &u) {
@@ -355,12 +399,12 @@ inline const Eigen::Vector3d &Bead::getW() const {
 
 inline void Bead::setF(const Eigen::Vector3d &bead_force) {
   bead_force_set_ = true;
-  bead_force_ = bead_force;
+  coordinates_->force_[id_] = bead_force;
 }
 
 inline const Eigen::Vector3d &Bead::getF() const {
   assert(bead_force_set_ && "Cannot access bead force, has not been set.");
-  return bead_force_;
+  return coordinates_->force_[id_];
 }
 
 inline void Bead::HasVel(bool b) { bead_velocity_set_ = b; }
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_BEADCOORDINATES_H
+#define VOTCA_CSG_BEADCOORDINATES_H
+
+// Standard includes
+#include <vector>
+
+// VOTCA includes
+#include <votca/tools/eigen.h>
+#include <votca/tools/types.h>
+
+namespace votca {
+namespace csg {
+
+/**
+ * \brief Positions, velocities and forces of all the beads of a topology
+ *
+ * The coordinates are stored in contiguous arrays indexed by the bead id, so
+ * loops over the beads only touch the coordinates instead of striding
+ * through the Bead objects. The beads of a topology keep no coordinates of
+ * their own, getPos, getVel and getF refer to the entries in here.
+ */
+struct BeadCoordinates {
+  std::vector<Eigen::Vector3d> pos_;
+  std::vector<Eigen::Vector3d> vel_;
+  std::vector<Eigen::Vector3d> force_;
+
+  Index size() const { return Index(pos_.size()); }
+
+  /// add the coordinates of a new bead, initialized to zero
+  void push_back() {
+    pos_.push_back(Eigen::Vector3d::Zero());
+    vel_.push_back(Eigen::Vector3d::Zero());
+    force_.push_back(Eigen::Vector3d::Zero());
+  }
+
+  void clear() {
+    pos_.clear();
+    vel_.clear();
+    force_.clear();
+  }
+
+  /// positions as a 3 x N matrix, one column per bead
+  Eigen::Map<const Eigen::Matrix3Xd> Positions() const {
+    return AsMatrix(pos_);
+  }
+  /// velocities as a 3 x N matrix, one column per bead
+  Eigen::Map<const Eigen::Matrix3Xd> Velocities() const {
+    return AsMatrix(vel_);
+  }
+  /// forces as a 3 x N matrix, one column per bead
+  Eigen::Map<const Eigen::Matrix3Xd> Forces() const {
+    return AsMatrix(force_);
+  }
+
+ private:
+  static_assert(sizeof(Eigen::Vector3d) == 3 * sizeof(double),
+                "Eigen::Vector3d must not be padded");
+
+  static Eigen::Map<const Eigen::Matrix3Xd> AsMatrix(
+      const std::vector<Eigen::Vector3d> &v) {
+    return Eigen::Map<const Eigen::Matrix3Xd>(
+        reinterpret_cast<const double *>(v.data()), 3, Index(v.size()));
+  }
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_BEADCOORDINATES_H
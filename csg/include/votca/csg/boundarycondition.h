@@ -19,6 +19,7 @@
 #pragma once
 
 // Standard includes
+#include <cmath>
 #include <memory>
 
 // VOTCA includes
@@ -57,7 +58,10 @@ class BoundaryCondition {
    * set the simulation box
    * \param box triclinic box matrix
    */
-  void setBox(const Eigen::Matrix3d &box) noexcept { box_ = box; };
+  void setBox(const Eigen::Matrix3d &box) noexcept {
+    box_ = box;
+    inv_box_diagonal_ = box.diagonal().array().inverse();
+  };
 
   /**
    * get the simulation box
@@ -89,10 +93,78 @@ class BoundaryCondition {
   enum eBoxtype { typeAuto = 0, typeTriclinic, typeOrthorhombic, typeOpen };
   virtual eBoxtype getBoxType() const noexcept = 0;
 
+  /**
+   * \brief shortest connections from r_i to many positions
+   *
+   * The box type is resolved once for all positions, so the minimum image
+   * is determined without a virtual call per pair.
+   *
+   * \param r_i reference position
+   * \param r_j positions, one per column
+   * \param r_ij shortest connection vectors from r_i to r_j, one per column,
+   * has to have as many columns as r_j
+   * \param dist2 squared lengths of the connection vectors, has to have as
+   * many entries as r_j has columns
+   */
+  void BCShortestConnections(const Eigen::Vector3d &r_i,
+                             const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+                             Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+                             Eigen::Ref<Eigen::VectorXd> dist2) const;
+
+  /**
+   * \brief shortest connections between pairs of positions
+   *
+   * Same as BCShortestConnections, but column k of r_ij connects column k of
+   * r_i to column k of r_j.
+   */
+  void BCShortestConnectionsPairwise(
+      const Eigen::Ref<const Eigen::Matrix3Xd> &r_i,
+      const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+      Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+      Eigen::Ref<Eigen::VectorXd> dist2) const;
+
  protected:
   Eigen::Matrix3d box_;
+  /// 1 / diagonal of the box, the orthorhombic and triclinic minimum image
+  /// only need these divisions
+  Eigen::Array3d inv_box_diagonal_ = Eigen::Array3d::Zero();
+
+  /// minimum image of the connection vector r for a box of the given type
+  template <eBoxtype type>
+  Eigen::Vector3d MinimumImage(const Eigen::Vector3d &r) const;
+
+ private:
+  template <eBoxtype type, class RefPos>
+  void ShortestConnections(const RefPos &r_i,
+                           const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+                           Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+                           Eigen::Ref<Eigen::VectorXd> dist2) const;
+  template <class RefPos>
+  void DispatchShortestConnections(
+      const RefPos &r_i, const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+      Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+      Eigen::Ref<Eigen::VectorXd> dist2) const;
 };
 
+template <BoundaryCondition::eBoxtype type>
+inline Eigen::Vector3d BoundaryCondition::MinimumImage(
+    const Eigen::Vector3d &r) const {
+  if (type == typeOrthorhombic) {
+    const Eigen::Array3d box = box_.diagonal();
+    return (r.array() - box * (r.array() * inv_box_diagonal_).round())
+        .matrix();
+  } else if (type == typeTriclinic) {
+    // see TriclinicBox for the boxes this works for
+    Eigen::Vector3d r_dp =
+        r - box_.col(2) * std::round(r.z() * inv_box_diagonal_.z());
+    Eigen::Vector3d r_sp =
+        r_dp - box_.col(1) * std::round(r_dp.y() * inv_box_diagonal_.y());
+    return r_sp - box_.col(0) * std::round(r_sp.x() * inv_box_diagonal_.x());
+  } else {
+    return r;
+  }
+}
+
 }  // namespace csg
 }  // namespace votca
 
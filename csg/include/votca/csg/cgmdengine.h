@@ -0,0 +1,141 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_CGMDENGINE_H
+#define VOTCA_CSG_CGMDENGINE_H
+
+// Standard includes
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// VOTCA includes
+#include <votca/tools/eigen.h>
+#include <votca/tools/table.h>
+#include <votca/tools/types.h>
+
+// Local VOTCA includes
+#include "beadlist.h"
+#include "nblistgrid.h"
+#include "topology.h"
+
+namespace votca {
+namespace csg {
+
+/**
+ * \brief Molecular dynamics of coarse-grained beads with tabulated potentials
+ *
+ * The beads of a topology are propagated with the BAOAB splitting of the
+ * Langevin equation, without friction this is the velocity Verlet
+ * algorithm. The forces are given by tabulated non-bonded potentials per
+ * pair of bead types, the pairs are found with a NBListGrid in Verlet mode.
+ * Exclusions of the topology are respected, bonded interactions are not
+ * supported.
+ *
+ * Units are the ones used by VOTCA internally: nm, ps, amu and kJ/mol, the
+ * temperature is given as kBT in kJ/mol.
+ */
+class CGMDEngine {
+ public:
+  /**
+   * \brief add a tabulated non-bonded potential between two bead types
+   *
+   * The table has to be on a regular grid, the last grid point is the
+   * cutoff. Below the first grid point the potential is continued linearly.
+   */
+  void AddNonbondedTable(const std::string &type1, const std::string &type2,
+                         const tools::Table &table);
+
+  void setTimeStep(double dt) { dt_ = dt; }
+  double getTimeStep() const { return dt_; }
+  /// thermal energy kBT in kJ/mol
+  void setKBT(double kbt) { kbt_ = kbt; }
+  /// Langevin friction in 1/ps, 0 gives a simulation at constant energy
+  void setFriction(double friction) { friction_ = friction; }
+  void setSeed(Index seed) { rng_.seed(unsigned(seed)); }
+  /// Verlet skin of the neighbour lists
+  void setSkin(double skin) { skin_ = skin; }
+
+  /**
+   * \brief prepare the simulation of the beads of a topology
+   *
+   * The topology has to stay alive while the engine is used. If the
+   * topology has no velocities, they are drawn from the Maxwell-Boltzmann
+   * distribution at kBT.
+   */
+  void Initialize(Topology &top);
+
+  /// propagate the topology by nsteps time steps
+  void Integrate(Index nsteps);
+
+  /// potential energy of the current configuration in kJ/mol
+  double PotentialEnergy() const { return potential_energy_; }
+  /// kinetic energy of the current configuration in kJ/mol
+  double KineticEnergy() const;
+
+ private:
+  /// tabulated potential and force between two bead types
+  class PairPotential {
+   public:
+    PairPotential(const std::string &type1, const std::string &type2,
+                  const tools::Table &table);
+
+    /// match function of the neighbour list, adds the force of a pair
+    bool AddForce(Bead *bead1, Bead *bead2, const Eigen::Vector3d &r,
+                  double dist);
+
+    std::string type1_;
+    std::string type2_;
+    double r_min_;
+    double dr_;
+    double cutoff_;
+    std::vector<double> u_;
+    /// -dU/dr on the grid of u_
+    std::vector<double> f_;
+
+    BeadList list1_;
+    BeadList list2_;
+    NBListGrid nblist_;
+
+    BeadCoordinates *coordinates_ = nullptr;
+    double energy_ = 0.0;
+  };
+
+  void ComputeForces();
+  void DrawVelocities();
+  /// vector of three independent standard normal numbers
+  Eigen::Vector3d GaussianVector();
+
+  Topology *top_ = nullptr;
+  std::vector<std::unique_ptr<PairPotential>> potentials_;
+  Eigen::VectorXd inv_mass_;
+
+  double dt_ = 0.002;
+  double kbt_ = 2.494339;
+  double friction_ = 1.0;
+  double skin_ = 0.1;
+  double potential_energy_ = 0.0;
+
+  std::mt19937 rng_;
+  std::normal_distribution<double> normal_{0.0, 1.0};
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_CGMDENGINE_H
@@ -18,8 +18,14 @@
 #ifndef VOTCA_CSG_CSGAPPLICATION_H
 #define VOTCA_CSG_CSGAPPLICATION_H
 
-// VOTCA includes
+// Standard includes
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+
+// VOTCA includes
 #include <votca/tools/application.h>
 #include <votca/tools/mutex.h>
 #include <votca/tools/thread.h>
@@ -28,6 +34,7 @@
 #include "cgobserver.h"
 #include "topology.h"
 #include "topologymap.h"
+#include "trajectoryreadahead.h"
 #include "trajectoryreader.h"
 
 namespace votca {
@@ -113,11 +120,26 @@ class CsgApplication : public tools::Application {
     /// \brief returns worker id
     Index getId() { return id_; }
 
+    /**
+     * \brief move the results of the current frame into a new worker
+     *
+     * Overload together with CanDetachResult to merge the frames of
+     * synchronized applications through a reorder buffer instead of handing
+     * the order from worker to worker. The returned worker is only passed to
+     * MergeWorker, in the order of the frames, so it has to hold everything
+     * MergeWorker reads. The workers then never wait for each other.
+     */
+    virtual std::unique_ptr<Worker> DetachResult() { return nullptr; }
+    /// \brief overload and return true if DetachResult is implemented
+    virtual bool CanDetachResult() const { return false; }
+
    protected:
     CsgApplication *app_ = nullptr;
     Topology top_, top_cg_;
     std::unique_ptr<TopologyMap> map_;
     Index id_ = -1;
+    /// index of the frame currently processed
+    Index frame_ = -1;
 
     void Run(void) override;
 
@@ -165,6 +187,33 @@ class CsgApplication : public tools::Application {
   /// \brief stores Mutexes used to impose order for output
   std::vector<std::unique_ptr<tools::Mutex>> threadsMutexesOut_;
   std::unique_ptr<TrajectoryReader> traj_reader_;
+  /// \brief reads frames in a separate thread if --read-ahead is given
+  std::unique_ptr<TrajectoryReadAhead> read_ahead_;
+
+  /// \brief true if synchronized workers merge through the reorder buffer
+  bool ordered_merge_ = false;
+  std::atomic<Index> frames_read_{0};
+  /// \brief index of the next frame to be merged
+  Index next_merged_ = 0;
+  /// \brief a worker waits before reading a frame while this many results
+  /// per thread are not merged yet
+  static constexpr Index max_pending_results_ = 4;
+  /// \brief detached results waiting for the merge, by frame index
+  std::map<Index, std::unique_ptr<Worker>> results_;
+  Index workers_running_ = 0;
+  std::mutex results_mutex_;
+  std::condition_variable results_changed_;
+
+  /// \brief true if the workers hand the order of frames to each other
+  bool OrderedHandOff() { return SynchronizeThreads() && !ordered_merge_; }
+  /// \brief add the result of a frame to the reorder buffer
+  void PushResult(Index frame, std::unique_ptr<Worker> result);
+  /// \brief called by each worker when it is done in ordered merge mode
+  void WorkerDone();
+  /// \brief merge the buffered results in order until all workers are done
+  void MergeResultsInOrder();
+  /// \brief wait until the reorder buffer has space for another frame
+  void WaitForMerge();
 };
 
 inline void CsgApplication::AddObserver(CGObserver *observer) {
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <vector>
 
 // Local VOTCA includes
 #include "bead.h"
@@ -59,11 +60,25 @@ class ExclusionList {
 
   using iterator = std::list<exclusion_t *>::iterator;
 
+  using const_iterator = std::list<exclusion_t *>::const_iterator;
+
   iterator begin() { return exclusions_.begin(); }
   iterator end() { return exclusions_.end(); }
+  const_iterator begin() const { return exclusions_.begin(); }
+  const_iterator end() const { return exclusions_.end(); }
 
   bool IsExcluded(Bead *bead1, Bead *bead2) const;
 
+  /**
+   * \brief build a compact lookup table for IsExcluded
+   *
+   * The excluded bead ids are stored sorted in one contiguous array per bead
+   * id. Changing the exclusions afterwards drops the table again and
+   * IsExcluded falls back to searching the lists until it is rebuilt.
+   */
+  void BuildLookupTable();
+  bool HasLookupTable() const { return !row_start_.empty(); }
+
   template <typename iterable>
   void InsertExclusion(Bead *bead, iterable &excluded);
 
@@ -75,6 +90,13 @@ class ExclusionList {
   std::list<exclusion_t *> exclusions_;
   std::map<Bead *, exclusion_t *> excl_by_bead_;
 
+  // compressed rows: the sorted ids of the beads excluded for the bead with
+  // id i, which all have a larger id, are in [row_start_[i], row_start_[i+1])
+  std::vector<Index> row_start_;
+  std::vector<Index> excluded_ids_;
+
+  void DropLookupTable();
+
   friend std::ostream &operator<<(std::ostream &out, ExclusionList &exl);
 };
 
@@ -115,6 +137,7 @@ inline void ExclusionList::InsertExclusion(Bead *beadA, iterable &l) {
       continue;
     }
 
+    DropLookupTable();
     exclusion_t *e;
     if ((e = GetExclusions(bead1)) == nullptr) {
       e = new exclusion_t;
@@ -28,7 +28,6 @@
 #include <votca/tools/property.h>
 
 // Local VOTCA includes
-#include "boundarycondition.h"
 #include "molecule.h"
 
 namespace votca {
@@ -41,18 +40,37 @@ enum class BeadMapType { Spherical, Ellipsoidal };
 *******************************************************/
 class BeadMap {
  public:
+  /// \brief an input bead with its weights for position and velocity and for
+  /// the force
+  struct element_t {
+    const Bead *in_;
+    double weight_;
+    double force_weight_;
+  };
+
   BeadMap() = default;
   virtual ~BeadMap() = default;
-  virtual void Apply(const BoundaryCondition &) = 0;
+  /**
+   * \brief map what is not a linear combination of the input beads
+   *
+   * Position, velocity and force of all beads are mapped by TopologyMap
+   * from Elements() before, e.g. ellipsoidal beads set their orientation.
+   */
+  virtual void Apply() {}
   virtual void Initialize(const Molecule *in, Bead *out,
                           tools::Property *opts_bead,
                           tools::Property *opts_map) = 0;
 
+  /// \brief input beads and weights of the linear part of the map
+  const std::vector<element_t> &Elements() const { return matrix_; }
+  Bead *getOut() const { return out_; }
+
  protected:
   const Molecule *in_;
   Bead *out_;
   tools::Property *opts_map_;
   tools::Property *opts_bead_;
+  std::vector<element_t> matrix_;
 };
 
 /*******************************************************
@@ -69,7 +87,12 @@ class Map {
 
   // void AddBeadMap(BeadMap *bmap) {  maps_.push_back(bmap); }
 
-  void Apply(const BoundaryCondition &bc);
+  /// \brief calls BeadMap::Apply of all beads
+  void Apply();
+
+  const std::vector<std::unique_ptr<BeadMap>> &BeadMaps() const {
+    return maps_;
+  }
 
  protected:
   Molecule in_;
@@ -18,6 +18,12 @@
 #ifndef VOTCA_CSG_NBLIST_H
 #define VOTCA_CSG_NBLIST_H
 
+// Standard includes
+#include <set>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
 // Local VOTCA includes
 #include "beadlist.h"
 #include "beadpair.h"
@@ -93,17 +99,38 @@ class NBList : public PairList<Bead *, BeadPair> {
   /// take into account exclusions from topolgoy
   bool do_exclusions_;
 
-  /// policy function to create new bead types
+  /// policy function to create new bead types, the pair is added to the list
   template <typename pair_type>
-  static BeadPair *beadpair_create_policy(Bead *bead1, Bead *bead2,
+  static BeadPair *beadpair_create_policy(NBList &list, Bead *bead1,
+                                          Bead *bead2,
                                           const Eigen::Vector3d &r) {
-    return dynamic_cast<BeadPair *>(new pair_type(bead1, bead2, r));
+    if constexpr (std::is_same_v<pair_type, BeadPair>) {
+      return list.EmplacePair(bead1, bead2, r);
+    } else {
+      BeadPair *pair = dynamic_cast<BeadPair *>(new pair_type(bead1, bead2, r));
+      list.AddPair(pair);
+      return pair;
+    }
   }
 
-  using pair_creator_t = BeadPair *(*)(Bead *, Bead *, const Eigen::Vector3d &);
+  using pair_creator_t = BeadPair *(*)(NBList &, Bead *, Bead *,
+                                       const Eigen::Vector3d &);
   /// the current bead pair creator function
   pair_creator_t pair_creator_;
 
+  /**
+   * \brief prepare the duplicate check for a search over two lists
+   *
+   * Only beads which are contained in both lists can form the same pair
+   * twice, so only pairs among those need to be remembered.
+   */
+  void InitDuplicateCheck(BeadList &list1, BeadList &list2);
+  /// returns true if the pair was already found in this search
+  bool IsDuplicate(Bead *bead1, Bead *bead2);
+
+  std::unordered_set<Bead *> shared_beads_;
+  std::set<std::pair<Bead *, Bead *>> shared_pairs_;
+
  protected:
   /// Functor for match function to be able to set member and non-member
   /// functions
@@ -18,6 +18,12 @@
 #ifndef VOTCA_CSG_NBLIST_3BODY_H
 #define VOTCA_CSG_NBLIST_3BODY_H
 
+// Standard includes
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
 // Local VOTCA includes
 #include "beadlist.h"
 #include "beadtriple.h"
@@ -38,6 +44,9 @@ namespace csg {
  * get every pair listed once, the SetMatchFunction can be used and always
  * return that the pair is not stored.
  *
+ * Triples can also be streamed to a visitor with ForEachTriple, in which case
+ * no triple is stored at all.
+ *
  */
 class NBList_3Body : public TripleList<Bead *, BeadTriple> {
  public:
@@ -67,6 +76,24 @@ class NBList_3Body : public TripleList<Bead *, BeadTriple> {
   /// get the cutoff for the neighbour search
   double getCutoff() { return cutoff_; }
 
+  /**
+   * \brief stream all triples to a visitor instead of storing them
+   *
+   * The visitor is called as visitor(bead1, bead2, bead3, r12, r13, dist12,
+   * dist13) for every triple, bead1 being the central bead from list1. Like
+   * for Generate, the lists for bead2 and bead3 should be the same object if
+   * they contain the same bead type, and triples which only differ by
+   * exchanging bead2 and bead3 are visited once. Neither BeadTriples are
+   * created nor is the match function called.
+   */
+  template <typename Visitor>
+  void ForEachTriple(BeadList &list1, BeadList &list2, BeadList &list3,
+                     Visitor &&visitor, bool do_exclusions = true);
+
+  /// distribute the central beads of ForEachTriple over OpenMP threads, the
+  /// visitor has to be thread safe then
+  void setParallel(bool parallel) { parallel_ = parallel; }
+
   /**
    *  \brief match function for class member functions
    *
@@ -111,6 +138,69 @@ class NBList_3Body : public TripleList<Bead *, BeadTriple> {
   double cutoff_;
   /// take into account exclusions from topolgoy
   bool do_exclusions_;
+  /// search triples of different central beads in parallel
+  bool parallel_ = false;
+
+  /// bead within the cutoff of a central bead
+  struct Neighbour {
+    Bead *bead;
+    Eigen::Vector3d r;
+    double dist;
+  };
+
+  /// interface to pass visitors of ForEachTriple to the search
+  class TripleVisitor {
+   public:
+    TripleVisitor() = default;
+    virtual void operator()(Bead *, Bead *, Bead *, const Eigen::Vector3d &,
+                            const Eigen::Vector3d &, const double dist12,
+                            const double dist13) = 0;
+    virtual ~TripleVisitor() = default;
+  };
+
+  template <typename Visitor>
+  class TripleVisitorWrapper : public TripleVisitor {
+   public:
+    TripleVisitorWrapper(Visitor &visitor) : visitor_(visitor) {}
+
+    void operator()(Bead *b1, Bead *b2, Bead *b3, const Eigen::Vector3d &r12,
+                    const Eigen::Vector3d &r13, const double dist12,
+                    const double dist13) override {
+      visitor_(b1, b2, b3, r12, r13, dist12, dist13);
+    }
+
+   private:
+    Visitor &visitor_;
+  };
+
+  /// checks the lists and calls SearchTriples
+  void VisitTriples(BeadList &list1, BeadList &list2, BeadList &list3,
+                    TripleVisitor &visitor, bool parallel);
+
+  /// find all triples around the beads of list1 and pass them to the visitor
+  virtual void SearchTriples(const Topology &top, BeadList &list1,
+                             BeadList &list2, BeadList &list3,
+                             TripleVisitor &visitor, bool parallel);
+
+  /// append all beads of candidates within the cutoff of bead to neighbours
+  void AddNeighbours(const Topology &top, Bead *bead,
+                     const std::vector<Bead *> &candidates,
+                     std::vector<Neighbour> &neighbours) const;
+
+  /// pass all triples of the central bead and its neighbours to the visitor
+  void VisitNeighbours(const Topology &top, Bead *bead,
+                       const std::vector<Neighbour> &neighbours2,
+                       const std::vector<Neighbour> &neighbours3,
+                       TripleVisitor &visitor) const;
+
+  /// true if bead2 and bead3 can also appear the other way round and this is
+  /// not the order in which they are visited
+  bool IsSwappedPair(Bead *bead2, Bead *bead3) const;
+
+  /// beads which are both in list2 and list3
+  std::unordered_set<Bead *> shared_beads_;
+  /// list2 and list3 are the same list
+  bool same_lists23_ = false;
 
   /// policy function to create new bead types
   template <typename triple_type>
@@ -187,6 +277,15 @@ class NBList_3Body : public TripleList<Bead *, BeadTriple> {
   std::unique_ptr<Functor> match_function_;
 };
 
+template <typename Visitor>
+inline void NBList_3Body::ForEachTriple(BeadList &list1, BeadList &list2,
+                                        BeadList &list3, Visitor &&visitor,
+                                        bool do_exclusions) {
+  do_exclusions_ = do_exclusions;
+  TripleVisitorWrapper<std::remove_reference_t<Visitor>> wrapper(visitor);
+  VisitTriples(list1, list2, list3, wrapper, parallel_);
+}
+
 template <typename triple_type>
 void NBList_3Body::setTripleType() {
   triple_creator_ = NBList_3Body::beadtriple_create_policy<triple_type>;
@@ -19,6 +19,8 @@
 #define VOTCA_CSG_NBLISTGRID_H
 
 // Standard includes
+#include <array>
+#include <utility>
 #include <vector>
 
 // VOTCA includes
@@ -26,36 +28,124 @@
 
 // Local VOTCA includes
 #include "nblist.h"
-#include "votca/tools/NDimVector.h"
 
 namespace votca {
 namespace csg {
 
+/**
+ * \brief Neighbour list based on a cell grid
+ *
+ * The box is divided in cells which are at least as large as the cutoff.
+ * Beads are sorted into the cells in linear time and every pair of
+ * neighbouring cells is only visited once (half shell), so no pair can be
+ * found twice. If the grid has at least three cells in every direction the
+ * periodic image of a neighbouring cell is determined once per cell pair
+ * instead of once per bead pair.
+ *
+ * The search over the cells is parallelized with OpenMP. Candidates are
+ * collected per block of cells and then handed to the match function in
+ * cell order, so the match function is never called concurrently.
+ *
+ * Optionally the list can be kept as a Verlet list over several frames. If a
+ * skin is set, the search is done with cutoff + skin and the candidate pairs
+ * are stored. Following calls of Generate with the same beads and box only
+ * recompute the distances of the stored pairs, as long as no bead moved more
+ * than half the skin since the last full search. In this mode Generate
+ * replaces the pairs of the previous call instead of appending to them.
+ */
 class NBListGrid : public NBList {
  public:
   void Generate(BeadList &list1, BeadList &list2,
                 bool do_exclusions = true) override;
   void Generate(BeadList &list, bool do_exclusions = true) override;
 
+  /// set the Verlet skin, 0 (default) disables reusing the list
+  void setSkin(double skin) {
+    skin_ = skin;
+    verlet_valid_ = false;
+  }
+  /// get the Verlet skin
+  double getSkin() const { return skin_; }
+  /// number of full grid searches done so far
+  Index getRebuildCount() const { return rebuilds_; }
+
  protected:
-  struct cell_t {
-    BeadList beads_;
-    std::vector<cell_t *> neighbours_;
+  /// neighbouring cell and the periodic shift to apply to its beads
+  struct stencil_t {
+    Index cell_;
+    Eigen::Vector3d shift_;
+  };
+
+  /// a pair within the cutoff, before the match function was applied
+  struct candidate_t {
+    Index first_;
+    Index second_;
+    Eigen::Vector3d r_;
+    double dist_;
   };
 
   Eigen::Vector3d box_a_, box_b_, box_c_;
   Eigen::Vector3d norm_a_, norm_b_, norm_c_;
   Index box_Na_, box_Nb_, box_Nc_;
+  /// true if the periodic shift can be taken from the stencil
+  bool shift_per_cell_;
+
+  /// cell offsets to search, only the half shell if shift_per_cell_ is set
+  std::vector<std::array<Index, 3>> offsets_;
+
+  /// beads sorted by cell, beads of cell c are in
+  /// [cell_start_[c], cell_start_[c+1])
+  std::vector<Index> cell_start_;
+  std::vector<Index> cell_beads_;
 
-  tools::NDimVector<cell_t, 3> grid_;
+  /// all beads of the search, positions wrapped into the box
+  std::vector<Bead *> beads_;
+  std::vector<Eigen::Vector3d> pos_;
+  /// membership of the beads in the first and second list
+  std::vector<char> in_list1_;
+  std::vector<char> in_list2_;
+
+  /// Verlet skin, the stored pairs are valid up to cutoff_ + skin_
+  double skin_ = 0.0;
+  Index rebuilds_ = 0;
+  /// state of the last full search in Verlet mode
+  bool verlet_valid_ = false;
+  bool verlet_exclusions_ = false;
+  double verlet_cutoff_ = 0.0;
+  Eigen::Matrix3d verlet_box_;
+  std::vector<Bead *> verlet_beads_;
+  std::vector<char> verlet_in_list1_;
+  std::vector<char> verlet_in_list2_;
+  std::vector<Eigen::Vector3d> verlet_pos_;
+  std::vector<std::pair<Index, Index>> verlet_pairs_;
 
   void InitializeGrid(const Eigen::Matrix3d &box);
 
-  cell_t &getCell(const Eigen::Vector3d &r);
-  cell_t &getCell(const Index &a, const Index &b, const Index &c);
+  /// reuse the stored pairs or do a full search for the beads in beads_
+  void Update(const Topology &top);
+  /// true if the stored pairs still contain all pairs within the cutoff
+  bool VerletListValid(const Topology &top) const;
+  /// recompute the stored pairs for the current positions
+  void ReuseVerletList(const Topology &top);
+  /// hand the candidates to the match function in order
+  void CreatePairs(const std::vector<std::vector<candidate_t>> &found);
+
+  /// cell index of position r, r is wrapped into the box
+  Index getCell(Eigen::Vector3d &r) const;
+  Index getCell(Index a, Index b, Index c) const {
+    return a + box_Na_ * (b + box_Nb_ * c);
+  }
 
-  void TestBead(const Topology &top, cell_t &cell, Bead *bead);
-  void TestCell(const Topology &top, cell_t &cell, Bead *bead);
+  /// sort the beads into the cells and run the search
+  void Search(const Topology &top);
+  /// test all pairs of beads between cell and one stencil entry
+  void TestCells(const Topology &top, Index cell, const stencil_t &neighbour,
+                 double cutoff2, std::vector<candidate_t> &found) const;
+  /// test a single pair against the search cutoff, first must have the
+  /// smaller index
+  void TestPair(const Topology &top, Index i, Index j,
+                const Eigen::Vector3d &r, double cutoff2,
+                std::vector<candidate_t> &found) const;
 };
 
 }  // namespace csg
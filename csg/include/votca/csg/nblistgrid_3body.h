@@ -27,19 +27,18 @@
 namespace votca {
 namespace csg {
 
+/**
+ * \brief Neighbour list class for 3 body interactions using a cell list
+ *
+ * Only beads in the cell of the central bead and its neighbouring cells are
+ * tested, the triple search and its streaming are the same as in
+ * NBList_3Body.
+ */
 class NBListGrid_3Body : public NBList_3Body {
- public:
-  void Generate(BeadList &list1, BeadList &list2, BeadList &list3,
-                bool do_exclusions = true) override;
-  void Generate(BeadList &list1, BeadList &list2,
-                bool do_exclusions = true) override;
-  void Generate(BeadList &list, bool do_exclusions = true) override;
-
  protected:
   struct cell_t {
-    BeadList beads1_;
-    BeadList beads2_;
-    BeadList beads3_;
+    std::vector<Bead *> beads2_;
+    std::vector<Bead *> beads3_;
     std::vector<cell_t *> neighbours_;
   };
 
@@ -49,12 +48,14 @@ class NBListGrid_3Body : public NBList_3Body {
 
   std::vector<cell_t> grid_;
 
+  void SearchTriples(const Topology &top, BeadList &list1, BeadList &list2,
+                     BeadList &list3, TripleVisitor &visitor,
+                     bool parallel) override;
+
   void InitializeGrid(const Eigen::Matrix3d &box);
 
   cell_t &getCell(const Eigen::Vector3d &r);
   cell_t &getCell(const Index &a, const Index &b, const Index &c);
-
-  void TestBead(const Topology &top, cell_t &cell, Bead *bead);
 };
 
 inline NBListGrid_3Body::cell_t &NBListGrid_3Body::getCell(const Index &a,
@@ -19,7 +19,11 @@
 #define VOTCA_CSG_PAIRLIST_H
 
 // Standard includes
+#include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 // VOTCA includes
@@ -28,6 +32,18 @@
 namespace votca {
 namespace csg {
 
+/**
+ * \brief List of pairs of elements
+ *
+ * Pairs are either handed over via AddPair or constructed in place via
+ * EmplacePair. The latter stores them in large contiguous blocks which are
+ * kept for reuse after Cleanup, so rebuilding a list does not allocate every
+ * single pair.
+ *
+ * The partner index used by FindPair and FindPartners is only built when one
+ * of them is actually called and is stored in compressed sparse row format:
+ * for each element a sorted range of (partner, pair) entries.
+ */
 template <typename element_type, typename pair_type>
 class PairList {
  public:
@@ -37,6 +53,10 @@ class PairList {
   // this method takes ownership of p
   void AddPair(pair_type *p);
 
+  /// construct a new pair in place and add it to the list
+  template <typename... Args>
+  pair_type *EmplacePair(Args &&...args);
+
   using iterator = typename std::vector<pair_type *>::iterator;
   using const_iterator = typename std::vector<pair_type *>::const_iterator;
   typedef typename std::map<element_type, pair_type *> partners;
@@ -66,7 +86,25 @@ class PairList {
  protected:
   std::vector<pair_type *> pairs_;
 
-  std::map<element_type, std::map<element_type, pair_type *>> pair_map_;
+ private:
+  using entry_t = std::pair<element_type, pair_type *>;
+
+  void BuildIndex() const;
+  pair_type *LookupPair(element_type e1, element_type e2) const;
+
+  // pairs created by EmplacePair, a block is never grown beyond its capacity
+  // so the addresses stay valid
+  std::vector<std::vector<pair_type>> pool_;
+  Index pool_block_ = 0;
+  // pairs handed over via AddPair
+  std::vector<std::unique_ptr<pair_type>> owned_;
+
+  // partner index, rebuilt on demand after the list was changed
+  mutable bool index_valid_ = false;
+  mutable std::vector<element_type> index_elements_;
+  mutable std::vector<Index> index_offsets_;
+  mutable std::vector<entry_t> index_entries_;
+  mutable std::map<element_type, partners> partners_cache_;
 };
 
 // this method takes ownership of p
@@ -74,68 +112,157 @@ template <typename element_type, typename pair_type>
 inline void PairList<element_type, pair_type>::AddPair(pair_type *p) {
   /// \todo be careful, same pair object is used, some values might change (e.g.
   /// sign of distance vector)
-  pair_map_[p->first()][p->second()] = p;
-  pair_map_[p->second()][p->first()] = p;
+  owned_.emplace_back(p);
   /// \todo check if unique
   pairs_.push_back(p);
+  index_valid_ = false;
+}
+
+template <typename element_type, typename pair_type>
+template <typename... Args>
+inline pair_type *PairList<element_type, pair_type>::EmplacePair(
+    Args &&...args) {
+  constexpr Index first_block_size = 1024;
+  if (pool_.empty() ||
+      pool_[pool_block_].size() == pool_[pool_block_].capacity()) {
+    if (!pool_.empty() && pool_block_ + 1 < Index(pool_.size())) {
+      ++pool_block_;
+    } else {
+      Index block_size =
+          pool_.empty() ? first_block_size : 2 * Index(pool_.back().capacity());
+      pool_.emplace_back();
+      pool_.back().reserve(block_size);
+      pool_block_ = Index(pool_.size()) - 1;
+    }
+  }
+  std::vector<pair_type> &block = pool_[pool_block_];
+  block.emplace_back(std::forward<Args>(args)...);
+  pair_type *p = &block.back();
+  pairs_.push_back(p);
+  index_valid_ = false;
+  return p;
 }
 
 template <typename element_type, typename pair_type>
 inline void PairList<element_type, pair_type>::Cleanup() {
-  for (auto &pair : pairs_) {
-    delete pair;
+  owned_.clear();
+  // keep the allocated blocks for the next fill
+  for (auto &block : pool_) {
+    block.clear();
   }
+  pool_block_ = 0;
   pairs_.clear();
-  pair_map_.clear();
+  index_valid_ = false;
+  index_elements_.clear();
+  index_offsets_.clear();
+  index_entries_.clear();
+  partners_cache_.clear();
 }
 
 template <typename element_type, typename pair_type>
-inline pair_type *PairList<element_type, pair_type>::FindPair(element_type e1,
-                                                              element_type e2) {
-  typename std::map<element_type, std::map<element_type, pair_type *>>::iterator
-      iter1;
-  iter1 = pair_map_.find(e1);
-  if (iter1 == pair_map_.end()) {
-    return nullptr;
+void PairList<element_type, pair_type>::BuildIndex() const {
+  std::less<element_type> less;
+  // every pair is listed for both of its elements
+  std::vector<std::pair<element_type, entry_t>> entries;
+  entries.reserve(2 * pairs_.size());
+  for (pair_type *p : pairs_) {
+    entries.emplace_back(p->first(), entry_t(p->second(), p));
+    entries.emplace_back(p->second(), entry_t(p->first(), p));
   }
+  // stable, so for pairs added twice the latest one wins as before
+  std::stable_sort(entries.begin(), entries.end(),
+                   [&less](const auto &a, const auto &b) {
+                     if (less(a.first, b.first)) {
+                       return true;
+                     }
+                     if (less(b.first, a.first)) {
+                       return false;
+                     }
+                     return less(a.second.first, b.second.first);
+                   });
 
-  typename partners::iterator iter2;
-  iter2 = iter1->second.find(e2);
-  if (iter2 == iter1->second.end()) {
-    return nullptr;
+  index_elements_.clear();
+  index_offsets_.clear();
+  index_entries_.clear();
+  index_entries_.reserve(entries.size());
+  for (const auto &entry : entries) {
+    bool new_row = index_elements_.empty() ||
+                   less(index_elements_.back(), entry.first);
+    if (new_row) {
+      index_elements_.push_back(entry.first);
+      index_offsets_.push_back(Index(index_entries_.size()));
+    } else if (!less(index_entries_.back().first, entry.second.first)) {
+      // same partner again, replace the previous entry
+      index_entries_.back() = entry.second;
+      continue;
+    }
+    index_entries_.push_back(entry.second);
   }
-
-  return iter2->second;
+  index_offsets_.push_back(Index(index_entries_.size()));
+  partners_cache_.clear();
+  index_valid_ = true;
 }
 
 template <typename element_type, typename pair_type>
-inline const pair_type *PairList<element_type, pair_type>::FindPair(
+inline pair_type *PairList<element_type, pair_type>::LookupPair(
     element_type e1, element_type e2) const {
-  typename std::map<element_type,
-                    std::map<element_type, pair_type *>>::const_iterator iter1;
-  iter1 = pair_map_.find(e1);
-  if (iter1 == pair_map_.end()) {
+  if (!index_valid_) {
+    BuildIndex();
+  }
+  std::less<element_type> less;
+  auto row = std::lower_bound(index_elements_.begin(), index_elements_.end(),
+                              e1, less);
+  if (row == index_elements_.end() || less(e1, *row)) {
     return nullptr;
   }
-
-  typename partners::const_iterator iter2;
-  iter2 = iter1->second.find(e2);
-  if (iter2 == iter1->second.end()) {
+  Index r = Index(row - index_elements_.begin());
+  auto first = index_entries_.begin() + index_offsets_[r];
+  auto last = index_entries_.begin() + index_offsets_[r + 1];
+  auto entry = std::lower_bound(
+      first, last, e2,
+      [&less](const entry_t &a, const element_type &e) {
+        return less(a.first, e);
+      });
+  if (entry == last || less(e2, entry->first)) {
     return nullptr;
   }
+  return entry->second;
+}
+
+template <typename element_type, typename pair_type>
+inline pair_type *PairList<element_type, pair_type>::FindPair(element_type e1,
+                                                              element_type e2) {
+  return LookupPair(e1, e2);
+}
 
-  return iter2->second;
+template <typename element_type, typename pair_type>
+inline const pair_type *PairList<element_type, pair_type>::FindPair(
+    element_type e1, element_type e2) const {
+  return LookupPair(e1, e2);
 }
 
 template <typename element_type, typename pair_type>
 typename PairList<element_type, pair_type>::partners *
     PairList<element_type, pair_type>::FindPartners(element_type e1) {
-  typename std::map<element_type, std::map<element_type, pair_type *>>::iterator
-      iter;
-  if ((iter = pair_map_.find(e1)) == pair_map_.end()) {
+  if (!index_valid_) {
+    BuildIndex();
+  }
+  auto cached = partners_cache_.find(e1);
+  if (cached != partners_cache_.end()) {
+    return &(cached->second);
+  }
+  std::less<element_type> less;
+  auto row = std::lower_bound(index_elements_.begin(), index_elements_.end(),
+                              e1, less);
+  if (row == index_elements_.end() || less(e1, *row)) {
     return nullptr;
   }
-  return &(iter->second);
+  Index r = Index(row - index_elements_.begin());
+  partners &p = partners_cache_[e1];
+  for (Index i = index_offsets_[r]; i < index_offsets_[r + 1]; ++i) {
+    p.emplace_hint(p.end(), index_entries_[i]);
+  }
+  return &p;
 }
 
 }  // namespace csg
@@ -52,6 +52,12 @@ class PotentialFunction {
   virtual double CalculateDF(Index i, double r) const = 0;
   // calculate second derivative w.r.t. ith parameter
   virtual double CalculateD2F(Index i, Index j, double r) const = 0;
+  // calculate the weighted sums of the function and of its first and second
+  // derivatives w.r.t. the parameters to be optimized over all distances r
+  virtual void CalculateDerivatives(const Eigen::VectorXd &r,
+                                    const Eigen::VectorXd &weight, double &U,
+                                    Eigen::VectorXd &dU,
+                                    Eigen::MatrixXd &d2U) const;
   // return parameter
   Eigen::VectorXd &Params() { return lam_; }
   // return ith parameter
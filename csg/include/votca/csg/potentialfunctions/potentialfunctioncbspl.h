@@ -37,6 +37,11 @@ class PotentialFunctionCBSPL : public PotentialFunction {
   // calculate second derivative w.r.t. ith parameter
   double CalculateD2F(const Index i, const Index j,
                       const double r) const override;
+  // bins the distances by knot interval, see PotentialFunction
+  void CalculateDerivatives(const Eigen::VectorXd &r,
+                            const Eigen::VectorXd &weight, double &U,
+                            Eigen::VectorXd &dU,
+                            Eigen::MatrixXd &d2U) const override;
 
   Index getOptParamSize() const override;
 
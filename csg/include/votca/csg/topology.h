@@ -34,6 +34,7 @@
 
 // Local VOTCA includes
 #include "bead.h"
+#include "beadcoordinates.h"
 #include "boundarycondition.h"
 #include "exclusionlist.h"
 #include "molecule.h"
@@ -226,6 +227,16 @@ class Topology {
    **/
   Bead *getBead(const Index i) { return &beads_[i]; }
   const Bead *getBead(const Index i) const { return &beads_[i]; }
+
+  /**
+   * \brief positions, velocities and forces of all the beads
+   *
+   * The arrays are indexed by the bead id and are the storage behind
+   * Bead::getPos, Bead::getVel and Bead::getF, which only return a valid
+   * value if the bead flags them as set.
+   */
+  BeadCoordinates &getBeadCoordinates() { return coordinates_; }
+  const BeadCoordinates &getBeadCoordinates() const { return coordinates_; }
   Residue &getResidue(const Index i) { return residues_[i]; }
   const Residue &getResidue(const Index i) const { return residues_[i]; }
   Molecule *getMolecule(const Index i) { return &molecules_[i]; }
@@ -242,6 +253,26 @@ class Topology {
    */
   void CopyTopologyData(Topology *top);
 
+  /**
+   * \brief copy the complete topology of a different topology
+   * \param top topology to copy from
+   *
+   * Beads, residues, molecules, exclusions and the box are copied. The bonded
+   * interactions only depend on bead ids and are shared with top instead of
+   * being copied, they stay valid as long as one of the topologies exists.
+   * This is used to set up worker topologies without reading the topology
+   * file again.
+   */
+  void ShareTopologyData(const Topology &top);
+
+  /**
+   * \brief copy the frame data (box, time, step and the positions,
+   * velocities, forces and orientations of the beads) of a topology with the
+   * same beads
+   * \param top topology to copy from
+   */
+  void CopyFrameData(const Topology &top);
+
   /**
    *  \brief rename all the molecules in range
    * \param range range string of type 1:2:10 = 1, 3, 5, 7, ...
@@ -264,6 +295,20 @@ class Topology {
    */
   void SetBeadTypeMass(std::string name, double value);
 
+  /**
+   * \brief ids of all the beads matching a selection
+   * \param select wildcard pattern for the bead type, or for the bead name if
+   * prefixed by "name:"
+   *
+   * The result is kept for each selection string until beads are created,
+   * removed or renamed by the topology. Beads renamed directly have to be
+   * followed by a call of ClearBeadSelections.
+   */
+  const std::vector<Index> &SelectBeads(const std::string &select);
+
+  /// \brief forget all the bead selections made by SelectBeads
+  void ClearBeadSelections() { bead_selections_.clear(); }
+
   /**
    * set the simulation box
    * \param box triclinic box matrix
@@ -412,6 +457,8 @@ class Topology {
 
   /// beads in the topology
   BeadContainer beads_;
+  /// coordinates of the beads
+  BeadCoordinates coordinates_;
 
   /// molecules in the topology
   MoleculeContainer molecules_;
@@ -421,9 +468,14 @@ class Topology {
 
   /// bonded interactions in the topology
   InteractionContainer interactions_;
+  /// owners of the bonded interactions, might be shared with other topologies
+  std::vector<std::shared_ptr<Interaction>> interaction_owners_;
 
   ExclusionList exclusions_;
 
+  /// cached results of SelectBeads
+  std::unordered_map<std::string, std::vector<Index>> bead_selections_;
+
   std::map<std::string, Index> interaction_groups_;
 
   std::map<std::string, std::vector<Interaction *>> interactions_by_group_;
@@ -441,7 +493,10 @@ inline Bead *Topology::CreateBead(Bead::Symmetry symmetry, std::string name,
                                   std::string type, Index resnr, double m,
                                   double q) {
 
-  beads_.push_back(Bead(beads_.size(), type, symmetry, name, resnr, m, q));
+  ClearBeadSelections();
+  coordinates_.push_back();
+  beads_.push_back(
+      Bead(beads_.size(), type, symmetry, name, resnr, m, q, &coordinates_));
   return &beads_.back();
 }
 
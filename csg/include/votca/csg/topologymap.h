@@ -22,7 +22,11 @@
 #include <memory>
 #include <vector>
 
+// VOTCA includes
+#include <votca/tools/eigen.h>
+
 // Local VOTCA includes
+#include "boundarycondition.h"
 #include "map.h"
 #include "topology.h"
 
@@ -35,14 +39,51 @@ class TopologyMap {
 
   void AddMoleculeMap(Map map);
 
+  /**
+   * \brief collect the weights of all bead maps
+   *
+   * Called after the last molecule map was added, otherwise by the first
+   * Apply.
+   */
+  void Initialize();
+
+  /**
+   * \brief map the current frame
+   *
+   * The molecules are mapped in parallel with OpenMP if there are enough of
+   * them and parallel mapping was not switched off.
+   */
   void Apply();
 
+  /// switch off parallel mapping, e.g. if the caller runs in several threads
+  void setParallel(bool parallel) { parallel_ = parallel; }
+
  private:
   const Topology *in_;
   Topology *out_;
+  bool parallel_ = true;
+  bool initialized_ = false;
 
   using MapContainer = std::vector<Map>;
   MapContainer maps_;
+
+  // the linear part of all bead maps in compressed sparse row format, one row
+  // per coarse-grained bead. The entries of a row are the input bead ids with
+  // their weights, the first entry is the reference for the unwrapping.
+  std::vector<Index> row_start_;
+  std::vector<Index> atom_index_;
+  std::vector<double> weight_;
+  std::vector<double> force_weight_;
+  /// id of the coarse-grained bead of each row
+  std::vector<Index> cg_index_;
+  /// first row of each molecule map
+  std::vector<Index> molecule_start_;
+  /// largest number of entries of a molecule
+  Index max_molecule_entries_ = 0;
+
+  void MapMolecule(Index mol, const BoundaryCondition &bc,
+                   Eigen::Matrix3Xd &ref, Eigen::Matrix3Xd &pos,
+                   Eigen::Matrix3Xd &unwrapped, Eigen::VectorXd &dist2);
 };
 
 inline TopologyMap::TopologyMap(const Topology *in, Topology *out)
@@ -50,6 +91,7 @@ inline TopologyMap::TopologyMap(const Topology *in, Topology *out)
 
 inline void TopologyMap::AddMoleculeMap(Map map) {
   maps_.push_back(std::move(map));
+  initialized_ = false;
 }
 
 }  // namespace csg
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_TRAJECTORYREADAHEAD_H
+#define VOTCA_CSG_TRAJECTORYREADAHEAD_H
+
+// Standard includes
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// VOTCA includes
+#include <votca/tools/thread.h>
+
+// Local VOTCA includes
+#include "topology.h"
+#include "trajectoryreader.h"
+
+namespace votca {
+namespace csg {
+
+/**
+ * \brief Reads the frames of a trajectory in a separate thread
+ *
+ * The frames are read into a fixed number of frame buffers, each being a copy
+ * of the topology. Consumers take the filled buffers in the order the frames
+ * were read, copy the frame into their own topology and give the buffer back,
+ * so parsing the next frames overlaps with the analysis of the current ones.
+ *
+ * Errors of the trajectory reader are passed on to the consumer in Acquire.
+ */
+class TrajectoryReadAhead : public tools::Thread {
+ public:
+  /**
+   * \param reader opened trajectory reader, positioned before the next frame
+   * \param top topology the frames are read into
+   * \param nbuffers maximum number of frames read ahead
+   * \param nframes number of frames to read, all frames if negative
+   */
+  TrajectoryReadAhead(TrajectoryReader &reader, const Topology &top,
+                      Index nbuffers, Index nframes = -1);
+
+  /// \brief get the next frame in order, nullptr if there are no frames left
+  Topology *Acquire();
+  /// \brief give back a frame obtained from Acquire
+  void Release(Topology *frame);
+  /// \brief stop reading, frames which were not acquired are dropped
+  void Stop();
+
+ protected:
+  void Run() override;
+
+ private:
+  TrajectoryReader &reader_;
+  Index nframes_;
+
+  std::vector<std::unique_ptr<Topology>> buffers_;
+  /// buffers which can be filled
+  std::deque<Topology *> free_;
+  /// filled buffers in the order of the frames
+  std::deque<Topology *> ready_;
+  /// no more frames will be read
+  bool done_ = false;
+  bool stop_ = false;
+  std::exception_ptr error_;
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_TRAJECTORYREADAHEAD_H
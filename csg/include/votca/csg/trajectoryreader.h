@@ -46,6 +46,22 @@ class TrajectoryReader {
   /// read in the next frame
   virtual bool NextFrame(Topology &top) = 0;
 
+  /**
+   * \brief read in the frame nframes frames ahead, the same as calling
+   * NextFrame nframes times
+   *
+   * Readers which can jump to a frame overload this to not parse the frames
+   * in between.
+   */
+  virtual bool AdvanceFrames(Topology &top, Index nframes) {
+    for (Index i = 0; i < nframes; ++i) {
+      if (!NextFrame(top)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   static void RegisterPlugins(void);
 };
 
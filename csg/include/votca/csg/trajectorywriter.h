@@ -40,6 +40,11 @@ class TrajectoryWriter {
 
   virtual void Write(Topology *) {}
 
+  /// store coordinates in single precision, ignored by most formats
+  virtual void setSinglePrecision(bool) {}
+  /// level of lossless compression, ignored by most formats
+  virtual void setCompressionLevel(Index) {}
+
   static void RegisterPlugins(void);
 };
 
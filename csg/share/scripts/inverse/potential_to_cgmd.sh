@@ -0,0 +1,106 @@
+#! /bin/bash
+#
+# Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+show_help () {
+  cat <<EOF
+${0##*/}, version %version%
+This script converts a potential to the table read by the built-in
+coarse-grained simulation (cgmd), i.e. a table on a regular grid, which is
+extrapolated into the core region and shifted to zero at the cutoff
+
+Usage: ${0##*/} [options] input output
+
+Allowed options:
+    --help       show this help
+    --clean      remove all intermediate temp files
+    --no-shift   do not shift the potential
+EOF
+}
+
+clean=
+do_shift="yes"
+
+### begin parsing options
+shopt -s extglob
+while [[ ${1#-} != $1 ]]; do
+ if [[ ${1#--} = $1 && -n ${1:2} ]]; then
+    #short opt with arguments here: o
+    if [[ ${1#-[o]} != ${1} ]]; then
+       set -- "${1:0:2}" "${1:2}" "${@:2}"
+    else
+       set -- "${1:0:2}" "-${1:2}" "${@:2}"
+    fi
+ fi
+ case $1 in
+   --clean)
+    clean="yes"
+    shift ;;
+   --no-shift)
+    do_shift="no"
+    shift ;;
+   -h | --help)
+    show_help
+    exit 0;;
+  *)
+   die "Unknown option '$1'";;
+ esac
+done
+### end parsing options
+
+[[ -z $1 || -z $2 ]] && die "${0##*/}: missing argument"
+input="$1"
+trunc=${1##*/}
+trunc="${trunc%%.*}"
+[[ -f $input ]] || die "${0##*/}: Could not find input file '$input'"
+output="$2"
+echo "Convert $input to $output"
+
+sim_prog="$(csg_get_property cg.inverse.program)"
+[[ ${sim_prog} = "cgmd" ]] || die "${0##*/}: cg.inverse.program was not set to 'cgmd', but '${sim_prog}' (mind the default)"
+
+bondtype="$(csg_get_interaction_property bondtype)"
+[[ $bondtype != non-bonded ]] && die "${0##*/}: cgmd only supports non-bonded interactions"
+
+r_min=$(csg_get_interaction_property min)
+r_cut=$(csg_get_interaction_property max)
+step=$(csg_get_interaction_property step)
+bin_size="$(csg_get_property cg.inverse.$sim_prog.table_bins)"
+
+comment="$(get_table_comment $input)"
+
+#keep the grid for now, so that extrapolate can calculate the right mean
+smooth="$(critical mktemp ${trunc}.pot.smooth.XXXXX)"
+critical csg_resample --in "${input}" --out "$smooth" --grid "${r_min}:${step}:${r_cut}"
+
+# the table is not valid in the core region, where g(r)=0
+extrapol="$(critical mktemp ${trunc}.pot.extrapol.XXXXX)"
+lfct="$(csg_get_interaction_property --allow-empty inverse.$sim_prog.table_left_extrapolation)"
+rfct="$(csg_get_interaction_property --allow-empty inverse.$sim_prog.table_right_extrapolation)"
+do_external potential extrapolate ${clean:+--clean} ${lfct:+--lfct ${lfct}} ${rfct:+--rfct ${rfct}} --type "$bondtype" "${smooth}" "${extrapol}"
+
+interpol="$(critical mktemp ${trunc}.pot.interpol.XXXXX)"
+critical csg_resample --in "${extrapol}" --out "$interpol" --grid "${r_min}:${bin_size}:${r_cut}" --comment "$comment"
+
+if [[ $do_shift = "yes" ]]; then
+  do_external potential shift --type "$bondtype" "${interpol}" "${output}"
+else
+  critical cp "${interpol}" "${output}"
+fi
+
+if [[ $clean ]]; then
+  rm -f "${smooth}" "${extrapol}" "${interpol}"
+fi
@@ -0,0 +1,65 @@
+#! /bin/bash
+#
+# Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+if [ "$1" = "--help" ]; then
+    cat <<EOF
+${0##*/}, version %version%
+This script prepares the built-in coarse-grained simulation (cgmd). No
+trajectory is written, the settings of the simulation are saved in the
+trajectory file and csg_stat runs the simulation while sampling the
+distributions.
+
+Usage: ${0##*/}
+EOF
+    exit 0
+fi
+
+sim_prog="$(csg_get_property cg.inverse.program)"
+traj="$(csg_get_property cg.inverse.$sim_prog.traj)"
+[[ ${traj##*.} = cgmd ]] || die "${0##*/}: trajectory '$traj' needs the extension .cgmd"
+conf="$(csg_get_property --allow-empty cg.inverse.$sim_prog.conf)"
+[[ -n $conf && ! -f $conf ]] && die "${0##*/}: initial configuration '$conf' not found"
+
+steps="$(csg_get_property cg.inverse.$sim_prog.steps)"
+if [[ ${CSG_MDRUN_STEPS} && ! ${CSG_DONT_OVERWRITE_MDRUN_STEPS} ]]; then
+  steps="${CSG_MDRUN_STEPS}"
+  msg --color blue --to-stderr "Replace steps of cgmd to be ${CSG_MDRUN_STEPS}"
+fi
+
+method="$(csg_get_property cg.inverse.method)"
+is_part "$method" "ibi imc" || die "${0##*/}: ${sim_prog} does not support method $method yet!"
+
+[[ -n $(csg_get_property --allow-empty cg.bonded.name) ]] && die "${0##*/}: ${sim_prog} does not support bonded interactions"
+
+{
+  echo "<cgmd>"
+  if [[ -n $conf ]]; then
+    echo "  <conf>${conf}</conf>"
+  fi
+  echo "  <steps>${steps}</steps>"
+  echo "  <output_steps>$(csg_get_property cg.inverse.$sim_prog.output_steps)</output_steps>"
+  echo "  <dt>$(csg_get_property cg.inverse.$sim_prog.dt)</dt>"
+  echo "  <kBT>$(csg_get_property cg.inverse.kBT)</kBT>"
+  echo "  <friction>$(csg_get_property cg.inverse.$sim_prog.friction)</friction>"
+  echo "  <seed>$(csg_get_property cg.inverse.$sim_prog.seed)</seed>"
+  echo "  <skin>$(csg_get_property cg.inverse.$sim_prog.skin)</skin>"
+  for_all -q non-bonded \
+    'echo "  <nonbonded><type1>$(csg_get_interaction_property type1)</type1><type2>$(csg_get_interaction_property type2)</type2><table>$(csg_get_interaction_property inverse.'"${sim_prog}"'.table)</table></nonbonded>"'
+  echo "</cgmd>"
+} > "${traj}" || die "${0##*/}: writing '${traj}' failed"
+
+simulation_finish
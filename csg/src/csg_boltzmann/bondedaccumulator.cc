@@ -0,0 +1,153 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// Local private VOTCA includes
+#include "bondedaccumulator.h"
+
+namespace votca {
+namespace csg {
+
+BondedAccumulator::BondedAccumulator(double resolution,
+                                     Index correlation_levels)
+    : resolution_(resolution), levels_(correlation_levels) {
+  if (resolution_ <= 0) {
+    throw std::runtime_error("resolution of the histograms has to be > 0");
+  }
+  shift_.assign(levels_ * points_, 0.0);
+  added_.assign(levels_, 0);
+  block_sum_.assign(levels_, 0.0);
+  block_count_.assign(levels_, 0);
+  correlation_.assign(levels_ * points_, 0.0);
+  ncorrelation_.assign(levels_ * points_, 0.0);
+}
+
+void BondedAccumulator::Add(double value) {
+  if (!std::isfinite(value)) {
+    throw std::runtime_error("bonded interaction has a non finite value");
+  }
+  ++count_;
+  double delta = value - mean_;
+  mean_ += delta / double(count_);
+  m2_ += delta * (value - mean_);
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+
+  // min_ and max_ already include value
+  while (std::floor(max_ / resolution_) - std::floor(min_ / resolution_) >=
+         double(max_bins_)) {
+    Coarsen();
+  }
+  Index bin = Index(std::floor(value / resolution_));
+  if (counts_.empty()) {
+    first_bin_ = bin;
+    counts_.push_back(0.0);
+  } else if (bin < first_bin_) {
+    counts_.insert(counts_.begin(), first_bin_ - bin, 0.0);
+    first_bin_ = bin;
+  } else if (bin >= first_bin_ + Index(counts_.size())) {
+    counts_.resize(bin - first_bin_ + 1, 0.0);
+  }
+  counts_[bin - first_bin_] += 1.0;
+
+  if (levels_ > 0) {
+    AddToLevel(0, value);
+  }
+}
+
+void BondedAccumulator::Coarsen() {
+  resolution_ *= 2;
+  if (counts_.empty()) {
+    return;
+  }
+  // floor division, the bin indices can be negative
+  auto half = [](Index bin) { return (bin >= 0) ? bin / 2 : (bin - 1) / 2; };
+  Index first_bin = half(first_bin_);
+  Index last_bin = half(first_bin_ + Index(counts_.size()) - 1);
+  std::vector<double> counts(last_bin - first_bin + 1, 0.0);
+  for (Index i = 0; i < Index(counts_.size()); ++i) {
+    counts[half(first_bin_ + i) - first_bin] += counts_[i];
+  }
+  counts_ = std::move(counts);
+  first_bin_ = first_bin;
+}
+
+void BondedAccumulator::AddToLevel(Index level, double value) {
+  if (level >= levels_) {
+    return;
+  }
+  Index base = level * points_;
+  Index pos = added_[level] % points_;
+  shift_[base + pos] = value;
+  ++added_[level];
+
+  // lags below points_/averaging_ are covered by the previous level
+  Index first_lag = (level == 0) ? 0 : points_ / averaging_;
+  Index last_lag = std::min(points_, added_[level]);
+  for (Index lag = first_lag; lag < last_lag; ++lag) {
+    double previous = shift_[base + (pos - lag + points_) % points_];
+    correlation_[base + lag] += value * previous;
+    ncorrelation_[base + lag] += 1.0;
+  }
+
+  block_sum_[level] += value;
+  ++block_count_[level];
+  if (block_count_[level] == averaging_) {
+    double block_mean = block_sum_[level] / double(averaging_);
+    block_sum_[level] = 0.0;
+    block_count_[level] = 0;
+    AddToLevel(level + 1, block_mean);
+  }
+}
+
+void BondedAccumulator::AppendBins(std::vector<double> &values,
+                                   std::vector<double> &weights) const {
+  for (Index i = 0; i < Index(counts_.size()); ++i) {
+    if (counts_[i] == 0.0) {
+      continue;
+    }
+    double center = (double(first_bin_ + i) + 0.5) * resolution_;
+    values.push_back(std::clamp(center, min_, max_));
+    weights.push_back(counts_[i]);
+  }
+}
+
+void BondedAccumulator::Autocorrelation(
+    std::vector<Index> &lags, std::vector<double> &correlation) const {
+  lags.clear();
+  correlation.clear();
+  Index scale = 1;
+  for (Index level = 0; level < levels_; ++level) {
+    Index first_lag = (level == 0) ? 0 : points_ / averaging_;
+    for (Index lag = first_lag; lag < points_; ++lag) {
+      Index i = level * points_ + lag;
+      if (ncorrelation_[i] > 0) {
+        lags.push_back(lag * scale);
+        correlation.push_back(correlation_[i] / ncorrelation_[i]);
+      }
+    }
+    scale *= averaging_;
+  }
+}
+
+}  // namespace csg
+}  // namespace votca
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_BONDEDACCUMULATOR_H
+#define VOTCA_CSG_BONDEDACCUMULATOR_H
+
+// Standard includes
+#include <limits>
+#include <vector>
+
+// VOTCA includes
+#include <votca/tools/types.h>
+
+namespace votca {
+namespace csg {
+
+/**
+ * \brief Online statistics of the values of one bonded interaction
+ *
+ * The values are not stored, instead every value updates
+ *
+ * * the running mean and variance (Welford's algorithm), minimum and maximum
+ * * a fine histogram, from which coarser histograms can be built later. It
+ *   starts with the given bin width and grows with the range of values.
+ *   Once it has more than max_bins_ bins, neighbouring bins are merged, so
+ *   the bin width follows the range of the values.
+ * * optionally a blocked (multiple tau) autocorrelation, which covers lags up
+ *   to points * 2^(levels-1) frames with points values per level
+ *
+ * The memory therefore does not depend on the number of frames.
+ */
+class BondedAccumulator {
+ public:
+  BondedAccumulator(double resolution, Index correlation_levels);
+
+  void Add(double value);
+
+  Index Count() const { return count_; }
+  double Mean() const { return mean_; }
+  /// sample variance, 0 for less than two values
+  double Variance() const {
+    return (count_ > 1) ? m2_ / double(count_ - 1) : 0.0;
+  }
+  double Min() const { return min_; }
+  double Max() const { return max_; }
+  /// current bin width of the fine histogram
+  double Resolution() const { return resolution_; }
+
+  /**
+   * \brief append the bins of the fine histogram
+   *
+   * The value of a bin is its center, clamped to the range of the values
+   * seen, and its weight the number of values in the bin.
+   */
+  void AppendBins(std::vector<double> &values,
+                  std::vector<double> &weights) const;
+
+  bool HasCorrelation() const { return levels_ > 0; }
+  /**
+   * \brief autocorrelation <x(t) x(t+lag)> of the values
+   *
+   * \param lags lags in frames, in increasing order
+   * \param correlation the correlation for each lag
+   */
+  void Autocorrelation(std::vector<Index> &lags,
+                       std::vector<double> &correlation) const;
+
+  /// largest number of bins of the fine histogram
+  static constexpr Index max_bins_ = 4096;
+  /// number of values per level of the blocked autocorrelation
+  static constexpr Index points_ = 16;
+  /// number of values averaged when passing to the next level
+  static constexpr Index averaging_ = 2;
+
+ private:
+  void AddToLevel(Index level, double value);
+  /// merge pairs of bins, doubling the bin width
+  void Coarsen();
+
+  Index count_ = 0;
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+  double min_ = std::numeric_limits<double>::max();
+  double max_ = std::numeric_limits<double>::lowest();
+
+  double resolution_;
+  /// index of the first bin of counts_, bin i covers
+  /// [i * resolution_, (i + 1) * resolution_)
+  Index first_bin_ = 0;
+  std::vector<double> counts_;
+
+  Index levels_;
+  /// last points_ values of each level, used as ring buffer
+  std::vector<double> shift_;
+  /// number of values which were added to each level
+  std::vector<Index> added_;
+  /// sum and number of the values waiting for the next level
+  std::vector<double> block_sum_;
+  std::vector<Index> block_count_;
+  std::vector<double> correlation_;
+  std::vector<double> ncorrelation_;
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_BONDEDACCUMULATOR_H
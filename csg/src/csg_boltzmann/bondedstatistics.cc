@@ -16,30 +16,119 @@
  */
 
 #include "bondedstatistics.h"
+#include <algorithm>
+#include <stdexcept>
+#include <votca/tools/tokenizer.h>
 
 using namespace votca::tools;
 
 namespace votca {
 namespace csg {
 
+void BondedStatistics::setStreaming(double resolution,
+                                    Index correlation_levels,
+                                    const std::string &store_file) {
+  streaming_ = true;
+  resolution_ = resolution;
+  correlation_levels_ = correlation_levels;
+  store_file_ = store_file;
+}
+
 void BondedStatistics::BeginCG(Topology *top, Topology *) {
   bonded_values_.clear();
+  names_.clear();
+  accumulators_.clear();
   for (auto &interaction : top->BondedInteractions()) {
-    bonded_values_.CreateArray(interaction->getName());
+    names_.push_back(interaction->getName());
+    if (streaming_) {
+      accumulators_.emplace_back(resolution_, correlation_levels_);
+    } else {
+      bonded_values_.CreateArray(interaction->getName());
+    }
+  }
+  if (streaming_ && !store_file_.empty()) {
+    store_.Open(store_file_, Index(names_.size()));
   }
 }
 
 void BondedStatistics::EndCG() {}
 
+void BondedStatistics::EvaluateFrame(Topology &conf,
+                                     std::vector<double> &values) {
+  InteractionContainer &ic = conf.BondedInteractions();
+  values.resize(ic.size());
+  for (size_t i = 0; i < ic.size(); ++i) {
+    values[i] = ic[i]->EvaluateVar(conf);
+  }
+}
+
 void BondedStatistics::EvalConfiguration(Topology *conf, Topology *) {
-  InteractionContainer &ic = conf->BondedInteractions();
-  InteractionContainer::iterator ia;
+  EvaluateFrame(*conf, frame_values_);
+  AddFrame(frame_values_);
+}
 
-  DataCollection<double>::iterator is;
-  for (ia = ic.begin(), is = bonded_values_.begin(); ia != ic.end();
-       ++ia, ++is) {
-    (*is)->push_back((*ia)->EvaluateVar(*conf));
+void BondedStatistics::AddFrame(const std::vector<double> &values) {
+  if (values.size() != names_.size()) {
+    throw std::runtime_error(
+        "number of bonded interactions changed between frames");
+  }
+  if (!streaming_) {
+    DataCollection<double>::iterator is = bonded_values_.begin();
+    for (double value : values) {
+      (*is)->push_back(value);
+      ++is;
+    }
+    return;
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    accumulators_[i].Add(values[i]);
+  }
+  if (store_.IsOpen()) {
+    store_.Append(values);
+  }
+}
+
+std::vector<Index> BondedStatistics::Select(const std::string &pattern) const {
+  std::vector<Index> selected;
+  for (Index i = 0; i < Index(names_.size()); ++i) {
+    if (wildcmp(pattern, names_[i])) {
+      selected.push_back(i);
+    }
+  }
+  std::sort(selected.begin(), selected.end(),
+            [this](Index a, Index b) { return names_[a] < names_[b]; });
+  return selected;
+}
+
+DataCollection<double>::selection *BondedStatistics::SelectSeries(
+    const std::vector<std::string> &patterns) {
+  DataCollection<double>::selection *sel = nullptr;
+  if (!streaming_) {
+    for (const std::string &pattern : patterns) {
+      sel = bonded_values_.select(pattern, sel);
+    }
+    return sel;
+  }
+  if (!store_.IsOpen()) {
+    throw std::runtime_error(
+        "the series of the values were not stored, streaming mode needs a "
+        "store for this");
+  }
+  // only read the columns which are selected
+  series_.clear();
+  for (const std::string &pattern : patterns) {
+    for (Index i : Select(pattern)) {
+      if (series_.ArrayByName(names_[i]) == nullptr) {
+        DataCollection<double>::array *a = series_.CreateArray(names_[i]);
+        std::vector<double> column = store_.ReadColumn(i);
+        a->assign(column.begin(), column.end());
+      }
+    }
+  }
+  for (const std::string &pattern : patterns) {
+    sel = series_.select(pattern, sel);
   }
+  return sel;
 }
 
 }  // namespace csg
@@ -19,6 +19,10 @@
 #define VOTCA_CSG_BONDEDSTATISTICS_H
 
 #include "../../include/votca/csg/cgobserver.h"
+#include "bondedaccumulator.h"
+#include "seriesstore.h"
+#include <string>
+#include <vector>
 #include <votca/tools/datacollection.h>
 
 namespace votca {
@@ -31,6 +35,11 @@ namespace csg {
  * between two beads it will calculate and store the distance between the two
  * beads involved in the interaction. It will calculate a similar metric for all
  * other interactions such as IAngle, IDihedral etc...
+ *
+ * In streaming mode the values are not stored. Each interaction only keeps a
+ * BondedAccumulator with running moments, a fine histogram and optionally a
+ * blocked autocorrelation. Commands which need the whole series can use a
+ * SeriesStore on disk.
  **/
 class BondedStatistics : public votca::csg::CGObserver {
  public:
@@ -40,10 +49,60 @@ class BondedStatistics : public votca::csg::CGObserver {
   void EvalConfiguration(Topology *conf,
                          Topology *conf_atom = nullptr) override;
 
+  /**
+   * \brief switch to streaming mode, has to be called before BeginCG
+   *
+   * \param resolution smallest bin width of the histograms of the values
+   * \param correlation_levels levels of the blocked autocorrelation, 0
+   * disables it
+   * \param store_file if not empty, the series are kept in this scratch file
+   */
+  void setStreaming(double resolution, Index correlation_levels,
+                    const std::string &store_file = "");
+  bool IsStreaming() const { return streaming_; }
+
+  /// evaluate the bonded interactions of a frame, in the order of the
+  /// topology
+  static void EvaluateFrame(Topology &conf, std::vector<double> &values);
+  /// add the values of the bonded interactions of one frame
+  void AddFrame(const std::vector<double> &values);
+
   tools::DataCollection<double> &BondedValues() { return bonded_values_; }
 
+  const std::vector<std::string> &Names() const { return names_; }
+  /// indices of the interactions whose name matches the wildcard, sorted by
+  /// name
+  std::vector<Index> Select(const std::string &pattern) const;
+  const BondedAccumulator &Accumulator(Index i) const {
+    return accumulators_[i];
+  }
+
+  /// true if the whole series of the values are available
+  bool HasSeries() const { return !streaming_ || store_.IsOpen(); }
+  /**
+   * \brief select the series of all interactions matching one of the
+   * patterns
+   *
+   * In streaming mode the selected series are read from the store. The
+   * selection has to be deleted by the caller and is valid until the next
+   * call.
+   */
+  tools::DataCollection<double>::selection *SelectSeries(
+      const std::vector<std::string> &patterns);
+
  protected:
   tools::DataCollection<double> bonded_values_;
+
+  std::vector<std::string> names_;
+  bool streaming_ = false;
+  double resolution_ = 1e-5;
+  Index correlation_levels_ = 0;
+  std::string store_file_;
+  std::vector<BondedAccumulator> accumulators_;
+  SeriesStore store_;
+  /// series read from the store for the last selection
+  tools::DataCollection<double> series_;
+  std::vector<double> frame_values_;
 };
 }  // namespace csg
 }  // namespace votca
@@ -28,6 +28,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <votca/tools/getline.h>
 #include <votca/tools/rangeparser.h>
@@ -45,6 +46,8 @@ class CsgBoltzmann final : public CsgApplication {
   }
   bool DoTrajectory() { return !OptionsMap().count("excl"); }
   bool DoMapping() { return true; }
+  bool DoThreaded() { return true; }
+  bool SynchronizeThreads() { return true; }
 
   void Initialize();
   bool EvaluateOptions();
@@ -53,6 +56,30 @@ class CsgBoltzmann final : public CsgApplication {
   void InteractiveMode();
   bool EvaluateTopology(Topology *top, Topology *top_ref);
 
+  /// evaluates the bonded interactions of a frame, the values are added to
+  /// the statistics in the order of the frames
+  class Worker : public CsgApplication::Worker {
+   public:
+    void EvalConfiguration(Topology *top, Topology *) override {
+      BondedStatistics::EvaluateFrame(*top, values_);
+    }
+    std::unique_ptr<CsgApplication::Worker> DetachResult() override {
+      auto result = std::make_unique<Worker>();
+      result->values_ = values_;
+      return result;
+    }
+    bool CanDetachResult() const override { return true; }
+
+    std::vector<double> values_;
+  };
+
+  std::unique_ptr<CsgApplication::Worker> ForkWorker() {
+    return std::make_unique<Worker>();
+  }
+  void MergeWorker(CsgApplication::Worker *worker) {
+    bs_.AddFrame(dynamic_cast<Worker *>(worker)->values_);
+  }
+
  protected:
   ExclusionList CreateExclusionList(Topology *top_atomistic,
                                     Molecule &atomistic, Topology *top_cg,
@@ -63,7 +90,18 @@ void CsgBoltzmann::Initialize() {
   CsgApplication::Initialize();
   AddProgramOptions("Special options")(
       "excl", boost::program_options::value<string>(),
-      "write atomistic exclusion list to file");
+      "write atomistic exclusion list to file")(
+      "stream", "do not keep the values in memory, only running statistics "
+                "and histograms")(
+      "stream-resolution",
+      boost::program_options::value<double>()->default_value(1e-5),
+      "  smallest bin width of the histograms in streaming mode")(
+      "stream-autocor",
+      boost::program_options::value<votca::Index>()->default_value(0),
+      "  levels of the blocked autocorrelation in streaming mode")(
+      "stream-store", boost::program_options::value<string>(),
+      "  scratch file to keep the values in streaming mode, needed for vals "
+      "and cor");
 
   AddObserver(&bs_);
 }
@@ -73,6 +111,14 @@ bool CsgBoltzmann::EvaluateOptions() {
   if (OptionsMap().count("excl")) {
     CheckRequired("cg", "excl options needs a mapping file");
   }
+  if (OptionsMap().count("stream")) {
+    string store;
+    if (OptionsMap().count("stream-store")) {
+      store = OptionsMap()["stream-store"].as<string>();
+    }
+    bs_.setStreaming(OptionsMap()["stream-resolution"].as<double>(),
+                     OptionsMap()["stream-autocor"].as<votca::Index>(), store);
+  }
   return true;
 }
 
@@ -156,13 +202,15 @@ void CsgBoltzmann::InteractiveMode() {
       "help: show this help\n"
       "q: quit\n"
       "list: list all available bonds\n"
+      "stats <file> <selection>: write mean, deviation and range\n"
       "vals <file> <selection>: write values to file\n"
       "hist <file> <selection>: create histogram\n"
       "tab <file> <selection>: create tabulated potential\n"
-      "autocor <file> <selection>: calculate autocorrelation, only one row "
-      "allowed in selection!\n"
+      "autocor <file> <selection>: calculate autocorrelation of each row\n"
       "cor <file> <selection>: calculate correlations, first row is correlated "
-      "with all other rows";
+      "with all other rows\n"
+      "cormat <file> <selection>: calculate correlations of all pairs of "
+      "rows";
 
   cout << help_text << endl;
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <cstdio>
+#include <stdexcept>
+
+// Local private VOTCA includes
+#include "seriesstore.h"
+
+namespace votca {
+namespace csg {
+
+void SeriesStore::Open(const std::string &file, Index columns,
+                       Index block_rows) {
+  Close();
+  if (columns < 0 || block_rows <= 0) {
+    throw std::runtime_error("SeriesStore: invalid size");
+  }
+  filename_ = file;
+  file_.open(file, std::ios::in | std::ios::out | std::ios::trunc |
+                       std::ios::binary);
+  if (!file_.is_open()) {
+    throw std::runtime_error("SeriesStore: could not create file " + file);
+  }
+  columns_ = columns;
+  block_rows_ = block_rows;
+  rows_ = 0;
+  buffer_.assign(columns_ * block_rows_, 0.0);
+  buffered_rows_ = 0;
+  block_sizes_.clear();
+}
+
+void SeriesStore::Close() {
+  if (!file_.is_open()) {
+    return;
+  }
+  file_.close();
+  std::remove(filename_.c_str());
+  buffer_.clear();
+  block_sizes_.clear();
+  rows_ = 0;
+}
+
+void SeriesStore::Append(const std::vector<double> &row) {
+  if (Index(row.size()) != columns_) {
+    throw std::runtime_error("SeriesStore: row has the wrong number of values");
+  }
+  for (Index c = 0; c < columns_; ++c) {
+    buffer_[c * block_rows_ + buffered_rows_] = row[c];
+  }
+  ++buffered_rows_;
+  ++rows_;
+  if (buffered_rows_ == block_rows_) {
+    WriteBlock();
+  }
+}
+
+void SeriesStore::WriteBlock() {
+  file_.seekp(0, std::ios::end);
+  for (Index c = 0; c < columns_; ++c) {
+    file_.write(reinterpret_cast<const char *>(&buffer_[c * block_rows_]),
+                std::streamsize(buffered_rows_ * sizeof(double)));
+  }
+  if (!file_) {
+    throw std::runtime_error("SeriesStore: writing to " + filename_ +
+                             " failed");
+  }
+  block_sizes_.push_back(buffered_rows_);
+  buffered_rows_ = 0;
+}
+
+std::vector<double> SeriesStore::ReadColumn(Index column) {
+  if (column < 0 || column >= columns_) {
+    throw std::runtime_error("SeriesStore: column out of range");
+  }
+  std::vector<double> values(rows_);
+  std::streamoff block_offset = 0;
+  Index row = 0;
+  for (Index size : block_sizes_) {
+    std::streamoff offset =
+        block_offset + std::streamoff(column * size * sizeof(double));
+    file_.seekg(offset);
+    file_.read(reinterpret_cast<char *>(&values[row]),
+               std::streamsize(size * sizeof(double)));
+    if (!file_) {
+      throw std::runtime_error("SeriesStore: reading from " + filename_ +
+                               " failed");
+    }
+    block_offset += std::streamoff(columns_ * size * sizeof(double));
+    row += size;
+  }
+  // rows which are not written yet
+  for (Index r = 0; r < buffered_rows_; ++r) {
+    values[row + r] = buffer_[column * block_rows_ + r];
+  }
+  return values;
+}
+
+}  // namespace csg
+}  // namespace votca
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_SERIESSTORE_H
+#define VOTCA_CSG_SERIESSTORE_H
+
+// Standard includes
+#include <fstream>
+#include <string>
+#include <vector>
+
+// VOTCA includes
+#include <votca/tools/types.h>
+
+namespace votca {
+namespace csg {
+
+/**
+ * \brief Scratch file holding the time series of many columns
+ *
+ * Rows (frames) are appended one by one and buffered in memory. A full
+ * buffer is written as a block, in which the values are ordered by column,
+ * so a single column can later be read with one contiguous read per block
+ * instead of touching every row. The file is removed when the store is
+ * closed.
+ */
+class SeriesStore {
+ public:
+  SeriesStore() = default;
+  ~SeriesStore() { Close(); }
+  SeriesStore(const SeriesStore &) = delete;
+  SeriesStore &operator=(const SeriesStore &) = delete;
+
+  /// create the file, block_rows rows are written at once
+  void Open(const std::string &file, Index columns, Index block_rows = 1024);
+  void Close();
+  bool IsOpen() const { return file_.is_open(); }
+
+  void Append(const std::vector<double> &row);
+
+  Index Rows() const { return rows_; }
+  Index Columns() const { return columns_; }
+
+  /// read all rows of one column
+  std::vector<double> ReadColumn(Index column);
+
+ private:
+  void WriteBlock();
+
+  std::string filename_;
+  std::fstream file_;
+  Index columns_ = 0;
+  Index block_rows_ = 0;
+  Index rows_ = 0;
+  /// rows of the current block, ordered by column
+  std::vector<double> buffer_;
+  Index buffered_rows_ = 0;
+  /// number of rows of each written block
+  std::vector<Index> block_sizes_;
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_SERIESSTORE_H
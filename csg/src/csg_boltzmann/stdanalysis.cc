@@ -18,6 +18,7 @@
 #include "stdanalysis.h"
 #include "analysistool.h"
 #include "bondedstatistics.h"
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -31,7 +32,9 @@ void StdAnalysis::Register(std::map<std::string, AnalysisTool *> &lib) {
   lib["list"] = this;
   lib["vals"] = this;
   lib["cor"] = this;
+  lib["cormat"] = this;
   lib["autocor"] = this;
+  lib["stats"] = this;
 }
 
 void StdAnalysis::Command(BondedStatistics &bs, const std::string &cmd,
@@ -42,17 +45,20 @@ void StdAnalysis::Command(BondedStatistics &bs, const std::string &cmd,
   if (cmd == "cor") {
     WriteCorrelations(bs, args);
   }
+  if (cmd == "cormat") {
+    WriteCorrelationMatrix(bs, args);
+  }
   if (cmd == "autocor") {
     WriteAutocorrelation(bs, args);
   }
+  if (cmd == "stats") {
+    WriteStatistics(bs, args);
+  }
   if (cmd == "list") {
-    votca::tools::DataCollection<double>::selection *sel =
-        bs.BondedValues().select("*");
     std::cout << "Available bonded interactions:" << std::endl;
-    for (auto &array : *sel) {
-      std::cout << array->getName() << " " << std::endl;
+    for (Index i : bs.Select("*")) {
+      std::cout << bs.Names()[i] << " " << std::endl;
     }
-    delete sel;
   }
 }
 
@@ -76,12 +82,24 @@ void StdAnalysis::Help(const std::string &cmd, std::vector<std::string> &) {
         << "linear correlation coefficient, 2D histograms with data from the "
            "vals command should be used instead!\n";
   }
+  if (cmd == "cormat") {
+    std::cout << "cormat <file> <selection>\n"
+              << "Calculate the matrix of the linear correlation coefficients "
+                 "of all pairs of items in selection. The first line lists "
+                 "the items.\n";
+  }
   if (cmd == "autocor") {
     std::cout
-        << "autocor <file> <interaction>\n"
-        << "calculate autocorrelation function of first item in selection. "
-           "The output is periodic since FFTW3 is used to "
-           "calcualte correlations.\n";
+        << "autocor <file> <selection>\n"
+        << "calculate autocorrelation function of the items in selection, "
+           "one column for each item after the lag. The output is periodic "
+           "since FFTs are used to calculate correlations. In streaming mode "
+           "without a store only the first item is used.\n";
+  }
+  if (cmd == "stats") {
+    std::cout << "stats <file> <selection>\n"
+              << "write number of values, mean, standard deviation, minimum "
+                 "and maximum of each interaction in selection.\n";
   }
   if (cmd == "list") {
     std::cout << "list\nlists all available interactions\n";
@@ -92,11 +110,11 @@ void StdAnalysis::WriteValues(BondedStatistics &bs,
                               std::vector<std::string> &args) {
   std::ofstream out;
 
-  votca::tools::DataCollection<double>::selection *sel = nullptr;
-
-  for (size_t i = 1; i < args.size(); i++) {
-    sel = bs.BondedValues().select(args[i], sel);
+  if (!CheckSeries(bs)) {
+    return;
   }
+  votca::tools::DataCollection<double>::selection *sel = bs.SelectSeries(
+      std::vector<std::string>(args.begin() + 1, args.end()));
 
   out.open(args[0]);
   out << *sel << std::endl;
@@ -109,16 +127,25 @@ void StdAnalysis::WriteValues(BondedStatistics &bs,
 void StdAnalysis::WriteAutocorrelation(BondedStatistics &bs,
                                        std::vector<std::string> &args) {
   std::ofstream out;
-  votca::tools::DataCollection<double>::selection *sel = nullptr;
-
-  for (size_t i = 1; i < args.size(); i++) {
-    sel = bs.BondedValues().select(args[i], sel);
+  if (!bs.HasSeries()) {
+    WriteBlockedAutocorrelation(bs, args);
+    return;
   }
+  votca::tools::DataCollection<double>::selection *sel = bs.SelectSeries(
+      std::vector<std::string>(args.begin() + 1, args.end()));
 
   votca::tools::CrossCorrelate c;
-  c.AutoCorrelate(*sel);
+  c.AutoCorrelations(*sel);
+  const Eigen::MatrixXd &corr = c.getAutocorrelations();
   out.open(args[0]);
-  out << c << std::endl;
+  for (Index i = 0; i < corr.rows(); i++) {
+    out << i;
+    for (Index j = 0; j < corr.cols(); j++) {
+      out << " " << corr(i, j);
+    }
+    out << "\n";
+  }
+  out << std::endl;
   out.close();
   std::cout << "calculated autocorrelation for " << sel->size()
             << " data rows, written to " << args[0] << std::endl;
@@ -128,11 +155,11 @@ void StdAnalysis::WriteAutocorrelation(BondedStatistics &bs,
 void StdAnalysis::WriteCorrelations(BondedStatistics &bs,
                                     std::vector<std::string> &args) {
   std::ofstream out;
-  votca::tools::DataCollection<double>::selection *sel = nullptr;
-
-  for (size_t i = 1; i < args.size(); i++) {
-    sel = bs.BondedValues().select(args[i], sel);
+  if (!CheckSeries(bs)) {
+    return;
   }
+  votca::tools::DataCollection<double>::selection *sel = bs.SelectSeries(
+      std::vector<std::string>(args.begin() + 1, args.end()));
 
   votca::tools::Correlate c;
   c.CalcCorrelations(*sel);
@@ -144,5 +171,95 @@ void StdAnalysis::WriteCorrelations(BondedStatistics &bs,
   delete sel;
 }
 
+void StdAnalysis::WriteCorrelationMatrix(BondedStatistics &bs,
+                                         std::vector<std::string> &args) {
+  std::ofstream out;
+  if (!CheckSeries(bs)) {
+    return;
+  }
+  votca::tools::DataCollection<double>::selection *sel = bs.SelectSeries(
+      std::vector<std::string>(args.begin() + 1, args.end()));
+
+  votca::tools::Correlate c;
+  c.CalcCorrelationMatrix(*sel);
+  out.open(args[0]);
+  out << "#";
+  for (auto &array : *sel) {
+    out << " \"" << array->getName() << "\"";
+  }
+  out << "\n" << c.getCorrelationMatrix() << std::endl;
+  out.close();
+  std::cout << "calculated correlation matrix of " << sel->size()
+            << " rows, written to " << args[0] << std::endl;
+  delete sel;
+}
+
+bool StdAnalysis::CheckSeries(BondedStatistics &bs) {
+  if (!bs.HasSeries()) {
+    std::cout << "error, the values were not stored in streaming mode, use "
+                 "--stream-store"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void StdAnalysis::WriteBlockedAutocorrelation(BondedStatistics &bs,
+                                              std::vector<std::string> &args) {
+  std::vector<Index> sel;
+  for (size_t i = 1; i < args.size() && sel.empty(); i++) {
+    sel = bs.Select(args[i]);
+  }
+  if (sel.empty()) {
+    std::cout << "error, no interaction selected" << std::endl;
+    return;
+  }
+  const BondedAccumulator &acc = bs.Accumulator(sel.front());
+  if (!acc.HasCorrelation()) {
+    std::cout << "error, autocorrelation in streaming mode needs "
+                 "--stream-autocor or --stream-store"
+              << std::endl;
+    return;
+  }
+  std::vector<Index> lags;
+  std::vector<double> correlation;
+  acc.Autocorrelation(lags, correlation);
+  std::ofstream out(args[0]);
+  for (size_t i = 0; i < lags.size(); ++i) {
+    out << lags[i] << " " << correlation[i] / correlation[0] << "\n";
+  }
+  out.close();
+  std::cout << "calculated blocked autocorrelation for "
+            << bs.Names()[sel.front()] << ", written to " << args[0]
+            << std::endl;
+}
+
+void StdAnalysis::WriteStatistics(BondedStatistics &bs,
+                                  std::vector<std::string> &args) {
+  std::ofstream out(args[0]);
+  out << "# name count mean std min max\n";
+  Index n = 0;
+  for (size_t i = 1; i < args.size(); i++) {
+    for (Index j : bs.Select(args[i])) {
+      BondedAccumulator acc(1.0, 0);
+      const BondedAccumulator *stats = &acc;
+      if (bs.IsStreaming()) {
+        stats = &bs.Accumulator(j);
+      } else {
+        for (double value : *bs.BondedValues().ArrayByName(bs.Names()[j])) {
+          acc.Add(value);
+        }
+      }
+      out << "\"" << bs.Names()[j] << "\" " << stats->Count() << " "
+          << stats->Mean() << " " << std::sqrt(stats->Variance()) << " "
+          << stats->Min() << " " << stats->Max() << "\n";
+      ++n;
+    }
+  }
+  out.close();
+  std::cout << "written statistics of " << n << " interactions to " << args[0]
+            << std::endl;
+}
+
 }  // namespace csg
 }  // namespace votca
@@ -40,6 +40,15 @@ class StdAnalysis : public AnalysisTool {
   void WriteCorrelations(BondedStatistics &bs, std::vector<std::string> &args);
   void WriteAutocorrelation(BondedStatistics &bs,
                             std::vector<std::string> &args);
+  void WriteCorrelationMatrix(BondedStatistics &bs,
+                              std::vector<std::string> &args);
+  void WriteStatistics(BondedStatistics &bs, std::vector<std::string> &args);
+
+ private:
+  /// prints an error and returns false if the series were not stored
+  bool CheckSeries(BondedStatistics &bs);
+  void WriteBlockedAutocorrelation(BondedStatistics &bs,
+                                   std::vector<std::string> &args);
 };
 
 }  // namespace csg
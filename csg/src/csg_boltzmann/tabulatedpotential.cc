@@ -19,10 +19,12 @@
 #include "../../include/votca/csg/version.h"
 #include "analysistool.h"
 #include "bondedstatistics.h"
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 #include <votca/tools/constants.h>
@@ -197,36 +199,21 @@ pair<Index, Index> TabulatedPotential::getSmoothIterations() const {
 void TabulatedPotential::WriteHistogram(BondedStatistics &bs,
                                         vector<string> &args) {
   ofstream out;
-  DataCollection<double>::selection *sel = nullptr;
-
-  for (size_t i = 1; i < args.size(); i++) {
-    sel = bs.BondedValues().select(args[i], sel);
-  }
   Histogram h(hist_options_);
-  h.ProcessData(sel);
+  Index rows = ProcessSelection_(bs, args, h);
   out.open(args[0]);
   out << h;
   out.close();
-  cout << "histogram created using " << sel->size() << " data-rows, written to "
+  cout << "histogram created using " << rows << " data-rows, written to "
        << args[0] << endl;
-  delete sel;
 }
 
 void TabulatedPotential::WritePotential(BondedStatistics &bs,
                                         vector<string> &args) {
   ofstream out;
-  DataCollection<double>::selection *sel = nullptr;
-
-  // Appends all the interactions that are specified in args to selection
-  // pointer given by sel
-
-  for (size_t i = 1; i < args.size(); i++) {
-    sel = bs.BondedValues().select(args[i], sel);
-  }
-
   Histogram h(tab_options_);
 
-  h.ProcessData(sel);
+  Index rows = ProcessSelection_(bs, args, h);
   for (Index i = 0; i < tab_smooth1_; ++i) {
     Smooth_(h.getPdf(), tab_options_.periodic_);
   }
@@ -244,9 +231,8 @@ void TabulatedPotential::WritePotential(BondedStatistics &bs,
         << " " << F[i] << endl;
   }
   out.close();
-  cout << "histogram created using " << sel->size() << " data-rows, written to "
+  cout << "histogram created using " << rows << " data-rows, written to "
        << args[0] << endl;
-  delete sel;
 }
 
 /******************************************************************************
@@ -307,6 +293,42 @@ void TabulatedPotential::CalcForce_(vector<double> &U, vector<double> &F,
   }
 }
 
+Index TabulatedPotential::ProcessSelection_(BondedStatistics &bs,
+                                            const vector<string> &args,
+                                            Histogram &h) {
+  if (!bs.IsStreaming()) {
+    // Appends all the interactions that are specified in args to selection
+    // pointer given by sel
+    DataCollection<double>::selection *sel = nullptr;
+    for (size_t i = 1; i < args.size(); i++) {
+      sel = bs.BondedValues().select(args[i], sel);
+    }
+    h.ProcessData(sel);
+    Index rows = Index(sel->size());
+    delete sel;
+    return rows;
+  }
+
+  vector<double> values;
+  vector<double> weights;
+  double data_min = numeric_limits<double>::max();
+  double data_max = numeric_limits<double>::lowest();
+  Index rows = 0;
+  for (size_t i = 1; i < args.size(); i++) {
+    for (Index j : bs.Select(args[i])) {
+      const BondedAccumulator &acc = bs.Accumulator(j);
+      if (acc.Count() > 0) {
+        data_min = std::min(data_min, acc.Min());
+        data_max = std::max(data_max, acc.Max());
+        acc.AppendBins(values, weights);
+      }
+      ++rows;
+    }
+  }
+  h.ProcessWeightedData(values, weights, data_min, data_max);
+  return rows;
+}
+
 void TabulatedPotential::Smooth_(vector<double> &data, bool bPeriodic) {
   double old[3];
   Index n = Index(data.size());
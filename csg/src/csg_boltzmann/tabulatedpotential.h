@@ -142,6 +142,18 @@ class TabulatedPotential : public AnalysisTool {
 
   bool SetOption_(const std::vector<std::string> &args);
 
+  /**
+   * \brief Sorts all interactions selected by args into the histogram
+   *
+   * In streaming mode the fine histograms of the accumulators are rebinned,
+   * so the values are only known up to the resolution of the accumulators.
+   *
+   * \return number of selected interactions
+   **/
+  Index ProcessSelection_(BondedStatistics &bs,
+                          const std::vector<std::string> &args,
+                          TOOLS::Histogram &h);
+
   /**
    * \brief Smooths a vector of doubles
    *
@@ -373,6 +373,16 @@ std::unique_ptr<CsgApplication::Worker> RDFCalculator::ForkWorker() {
   return worker;
 }
 
+std::unique_ptr<CsgApplication::Worker> RDFCalculator::Worker::DetachResult() {
+  auto result = std::make_unique<RDFCalculator::Worker>();
+  result->rdfcalculator_ = rdfcalculator_;
+  result->cur_vol_ = cur_vol_;
+  result->cur_beadlist_1_count_ = cur_beadlist_1_count_;
+  result->cur_beadlist_2_count_ = cur_beadlist_2_count_;
+  result->current_hists_ = current_hists_;
+  return result;
+}
+
 void RDFCalculator::MergeWorker(CsgApplication::Worker *worker_) {
   processed_some_frames_ = true;
   RDFCalculator::Worker *worker =
@@ -163,6 +163,10 @@ class RDFCalculator {
     void DoNonbonded(Topology *top);
     /// process bonded interactions for given frame
     void DoBonded(Topology *top);
+
+    /// copy the histograms of the current frame for the ordered merge
+    std::unique_ptr<CsgApplication::Worker> DetachResult() override;
+    bool CanDetachResult() const override { return true; }
   };
   /// update the correlations after interations were processed
   void DoCorrelations(RDFCalculator::Worker *worker);
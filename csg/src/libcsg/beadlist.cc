@@ -15,9 +15,6 @@
  *
  */
 
-// VOTCA includes
-#include <votca/tools/tokenizer.h>
-
 // Local VOTCA includes
 #include "votca/csg/beadlist.h"
 #include "votca/csg/topology.h"
@@ -29,27 +26,8 @@ using namespace std;
 
 Index BeadList::Generate(Topology &top, const string &select) {
   topology_ = &top;
-  bool selectByName = false;
-  string pSelect;  // parsed selection string
-
-  if (select.substr(0, 5) == "name:") {
-    // select according to bead name instead of type
-    pSelect = select.substr(5);
-    selectByName = true;
-  } else {
-    pSelect = select;
-  }
-
-  for (auto &bead : top.Beads()) {
-    if (!selectByName) {
-      if (tools::wildcmp(pSelect, bead.getType())) {
-        beads_.push_back(&bead);
-      }
-    } else {
-      if (tools::wildcmp(pSelect, bead.getName())) {
-        beads_.push_back(&bead);
-      }
-    }
+  for (Index id : top.SelectBeads(select)) {
+    beads_.push_back(top.getBead(id));
   }
   return size();
 }
@@ -59,30 +37,12 @@ Index BeadList::GenerateInSphericalSubvolume(Topology &top,
                                              Eigen::Vector3d ref,
                                              double radius) {
   topology_ = &top;
-  bool selectByName = false;
-  string pSelect;  // parsed selection string
-
-  if (select.substr(0, 5) == "name:") {
-    // select according to bead name instead of type
-    pSelect = select.substr(5);
-    selectByName = true;
-  } else {
-    pSelect = select;
-  }
-
-  for (auto &bead : top.Beads()) {
-    if (topology_->BCShortestConnection(ref, bead.getPos()).norm() > radius) {
+  for (Index id : top.SelectBeads(select)) {
+    Bead *bead = top.getBead(id);
+    if (topology_->BCShortestConnection(ref, bead->getPos()).norm() > radius) {
       continue;
     }
-    if (!selectByName) {
-      if (tools::wildcmp(pSelect, bead.getType())) {
-        beads_.push_back(&bead);
-      }
-    } else {
-      if (tools::wildcmp(pSelect, bead.getName())) {
-        beads_.push_back(&bead);
-      }
-    }
+    beads_.push_back(bead);
   }
   return size();
 }
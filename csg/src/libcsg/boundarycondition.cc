@@ -19,6 +19,9 @@
 #include <cassert>
 #include <vector>
 
+// VOTCA includes
+#include <votca/tools/types.h>
+
 // Local VOTCA includes
 #include "votca/csg/boundarycondition.h"
 
@@ -53,5 +56,55 @@ double BoundaryCondition::getShortestBoxDimension() const {
   return std::min(la, std::min(lb, lc));
 }
 
+// the box type is a template parameter, so the loop over the positions
+// contains no branches and no virtual calls
+template <BoundaryCondition::eBoxtype type, class RefPos>
+void BoundaryCondition::ShortestConnections(
+    const RefPos &r_i, const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+    Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+    Eigen::Ref<Eigen::VectorXd> dist2) const {
+  for (Index k = 0; k < r_j.cols(); ++k) {
+    r_ij.col(k) = MinimumImage<type>(r_j.col(k) - r_i(k));
+    dist2(k) = r_ij.col(k).squaredNorm();
+  }
+}
+
+template <class RefPos>
+void BoundaryCondition::DispatchShortestConnections(
+    const RefPos &r_i, const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+    Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+    Eigen::Ref<Eigen::VectorXd> dist2) const {
+  assert(r_ij.cols() == r_j.cols() && dist2.size() == r_j.cols());
+  switch (getBoxType()) {
+    case typeOrthorhombic:
+      ShortestConnections<typeOrthorhombic>(r_i, r_j, r_ij, dist2);
+      break;
+    case typeTriclinic:
+      ShortestConnections<typeTriclinic>(r_i, r_j, r_ij, dist2);
+      break;
+    default:
+      ShortestConnections<typeOpen>(r_i, r_j, r_ij, dist2);
+  }
+}
+
+void BoundaryCondition::BCShortestConnections(
+    const Eigen::Vector3d &r_i, const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+    Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+    Eigen::Ref<Eigen::VectorXd> dist2) const {
+  DispatchShortestConnections(
+      [&r_i](Index) -> const Eigen::Vector3d & { return r_i; }, r_j, r_ij,
+      dist2);
+}
+
+void BoundaryCondition::BCShortestConnectionsPairwise(
+    const Eigen::Ref<const Eigen::Matrix3Xd> &r_i,
+    const Eigen::Ref<const Eigen::Matrix3Xd> &r_j,
+    Eigen::Ref<Eigen::Matrix3Xd> r_ij,
+    Eigen::Ref<Eigen::VectorXd> dist2) const {
+  assert(r_i.cols() == r_j.cols());
+  DispatchShortestConnections([&r_i](Index k) { return r_i.col(k); }, r_j,
+                              r_ij, dist2);
+}
+
 }  // namespace csg
 }  // namespace votca
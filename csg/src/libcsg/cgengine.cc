@@ -64,6 +64,7 @@ std::unique_ptr<TopologyMap> CGEngine::CreateCGTopology(const Topology &in,
     m->AddMoleculeMap(std::move(map));
   }
   out.RebuildExclusions();
+  m->Initialize();
   return m;
 }
 
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Local VOTCA includes
+#include "votca/csg/bead.h"
+#include "votca/csg/cgmdengine.h"
+
+namespace votca {
+namespace csg {
+
+CGMDEngine::PairPotential::PairPotential(const std::string &type1,
+                                         const std::string &type2,
+                                         const tools::Table &table)
+    : type1_(type1), type2_(type2) {
+  Index n = table.size();
+  if (n < 2) {
+    throw std::runtime_error("table of the potential " + type1 + "-" + type2 +
+                             " needs at least two points");
+  }
+  r_min_ = table.x(0);
+  cutoff_ = table.x(n - 1);
+  dr_ = (cutoff_ - r_min_) / double(n - 1);
+  if (dr_ <= 0) {
+    throw std::runtime_error("table of the potential " + type1 + "-" + type2 +
+                             " has to be ordered by increasing distance");
+  }
+  for (Index i = 1; i < n; ++i) {
+    if (std::abs(table.x(i) - r_min_ - double(i) * dr_) > 1e-6 * dr_) {
+      throw std::runtime_error("table of the potential " + type1 + "-" +
+                               type2 + " has to be on a regular grid");
+    }
+  }
+
+  u_.resize(n);
+  f_.resize(n);
+  for (Index i = 0; i < n; ++i) {
+    u_[i] = table.y(i);
+  }
+  f_[0] = -(u_[1] - u_[0]) / dr_;
+  f_[n - 1] = -(u_[n - 1] - u_[n - 2]) / dr_;
+  for (Index i = 1; i < n - 1; ++i) {
+    f_[i] = -(u_[i + 1] - u_[i - 1]) / (2.0 * dr_);
+  }
+
+  nblist_.setCutoff(cutoff_);
+  nblist_.SetMatchFunction(this, &PairPotential::AddForce);
+}
+
+bool CGMDEngine::PairPotential::AddForce(Bead *bead1, Bead *bead2,
+                                         const Eigen::Vector3d &r,
+                                         double dist) {
+  double u;
+  double f;
+  if (dist <= r_min_) {
+    u = u_[0] + f_[0] * (r_min_ - dist);
+    f = f_[0];
+  } else {
+    double x = (dist - r_min_) / dr_;
+    Index i = std::min(Index(x), Index(u_.size()) - 2);
+    double w = x - double(i);
+    u = (1.0 - w) * u_[i] + w * u_[i + 1];
+    f = (1.0 - w) * f_[i] + w * f_[i + 1];
+  }
+  energy_ += u;
+  // r points from bead1 to bead2, a positive f pushes them apart
+  Eigen::Vector3d force = (f / dist) * r;
+  coordinates_->force_[bead1->getId()] -= force;
+  coordinates_->force_[bead2->getId()] += force;
+  // the pairs are only needed for the forces, none is stored
+  return false;
+}
+
+void CGMDEngine::AddNonbondedTable(const std::string &type1,
+                                   const std::string &type2,
+                                   const tools::Table &table) {
+  potentials_.push_back(std::make_unique<PairPotential>(type1, type2, table));
+}
+
+void CGMDEngine::Initialize(Topology &top) {
+  if (top.getBoxType() == BoundaryCondition::typeOpen) {
+    throw std::runtime_error("cgmd needs a periodic box");
+  }
+  if (!top.BondedInteractions().empty()) {
+    throw std::runtime_error(
+        "cgmd does not support bonded interactions, only tabulated "
+        "non-bonded potentials");
+  }
+  if (potentials_.empty()) {
+    throw std::runtime_error("cgmd needs at least one non-bonded potential");
+  }
+  top_ = &top;
+
+  inv_mass_.resize(top.BeadCount());
+  for (Index i = 0; i < top.BeadCount(); ++i) {
+    const Bead *bead = top.getBead(i);
+    if (!bead->HasPos()) {
+      throw std::runtime_error("cgmd needs the positions of all beads");
+    }
+    if (bead->getMass() <= 0) {
+      throw std::runtime_error("bead " + bead->getName() +
+                               " has no positive mass, which cgmd needs");
+    }
+    inv_mass_[i] = 1.0 / bead->getMass();
+  }
+
+  for (auto &potential : potentials_) {
+    for (const std::string &type : {potential->type1_, potential->type2_}) {
+      if (!top.BeadTypeExist(type)) {
+        throw std::runtime_error("bead type " + type +
+                                 " of a cgmd potential is not in topology");
+      }
+    }
+    potential->list1_ = BeadList();
+    potential->list2_ = BeadList();
+    potential->list1_.Generate(top, potential->type1_);
+    potential->list2_.Generate(top, potential->type2_);
+    potential->nblist_.setSkin(skin_);
+    potential->coordinates_ = &top.getBeadCoordinates();
+  }
+
+  if (!top.HasVel()) {
+    DrawVelocities();
+  }
+  for (Index i = 0; i < top.BeadCount(); ++i) {
+    Bead *bead = top.getBead(i);
+    bead->setVel(bead->getVel());
+    bead->setF(Eigen::Vector3d::Zero());
+  }
+  top.SetHasVel(true);
+  top.SetHasForce(true);
+  ComputeForces();
+}
+
+void CGMDEngine::DrawVelocities() {
+  Eigen::Vector3d momentum = Eigen::Vector3d::Zero();
+  double mass = 0.0;
+  for (Index i = 0; i < top_->BeadCount(); ++i) {
+    Bead *bead = top_->getBead(i);
+    double sigma = std::sqrt(kbt_ * inv_mass_[i]);
+    bead->setVel(sigma * GaussianVector());
+    momentum += bead->getMass() * bead->getVel();
+    mass += bead->getMass();
+  }
+  // no drift of the center of mass
+  Eigen::Vector3d v_com = momentum / mass;
+  for (Index i = 0; i < top_->BeadCount(); ++i) {
+    Bead *bead = top_->getBead(i);
+    bead->setVel(bead->getVel() - v_com);
+  }
+}
+
+Eigen::Vector3d CGMDEngine::GaussianVector() {
+  // drawn one after the other to keep the sequence reproducible
+  double x = normal_(rng_);
+  double y = normal_(rng_);
+  double z = normal_(rng_);
+  return Eigen::Vector3d(x, y, z);
+}
+
+void CGMDEngine::ComputeForces() {
+  BeadCoordinates &coordinates = top_->getBeadCoordinates();
+  for (Eigen::Vector3d &f : coordinates.force_) {
+    f.setZero();
+  }
+  potential_energy_ = 0.0;
+  for (auto &potential : potentials_) {
+    potential->energy_ = 0.0;
+    if (potential->type1_ == potential->type2_) {
+      potential->nblist_.Generate(potential->list1_);
+    } else {
+      potential->nblist_.Generate(potential->list1_, potential->list2_);
+    }
+    potential_energy_ += potential->energy_;
+  }
+}
+
+void CGMDEngine::Integrate(Index nsteps) {
+  if (top_ == nullptr) {
+    throw std::runtime_error("cgmd engine was not initialized");
+  }
+  BeadCoordinates &coordinates = top_->getBeadCoordinates();
+  Index n = top_->BeadCount();
+  double half_dt = 0.5 * dt_;
+  // Ornstein-Uhlenbeck step of the velocities
+  double c1 = std::exp(-friction_ * dt_);
+  double c2 = std::sqrt(1.0 - c1 * c1);
+
+  for (Index step = 0; step < nsteps; ++step) {
+    for (Index i = 0; i < n; ++i) {
+      Eigen::Vector3d &v = coordinates.vel_[i];
+      v += half_dt * inv_mass_[i] * coordinates.force_[i];
+      coordinates.pos_[i] += half_dt * v;
+      if (friction_ > 0) {
+        double sigma = std::sqrt(kbt_ * inv_mass_[i]);
+        v = c1 * v + c2 * sigma * GaussianVector();
+      }
+      coordinates.pos_[i] += half_dt * v;
+    }
+    ComputeForces();
+    for (Index i = 0; i < n; ++i) {
+      coordinates.vel_[i] += half_dt * inv_mass_[i] * coordinates.force_[i];
+    }
+  }
+  top_->setStep(top_->getStep() + nsteps);
+  top_->setTime(top_->getTime() + double(nsteps) * dt_);
+}
+
+double CGMDEngine::KineticEnergy() const {
+  const BeadCoordinates &coordinates = top_->getBeadCoordinates();
+  double ekin = 0.0;
+  for (Index i = 0; i < top_->BeadCount(); ++i) {
+    ekin += 0.5 * coordinates.vel_[i].squaredNorm() / inv_mass_[i];
+  }
+  return ekin;
+}
+
+}  // namespace csg
+}  // namespace votca
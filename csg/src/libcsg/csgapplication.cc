@@ -15,9 +15,15 @@
  *
  */
 
+// Standard includes
+#include <memory>
+#include <string>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 // Third party includes
 #include <boost/algorithm/string/trim.hpp>
-#include <memory>
 
 // Local VOTCA includes
 #include "votca/csg/cgengine.h"
@@ -71,7 +77,10 @@ void CsgApplication::Initialize() {
         "first-frame", boost::program_options::value<Index>()->default_value(0),
         "  start with this frame")("nframes",
                                    boost::program_options::value<Index>(),
-                                   "  process the given number of frames");
+                                   "  process the given number of frames")(
+        "read-ahead", boost::program_options::value<Index>()->default_value(0),
+        "  number of frames to read ahead in a separate thread (0 reads the\n"
+        "  frames in the workers)");
   }
 
   if (DoThreaded()) {
@@ -135,14 +144,75 @@ void CsgApplication::ShowHelpText(std::ostream &out) {
 }
 
 void CsgApplication::Worker::Run() {
+#if defined(_OPENMP)
+  // the workers already run concurrently, so do not start nested OpenMP teams
+  // e.g. in the neighbour search
+  if (app_->DoThreaded() && app_->nthreads_ > 1) {
+    omp_set_num_threads(1);
+  }
+#endif
   while (app_->ProcessData(this)) {
-    if (app_->SynchronizeThreads()) {
+    if (app_->ordered_merge_) {
+      app_->PushResult(frame_, DetachResult());
+    } else if (app_->SynchronizeThreads()) {
       Index id = getId();
       app_->threadsMutexesOut_[id]->Lock();
       app_->MergeWorker(this);
       app_->threadsMutexesOut_[(id + 1) % app_->nthreads_]->Unlock();
     }
   }
+  if (app_->ordered_merge_) {
+    app_->WorkerDone();
+  }
+}
+
+void CsgApplication::PushResult(Index frame, std::unique_ptr<Worker> result) {
+  if (!result) {
+    throw std::runtime_error("worker did not return the result of frame " +
+                             std::to_string(frame));
+  }
+  {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    results_[frame] = std::move(result);
+  }
+  results_changed_.notify_all();
+}
+
+void CsgApplication::WorkerDone() {
+  {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    --workers_running_;
+  }
+  results_changed_.notify_all();
+}
+
+void CsgApplication::MergeResultsInOrder() {
+  std::unique_lock<std::mutex> lock(results_mutex_);
+  while (true) {
+    results_changed_.wait(lock, [this]() {
+      return results_.count(next_merged_) > 0 || workers_running_ == 0;
+    });
+    auto result = results_.find(next_merged_);
+    if (result == results_.end()) {
+      break;
+    }
+    std::unique_ptr<Worker> worker = std::move(result->second);
+    results_.erase(result);
+    // merge without blocking the workers
+    lock.unlock();
+    MergeWorker(worker.get());
+    lock.lock();
+    ++next_merged_;
+    // workers waiting for space in the reorder buffer
+    results_changed_.notify_all();
+  }
+}
+
+void CsgApplication::WaitForMerge() {
+  std::unique_lock<std::mutex> lock(results_mutex_);
+  results_changed_.wait(lock, [this]() {
+    return frames_read_ - next_merged_ < max_pending_results_ * nthreads_;
+  });
 }
 
 bool CsgApplication::ProcessData(Worker *worker) {
@@ -150,42 +220,60 @@ bool CsgApplication::ProcessData(Worker *worker) {
   Index id;
   id = worker->getId();
 
-  if (SynchronizeThreads()) {
+  if (ordered_merge_) {
+    // do not read further ahead than the reorder buffer allows
+    WaitForMerge();
+  }
+  if (OrderedHandOff()) {
     // wait til its your turn
     threadsMutexesIn_[id]->Lock();
   }
   traj_readerMutex_.Lock();
-  if (nframes_ == 0) {
-    traj_readerMutex_.Unlock();
+  Topology *frame = nullptr;
+  if (is_first_frame_ && id == 0) {
+    // the first frame was already read and counted in Run
+    is_first_frame_ = false;
+  } else {
+    if (nframes_ == 0) {
+      traj_readerMutex_.Unlock();
 
-    if (SynchronizeThreads()) {
-      // done processing? don't forget to unlock next worker anyway
-      threadsMutexesIn_[(id + 1) % nthreads_]->Unlock();
-    }
+      if (OrderedHandOff()) {
+        // done processing? don't forget to unlock next worker anyway
+        threadsMutexesIn_[(id + 1) % nthreads_]->Unlock();
+      }
 
-    return false;
-  }
-  nframes_--;
-  if (!is_first_frame_ || worker->getId() != 0) {
+      return false;
+    }
+    nframes_--;
     // get frame
-    bool tmpRes = traj_reader_->NextFrame(worker->top_);
+    bool tmpRes;
+    if (read_ahead_) {
+      frame = read_ahead_->Acquire();
+      tmpRes = (frame != nullptr);
+    } else {
+      tmpRes = traj_reader_->NextFrame(worker->top_);
+    }
     if (!tmpRes) {
       traj_readerMutex_.Unlock();
-      if (SynchronizeThreads()) {
+      if (OrderedHandOff()) {
         threadsMutexesIn_[(id + 1) % nthreads_]->Unlock();
       }
       return false;
     }
-  }
-  if (worker->getId() == 0) {
-    is_first_frame_ = false;
+    worker->frame_ = frames_read_++;
   }
 
   traj_readerMutex_.Unlock();
-  if (SynchronizeThreads()) {
+  if (OrderedHandOff()) {
     // unlock next frame for input
     threadsMutexesIn_[(id + 1) % nthreads_]->Unlock();
   }
+  // the order of the frames is fixed once the buffer was taken, so the copy
+  // can be done while the next worker gets its frame
+  if (frame != nullptr) {
+    worker->top_.CopyFrameData(*frame);
+    read_ahead_->Release(frame);
+  }
   // evaluate
   if (do_mapping_) {
     worker->map_->Apply();
@@ -229,6 +317,8 @@ void CsgApplication::Run(void) {
   // read in the topology for master
   //////////////////////////////////////////////////
   reader->ReadTopology(OptionsMap()["top"].as<std::string>(), master->top_);
+  // the neighbour searches look up the exclusions in the compact table
+  master->top_.getExclusions().BuildLookupTable();
   // Ensure that the coarse grained topology will have the same boundaries
   master->top_cg_.setBox(master->top_.getBox());
 
@@ -310,12 +400,9 @@ void CsgApplication::Run(void) {
       myWorkers_.back()->setApplication(this);
       myWorkers_.back()->setId(thread);
 
-      // this will be changed to CopyTopologyData
-      // read in the topology
-
-      reader->ReadTopology(OptionsMap()["top"].as<std::string>(),
-                           myWorkers_.back()->top_);
-      myWorkers_.back()->top_.CheckMoleculeNaming();
+      // copy the topology of the master instead of reading the file again,
+      // the bonded interactions are shared
+      myWorkers_.back()->top_.ShareTopologyData(master->top_);
 
       if (do_mapping_) {
         // create the mapping + cg topology
@@ -324,6 +411,13 @@ void CsgApplication::Run(void) {
       }
     }
 
+    // the workers already run in parallel, so they map serially
+    if (do_mapping_ && myWorkers_.size() > 1) {
+      for (auto &worker : myWorkers_) {
+        worker->map_->setParallel(false);
+      }
+    }
+
     //////////////////////////////////////////////////
     // Proceed to first frame of interest
     //////////////////////////////////////////////////
@@ -335,14 +429,14 @@ void CsgApplication::Run(void) {
              "is intended.\n"
           << std::endl;
     }
-    // seek first frame, let thread0 do that
-    bool bok;
-    for (bok = true; bok == true; bok = traj_reader_->NextFrame(master->top_)) {
-      if ((has_begin && (master->top_.getTime() < begin)) || first_frame > 1) {
-        first_frame--;
-        continue;
-      }
-      break;
+    // seek first frame, let thread0 do that, readers with a frame index jump
+    // there directly
+    bool bok = true;
+    if (first_frame > 1) {
+      bok = traj_reader_->AdvanceFrames(master->top_, first_frame - 1);
+    }
+    while (bok && has_begin && (master->top_.getTime() < begin)) {
+      bok = traj_reader_->NextFrame(master->top_);
     }
     if (!bok) {  // trajectory was too short and we did not proceed to first
                  // frame
@@ -360,13 +454,33 @@ void CsgApplication::Run(void) {
       BeginEvaluate(&master->top_);
     }
 
-    is_first_frame_ = true;
+    // start reading the following frames in the background
+    Index read_ahead = OptionsMap()["read-ahead"].as<Index>();
+    if (read_ahead > 0) {
+      read_ahead_ = std::make_unique<TrajectoryReadAhead>(
+          *traj_reader_, master->top_, read_ahead,
+          (nframes_ < 0) ? -1 : nframes_ - 1);
+      read_ahead_->Start();
+    }
+
+    // the first frame is already read into the master, it gets index 0 before
+    // any other worker can take a frame
+    is_first_frame_ = (nframes_ != 0);
+    frames_read_ = 0;
+    next_merged_ = 0;
+    if (is_first_frame_) {
+      master->frame_ = frames_read_++;
+      nframes_--;
+    }
+    ordered_merge_ =
+        DoThreaded() && SynchronizeThreads() && master->CanDetachResult();
+    workers_running_ = Index(myWorkers_.size());
     /////////////////////////////////////////////////////////////////////////
     // start threads
     if (DoThreaded()) {
       for (size_t thread = 0; thread < myWorkers_.size(); thread++) {
 
-        if (SynchronizeThreads()) {
+        if (OrderedHandOff()) {
           threadsMutexesIn_.push_back(std::make_unique<tools::Mutex>());
           // lock each worker for input
           threadsMutexesIn_.back()->Lock();
@@ -380,11 +494,14 @@ void CsgApplication::Run(void) {
         myWorker_->Start();
       }
 
-      if (SynchronizeThreads()) {
+      if (OrderedHandOff()) {
         // unlock first thread and start ordered input/output
         threadsMutexesIn_[0]->Unlock();
         threadsMutexesOut_[0]->Unlock();
       }
+      if (ordered_merge_) {
+        MergeResultsInOrder();
+      }
       // mutex needed for merging if SynchronizeThreads()==False
       tools::Mutex mergeMutex;
       for (auto &myWorker : myWorkers_) {
@@ -401,6 +518,12 @@ void CsgApplication::Run(void) {
       master->WaitDone();
     }
 
+    if (read_ahead_) {
+      read_ahead_->Stop();
+      read_ahead_->WaitDone();
+      read_ahead_.reset();
+    }
+
     EndEvaluate();
 
     myWorkers_.clear();
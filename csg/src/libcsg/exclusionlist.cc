@@ -33,6 +33,8 @@ void ExclusionList::Clear(void) {
     delete exclusion_;
   }
   exclusions_.clear();
+  excl_by_bead_.clear();
+  DropLookupTable();
 }
 
 void ExclusionList::CreateExclusions(Topology *top) {
@@ -48,6 +50,37 @@ void ExclusionList::CreateExclusions(Topology *top) {
     }
     ExcludeList(l);
   }
+  BuildLookupTable();
+}
+
+void ExclusionList::BuildLookupTable() {
+  Index max_id = -1;
+  for (const exclusion_t *excl : exclusions_) {
+    max_id = std::max(max_id, excl->atom_->getId());
+  }
+
+  row_start_.assign(max_id + 2, 0);
+  for (const exclusion_t *excl : exclusions_) {
+    row_start_[excl->atom_->getId() + 1] = Index(excl->exclude_.size());
+  }
+  for (Index i = 1; i < Index(row_start_.size()); i++) {
+    row_start_[i] += row_start_[i - 1];
+  }
+
+  excluded_ids_.resize(row_start_.back());
+  for (const exclusion_t *excl : exclusions_) {
+    auto row = excluded_ids_.begin() + row_start_[excl->atom_->getId()];
+    auto row_end = row;
+    for (const Bead *bead : excl->exclude_) {
+      *row_end++ = bead->getId();
+    }
+    std::sort(row, row_end);
+  }
+}
+
+void ExclusionList::DropLookupTable() {
+  row_start_.clear();
+  excluded_ids_.clear();
 }
 
 const ExclusionList::exclusion_t *ExclusionList::GetExclusions(
@@ -78,6 +111,16 @@ bool ExclusionList::IsExcluded(Bead *bead1, Bead *bead2) const {
     swap(bead1, bead2);
   }
 
+  if (HasLookupTable()) {
+    Index id = bead1->getId();
+    if (id + 1 >= Index(row_start_.size())) {
+      return false;
+    }
+    return std::binary_search(excluded_ids_.begin() + row_start_[id],
+                              excluded_ids_.begin() + row_start_[id + 1],
+                              bead2->getId());
+  }
+
   const exclusion_t *excl = GetExclusions(bead1);
   if (excl != nullptr) {
     if (find(excl->exclude_.begin(), excl->exclude_.end(), bead2) !=
@@ -101,6 +144,7 @@ void ExclusionList::InsertExclusion(Bead *bead1, Bead *bead2) {
     return;
   }
 
+  DropLookupTable();
   exclusion_t *e;
   if ((e = GetExclusions(bead1)) == nullptr) {
     e = new exclusion_t;
@@ -123,6 +167,7 @@ void ExclusionList::RemoveExclusion(Bead *bead1, Bead *bead2) {
   if (!IsExcluded(bead1, bead2)) {
     return;
   }
+  DropLookupTable();
 
   std::list<exclusion_t *>::iterator ex =
       std::find_if(exclusions_.begin(), exclusions_.end(),
@@ -48,7 +48,6 @@ using namespace std;
 class Map_Sphere : public BeadMap {
  public:
   Map_Sphere() = default;
-  void Apply(const BoundaryCondition &) override;
 
   virtual void Initialize(const Molecule *in, Bead *out,
                           tools::Property *opts_bead,
@@ -56,13 +55,6 @@ class Map_Sphere : public BeadMap {
 
  protected:
   void AddElem(const Bead *in, double weight, double force_weight);
-
-  struct element_t {
-    const Bead *in_;
-    double weight_;
-    double force_weight_;
-  };
-  std::vector<element_t> matrix_;
 };
 
 void Map_Sphere::AddElem(const Bead *in, double weight, double force_weight) {
@@ -79,12 +71,12 @@ void Map_Sphere::AddElem(const Bead *in, double weight, double force_weight) {
 class Map_Ellipsoid : public Map_Sphere {
  public:
   Map_Ellipsoid() = default;
-  void Apply(const BoundaryCondition &) final;
+  void Apply() final;
 };
 
-void Map::Apply(const BoundaryCondition &bc) {
+void Map::Apply() {
   for (auto &map_ : maps_) {
-    map_->Apply(bc);
+    map_->Apply();
   }
 }
 
@@ -165,191 +157,29 @@ void Map_Sphere::Initialize(const Molecule *in, Bead *out, Property *opts_bead,
     }
     AddElem(in->getBead(iin), weights[i], fweights[i]);
   }
-}
-
-void Map_Sphere::Apply(const BoundaryCondition &bc) {
-
-  assert(matrix_.size() > 0 && "Cannot map to sphere there are no beads");
 
-  bool bPos, bVel, bF;
-  bPos = bVel = bF = false;
+  // the parent beads do not change from frame to frame
   out_->ClearParentBeads();
-
-  // the following is needed for pbc treatment
-  Eigen::Vector3d r0 = Eigen::Vector3d::Zero();
-  string name0;
-  Index id0 = 0;
-  if (matrix_.size() > 0) {
-    if (matrix_.front().in_->HasPos()) {
-      r0 = matrix_.front().in_->getPos();
-      name0 = matrix_.front().in_->getName();
-      id0 = matrix_.front().in_->getId();
-    }
-  }
-
-  double M = 0;
-  Eigen::Vector3d cg = Eigen::Vector3d::Zero();
-  Eigen::Vector3d f = Eigen::Vector3d::Zero();
-  Eigen::Vector3d vel = Eigen::Vector3d::Zero();
-
-  const Bead *bead_max_dist = matrix_.at(0).in_;
-  double max_bead_dist = 0;
-  if (bead_max_dist->HasPos()) {
-    max_bead_dist = bc.BCShortestConnection(r0, bead_max_dist->getPos()).norm();
-  }
-
-  for (const auto &iter : matrix_) {
-    const Bead *bead = iter.in_;
-    out_->AddParentBead(bead->getId());
-    M += bead->getMass();
-    if (bead->HasPos()) {
-      Eigen::Vector3d r = bc.BCShortestConnection(r0, bead->getPos());
-      if (r.norm() > max_bead_dist) {
-        max_bead_dist = r.norm();
-        bead_max_dist = bead;
-      }
-      cg += iter.weight_ * (r + r0);
-      bPos = true;
-    }
-  }
-
-  /// Safety check, if box is not open check if the bead is larger than the
-  /// boundaries
-  if (bc.getBoxType() != BoundaryCondition::eBoxtype::typeOpen) {
-    double max_dist = 0.5 * bc.getShortestBoxDimension();
-    if (max_bead_dist > max_dist) {
-      cout << r0 << " " << bead_max_dist->getPos() << endl;
-      throw std::runtime_error(
-          "coarse-grained bead is bigger than half the box \n "
-          "(atoms " +
-          name0 + " (id " + boost::lexical_cast<string>(id0 + 1) + ")" + ", " +
-          bead_max_dist->getName() + " (id " +
-          boost::lexical_cast<string>(bead_max_dist->getId() + 1) + ")" +
-          +" , molecule " +
-          boost::lexical_cast<string>(bead_max_dist->getMoleculeId() + 1) +
-          ")");
-    }
-  }
-
-  for (const auto &iter : matrix_) {
-    const Bead *bead = iter.in_;
-    if (bead->HasVel()) {
-      vel += iter.weight_ * bead->getVel();
-      bVel = true;
-    }
-    if (bead->HasF()) {
-      f += iter.force_weight_ * bead->getF();
-      bF = true;
-    }
-  }
-  out_->setMass(M);
-  if (bPos) {
-    out_->setPos(cg);
-  }
-  if (bVel) {
-    out_->setVel(vel);
-  }
-  if (bF) {
-    out_->setF(f);
+  for (const auto &el : matrix_) {
+    out_->AddParentBead(el.in_->getId());
   }
 }
 
 /// \todo implement this function
-void Map_Ellipsoid::Apply(const BoundaryCondition &bc) {
+void Map_Ellipsoid::Apply() {
 
   assert(matrix_.size() > 0 && "Cannot map to ellipsoid there are no beads");
 
-  bool bPos, bVel, bF;
-  bPos = bVel = bF = false;
-
-  // the following is needed for pbc treatment
-  Eigen::Vector3d r0 = Eigen::Vector3d::Zero();
-  string name0;
-  Index id0 = 0;
-  if (matrix_.size() > 0) {
-    if (matrix_.front().in_->HasPos()) {
-      r0 = matrix_.front().in_->getPos();
-      name0 = matrix_.front().in_->getName();
-      id0 = matrix_.front().in_->getId();
-    }
-  }
-  Eigen::Vector3d cg = Eigen::Vector3d::Zero();
+  // position, velocity and force were already mapped by TopologyMap
   Eigen::Vector3d c = Eigen::Vector3d::Zero();
-  Eigen::Vector3d f = Eigen::Vector3d::Zero();
-  Eigen::Vector3d vel = Eigen::Vector3d::Zero();
-
-  Index n;
-  n = 0;
-  out_->ClearParentBeads();
-
-  const Bead *bead_max_dist = matrix_.at(0).in_;
-  double max_bead_dist = 0;
-  if (bead_max_dist->HasPos()) {
-    max_bead_dist = bc.BCShortestConnection(r0, bead_max_dist->getPos()).norm();
-  }
-
+  Index n = 0;
   for (const auto &iter : matrix_) {
-    const Bead *bead = iter.in_;
-    out_->AddParentBead(bead->getId());
-    if (bead->HasPos()) {
-      Eigen::Vector3d r = bc.BCShortestConnection(r0, bead->getPos());
-      if (r.norm() > max_bead_dist) {
-        max_bead_dist = r.norm();
-        bead_max_dist = bead;
-      }
-      cg += iter.weight_ * (r + r0);
-      bPos = true;
-    }
-  }
-
-  /// Safety check, if box is not open check if the bead is larger than the
-  /// boundaries
-  if (bc.getBoxType() != BoundaryCondition::eBoxtype::typeOpen) {
-    double max_dist = 0.5 * bc.getShortestBoxDimension();
-    if (max_bead_dist > max_dist) {
-      cout << r0 << " " << bead_max_dist->getPos() << endl;
-      throw std::runtime_error(
-          "coarse-grained bead is bigger than half the box \n "
-          "(atoms " +
-          name0 + " (id " + boost::lexical_cast<string>(id0 + 1) + ")" + ", " +
-          bead_max_dist->getName() + " (id " +
-          boost::lexical_cast<string>(bead_max_dist->getId() + 1) + ")" +
-          +" , molecule " +
-          boost::lexical_cast<string>(bead_max_dist->getMoleculeId() + 1) +
-          ")");
-    }
-  }
-
-  for (const auto &iter : matrix_) {
-    const Bead *bead = iter.in_;
-    if (bead->HasVel() == true) {
-      vel += iter.weight_ * bead->getVel();
-      bVel = true;
-    }
-    if (bead->HasF()) {
-      /// \todo fix me, right calculation should be F_i = m_cg / sum(w_i) *
-      /// sum(w_i/m_i*F_i)
-      // f += (*iter). weight_ *  in_->getBeadF((*iter). in_);
-      f += iter.force_weight_ * bead->getF();
-      bF = true;
-    }
-
-    if (iter.weight_ > 0 && bead->HasPos()) {
-      c += bead->getPos();
+    if (iter.weight_ > 0 && iter.in_->HasPos()) {
+      c += iter.in_->getPos();
       n++;
     }
   }
 
-  if (bPos) {
-    out_->setPos(cg);
-  }
-  if (bVel) {
-    out_->setVel(vel);
-  }
-  if (bF) {
-    out_->setF(f);
-  }
-
   if (!matrix_[0].in_->HasPos()) {
     out_->setU(Eigen::Vector3d::UnitX());
     out_->setV(Eigen::Vector3d::UnitY());
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <iostream>
+#include <stdexcept>
+
+// VOTCA includes
+#include <votca/tools/table.h>
+
+// Local private VOTCA includes
+#include "cgmdtrajectoryreader.h"
+
+namespace votca {
+namespace csg {
+
+bool CGMDTrajectoryReader::Open(const std::string &file) {
+  fname_ = file;
+  options_ = tools::Property();
+  options_.LoadFromXML(file);
+  if (!options_.exists("cgmd")) {
+    throw std::runtime_error("cgmd settings file " + file +
+                             " has no cgmd section");
+  }
+  return true;
+}
+
+void CGMDTrajectoryReader::Close() { engine_.reset(); }
+
+void CGMDTrajectoryReader::ReadInitialConfiguration(const std::string &conf) {
+  std::unique_ptr<TrajectoryReader> reader = TrjReaderFactory().Create(conf);
+  if (reader == nullptr) {
+    throw std::runtime_error("cgmd: unknown file format of configuration " +
+                             conf);
+  }
+  if (!reader->Open(conf) || !reader->FirstFrame(md_top_)) {
+    throw std::runtime_error("cgmd: could not read configuration " + conf);
+  }
+  reader->Close();
+}
+
+bool CGMDTrajectoryReader::FirstFrame(Topology &top) {
+  const tools::Property &options = options_.get("cgmd");
+
+  md_top_.ShareTopologyData(top);
+  md_top_.setStep(0);
+  md_top_.setTime(0.0);
+  if (options.exists("conf")) {
+    ReadInitialConfiguration(options.get("conf").as<std::string>());
+  }
+
+  engine_ = std::make_unique<CGMDEngine>();
+  engine_->setTimeStep(options.get("dt").as<double>());
+  engine_->setKBT(options.get("kBT").as<double>());
+  engine_->setFriction(
+      options.ifExistsReturnElseReturnDefault<double>("friction", 1.0));
+  engine_->setSeed(options.ifExistsReturnElseReturnDefault<Index>("seed", 1));
+  engine_->setSkin(options.ifExistsReturnElseReturnDefault<double>("skin", 0.1));
+  for (const tools::Property *nb : options.Select("nonbonded")) {
+    tools::Table table;
+    table.Load(nb->get("table").as<std::string>());
+    engine_->AddNonbondedTable(nb->get("type1").as<std::string>(),
+                               nb->get("type2").as<std::string>(), table);
+  }
+
+  steps_ = options.get("steps").as<Index>();
+  output_steps_ = options.get("output_steps").as<Index>();
+  if (output_steps_ <= 0) {
+    throw std::runtime_error("cgmd: output_steps has to be positive");
+  }
+  steps_done_ = 0;
+
+  engine_->Initialize(md_top_);
+  std::cout << "cgmd: simulating " << steps_ << " steps of " << fname_
+            << ", one frame every " << output_steps_ << " steps" << std::endl;
+
+  top.CopyFrameData(md_top_);
+  return true;
+}
+
+bool CGMDTrajectoryReader::NextFrame(Topology &top) {
+  if (engine_ == nullptr || steps_done_ + output_steps_ > steps_) {
+    return false;
+  }
+  engine_->Integrate(output_steps_);
+  steps_done_ += output_steps_;
+  top.CopyFrameData(md_top_);
+  return true;
+}
+
+}  // namespace csg
+}  // namespace votca
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_CGMDTRAJECTORYREADER_PRIVATE_H
+#define VOTCA_CSG_CGMDTRAJECTORYREADER_PRIVATE_H
+
+// Standard includes
+#include <memory>
+#include <string>
+
+// VOTCA includes
+#include <votca/tools/property.h>
+
+// Local VOTCA includes
+#include "votca/csg/cgmdengine.h"
+#include "votca/csg/topology.h"
+#include "votca/csg/trajectoryreader.h"
+
+namespace votca {
+namespace csg {
+
+/**
+    \brief trajectory generated by a coarse-grained simulation in process
+
+    Instead of reading frames from a file, the frames are produced by a
+    CGMDEngine while they are analyzed, so e.g. csg_stat can sample the
+    distributions of an iterative method without a simulation program and
+    without writing a trajectory. The file given as trajectory holds the
+    settings of the simulation:
+
+    \code
+    <cgmd>
+      <conf>conf.gro</conf>          <!-- optional initial configuration -->
+      <steps>100000</steps>          <!-- total number of steps -->
+      <output_steps>100</output_steps> <!-- steps between two frames -->
+      <dt>0.002</dt>                 <!-- time step in ps -->
+      <kBT>2.494339</kBT>            <!-- thermal energy in kJ/mol -->
+      <friction>1.0</friction>       <!-- Langevin friction in 1/ps -->
+      <seed>1</seed>
+      <skin>0.1</skin>               <!-- Verlet skin in nm -->
+      <nonbonded>                    <!-- one per pair of bead types -->
+        <type1>A</type1>
+        <type2>B</type2>
+        <table>A-B.pot</table>       <!-- potential in kJ/mol vs. nm -->
+      </nonbonded>
+    </cgmd>
+    \endcode
+
+    Without a conf, the simulation starts from the positions of the topology.
+    The simulation runs on an own copy of the topology, so the frames can be
+    handed to different topologies with the same beads.
+*/
+class CGMDTrajectoryReader : public TrajectoryReader {
+ public:
+  bool Open(const std::string &file) override;
+  void Close() override;
+
+  bool FirstFrame(Topology &top) override;
+  bool NextFrame(Topology &top) override;
+
+ private:
+  void ReadInitialConfiguration(const std::string &conf);
+
+  std::string fname_;
+  tools::Property options_;
+
+  Topology md_top_;
+  std::unique_ptr<CGMDEngine> engine_;
+  Index steps_ = 0;
+  Index output_steps_ = 1;
+  Index steps_done_ = 0;
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_CGMDTRAJECTORYREADER_PRIVATE_H
@@ -229,6 +229,23 @@ void H5MDTrajectoryReader::Initialize(Topology &top) {
     cout << "The number of beads from topology will be used!" << endl;
     N_particles_ = top.BeadCount();
   }
+  if (N_particles_ > Index(dims[1])) {
+    throw std::runtime_error("The topology has more beads than the H5MD file.");
+  }
+
+  InitFrameBuffer(positions_, ds_atom_position_, H5T_NATIVE_DOUBLE);
+  if (has_velocity_ != H5MDTrajectoryReader::NONE) {
+    InitFrameBuffer(velocities_, ds_atom_velocity_, H5T_NATIVE_DOUBLE);
+  }
+  if (has_force_ != H5MDTrajectoryReader::NONE) {
+    InitFrameBuffer(forces_, ds_atom_force_, H5T_NATIVE_DOUBLE);
+  }
+  if (has_id_group_ != H5MDTrajectoryReader::NONE) {
+    InitFrameBuffer(ids_, ds_atom_id_, H5T_NATIVE_INT);
+  }
+  if (has_box_ == H5MDTrajectoryReader::TIMEDEPENDENT) {
+    InitFrameBuffer(box_edges_, ds_edges_group_, H5T_NATIVE_DOUBLE);
+  }
 }
 
 bool H5MDTrajectoryReader::FirstFrame(Topology &top) {  // NOLINT const
@@ -254,41 +271,39 @@ bool H5MDTrajectoryReader::NextFrame(Topology &top) {  // NOLINT const reference
   // Set volume of box because top on workers somehow does not have this
   // information.
   if (has_box_ == H5MDTrajectoryReader::TIMEDEPENDENT) {
-    std::unique_ptr<double[]> box = std::unique_ptr<double[]>{new double[3]};
-    ReadBox(ds_edges_group_, H5T_NATIVE_DOUBLE, idx_frame_, box);
+    const double *box = ReadFrame(box_edges_, idx_frame_);
     m = Eigen::Matrix3d::Zero();
-    m(0, 0) = box.get()[0] * length_scaling_;
-    m(1, 1) = box.get()[1] * length_scaling_;
-    m(2, 2) = box.get()[2] * length_scaling_;
+    m(0, 0) = box[0] * length_scaling_;
+    m(1, 1) = box[1] * length_scaling_;
+    m(2, 2) = box[2] * length_scaling_;
     cout << "Time dependent box:" << endl;
     cout << m << endl;
   }
   top.setBox(m);
 
-  double *positions;
-  double *forces = nullptr;
-  double *velocities = nullptr;
-  int *ids = nullptr;
+  // The pointers refer to the buffers of the datasets, which hold the
+  // current block of frames.
+  const double *positions;
+  const double *forces = nullptr;
+  const double *velocities = nullptr;
+  const int *ids = nullptr;
 
   try {
-    positions = ReadVectorData<double>(ds_atom_position_, H5T_NATIVE_DOUBLE,
-                                       idx_frame_);
+    positions = ReadFrame(positions_, idx_frame_);
   } catch (const std::runtime_error &e) {
     return false;
   }
 
   if (has_velocity_ != H5MDTrajectoryReader::NONE) {
-    velocities = ReadVectorData<double>(ds_atom_velocity_, H5T_NATIVE_DOUBLE,
-                                        idx_frame_);
+    velocities = ReadFrame(velocities_, idx_frame_);
   }
 
   if (has_force_ != H5MDTrajectoryReader::NONE) {
-    forces =
-        ReadVectorData<double>(ds_atom_force_, H5T_NATIVE_DOUBLE, idx_frame_);
+    forces = ReadFrame(forces_, idx_frame_);
   }
 
   if (has_id_group_ != H5MDTrajectoryReader::NONE) {
-    ids = ReadScalarData<int>(ds_atom_id_, H5T_NATIVE_INT, idx_frame_);
+    ids = ReadFrame(ids_, idx_frame_);
   }
 
   // Process atoms.
@@ -333,38 +348,17 @@ bool H5MDTrajectoryReader::NextFrame(Topology &top) {  // NOLINT const reference
     }
   }
 
-  // Clean up pointers.
-  delete[] positions;
-  if (has_force_ == H5MDTrajectoryReader::TIMEDEPENDENT) {
-    delete[] forces;
-  }
-  if (has_velocity_ == H5MDTrajectoryReader::TIMEDEPENDENT) {
-    delete[] velocities;
-  }
-  if (has_id_group_ == H5MDTrajectoryReader::TIMEDEPENDENT) {
-    delete[] ids;
-  }
-
   return true;
 }
 
-void H5MDTrajectoryReader::ReadBox(hid_t ds, hid_t ds_data_type, Index row,
-                                   std::unique_ptr<double[]> &data_out) {
-  hsize_t offset[2];
-  offset[0] = row;
-  offset[1] = 0;
-  hsize_t ch_rows[2];
-  ch_rows[0] = 1;
-  ch_rows[1] = 3;
-  hid_t dsp = H5Dget_space(ds);
-  H5Sselect_hyperslab(dsp, H5S_SELECT_SET, offset, nullptr, ch_rows, nullptr);
-  hid_t mspace1 = H5Screate_simple(2, ch_rows, nullptr);
-  herr_t status =
-      H5Dread(ds, ds_data_type, mspace1, dsp, H5P_DEFAULT, data_out.get());
-  if (status < 0) {
-    throw std::runtime_error("Error ReadScalarData: " +
-                             boost::lexical_cast<std::string>(status));
+bool H5MDTrajectoryReader::AdvanceFrames(Topology &top, Index nframes) {
+  if (nframes < 1) {
+    return true;
   }
+  // skip the frames in between, only the blocks containing the target frame
+  // are read
+  idx_frame_ += nframes - 1;
+  return NextFrame(top);
 }
 
 double H5MDTrajectoryReader::ReadScaleFactor(const hid_t &ds,
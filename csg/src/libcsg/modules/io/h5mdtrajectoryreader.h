@@ -19,10 +19,12 @@
 #define VOTCA_CSG_H5MDTRAJECTORYREADER_PRIVATE_H
 
 // Standard includes
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Third party includes
 #include <hdf5.h>
@@ -62,59 +64,120 @@ class H5MDTrajectoryReader : public TrajectoryReader {
   /// Reads in the next frame.
   bool NextFrame(Topology &conf) override;
 
+  /// Jumps nframes frames ahead, the frames in between are not read.
+  bool AdvanceFrames(Topology &conf, Index nframes) override;
+
   /// Closes original trajectory file.
   void Close() override;
 
  private:
   enum DatasetState { NONE, STATIC, TIMEDEPENDENT };
 
-  /// Reads dataset that contains vectors.
+  /**
+   * \brief frames of a time dependent dataset
+   *
+   * The frames are read in blocks, which cover whole chunks of the dataset,
+   * so every chunk is read and decompressed only once. The buffer is reused
+   * for all blocks.
+   */
+  template <typename T1>
+  struct FrameBuffer {
+    hid_t ds = -1;
+    hid_t mem_type = -1;
+    /// number of values per frame
+    Index frame_size = 0;
+    /// number of frames in the dataset
+    Index n_frames = 0;
+    /// number of frames read at once, the chunk size along the frames
+    Index block_frames = 1;
+    /// first frame and number of frames in data
+    Index first = 0;
+    Index count = 0;
+    std::vector<T1> data;
+  };
+
   template <typename T1>
-  T1 *ReadVectorData(hid_t ds, hid_t ds_data_type, Index row) {
-    hsize_t offset[3];
-    offset[0] = hsize_t(row);
-    offset[1] = 0;
-    offset[2] = 0;
-    hsize_t chunk_rows[3];
-    chunk_rows[0] = 1;
-    chunk_rows[1] = N_particles_;
-    chunk_rows[2] = vec_components_;
+  void InitFrameBuffer(FrameBuffer<T1> &buffer, hid_t ds, hid_t mem_type) {
+    buffer.ds = ds;
+    buffer.mem_type = mem_type;
+    buffer.first = 0;
+    buffer.count = 0;
     hid_t dsp = H5Dget_space(ds);
-    H5Sselect_hyperslab(dsp, H5S_SELECT_SET, offset, nullptr, chunk_rows,
-                        nullptr);
-    hid_t mspace1 = H5Screate_simple(vec_components_, chunk_rows, nullptr);
-    T1 *data_out = new T1[N_particles_ * vec_components_];
-    herr_t status =
-        H5Dread(ds, ds_data_type, mspace1, dsp, H5P_DEFAULT, data_out);
-    if (status < 0) {
-      throw std::runtime_error("Error ReadVectorData: " +
-                               boost::lexical_cast<std::string>(status));
-    } else {
-      return data_out;
+    CheckError(dsp, "Unable to open dataspace.");
+    int rank = H5Sget_simple_extent_ndims(dsp);
+    std::vector<hsize_t> dims(rank);
+    H5Sget_simple_extent_dims(dsp, dims.data(), nullptr);
+    H5Sclose(dsp);
+    buffer.n_frames = Index(dims[0]);
+    buffer.frame_size = 1;
+    for (int i = 1; i < rank; ++i) {
+      buffer.frame_size *= Index(dims[i]);
+    }
+
+    // the datasets are read in blocks of a few MB, for chunked datasets the
+    // blocks are a multiple of the chunk length if a chunk fits, otherwise
+    // they divide the chunk if possible, so no block spans two chunks
+    hsize_t frame_bytes = hsize_t(buffer.frame_size) * sizeof(T1);
+    buffer.block_frames = std::max(Index(1), Index((4 << 20) / frame_bytes));
+    hid_t dcpl = H5Dget_create_plist(ds);
+    if (H5Pget_layout(dcpl) == H5D_CHUNKED) {
+      std::vector<hsize_t> chunk_dims(rank);
+      H5Pget_chunk(dcpl, rank, chunk_dims.data());
+      Index chunk_frames = Index(chunk_dims[0]);
+      if (chunk_frames > 0 && chunk_frames <= buffer.block_frames) {
+        buffer.block_frames =
+            (buffer.block_frames / chunk_frames) * chunk_frames;
+      } else if (chunk_frames > 0) {
+        Index divisor = buffer.block_frames;
+        while (chunk_frames % divisor != 0) {
+          --divisor;
+        }
+        // blocks of a few frames would read the same chunk too often
+        if (2 * divisor >= buffer.block_frames) {
+          buffer.block_frames = divisor;
+        }
+      }
     }
+    H5Pclose(dcpl);
+    buffer.block_frames = std::min(buffer.block_frames, buffer.n_frames);
+    buffer.data.clear();
   }
 
-  /// Reads dataset with scalar values.
+  /// Returns the values of frame, reads the block containing it if needed.
   template <typename T1>
-  T1 *ReadScalarData(hid_t ds, hid_t ds_data_type, Index row) {
-    hsize_t offset[2];
-    offset[0] = row;
-    offset[1] = 0;
-    hsize_t ch_rows[2];
-    ch_rows[0] = 1;
-    ch_rows[1] = N_particles_;
-    hid_t dsp = H5Dget_space(ds);
-    H5Sselect_hyperslab(dsp, H5S_SELECT_SET, offset, nullptr, ch_rows, nullptr);
-    hid_t mspace1 = H5Screate_simple(2, ch_rows, nullptr);
-    T1 *data_out = new T1[N_particles_];
-    herr_t status =
-        H5Dread(ds, ds_data_type, mspace1, dsp, H5P_DEFAULT, data_out);
-    if (status < 0) {
-      throw std::runtime_error("Error ReadScalarData: " +
-                               boost::lexical_cast<std::string>(status));
-    } else {
-      return data_out;
+  const T1 *ReadFrame(FrameBuffer<T1> &buffer, Index frame) {
+    if (frame < 0 || frame >= buffer.n_frames) {
+      throw std::runtime_error("Error ReadFrame: frame " +
+                               boost::lexical_cast<std::string>(frame) +
+                               " is not in the dataset");
     }
+    if (frame < buffer.first || frame >= buffer.first + buffer.count) {
+      buffer.first = (frame / buffer.block_frames) * buffer.block_frames;
+      buffer.count =
+          std::min(buffer.block_frames, buffer.n_frames - buffer.first);
+      buffer.data.resize(buffer.block_frames * buffer.frame_size);
+
+      hid_t dsp = H5Dget_space(buffer.ds);
+      int rank = H5Sget_simple_extent_ndims(dsp);
+      std::vector<hsize_t> offset(rank, 0);
+      std::vector<hsize_t> block(rank);
+      H5Sget_simple_extent_dims(dsp, block.data(), nullptr);
+      offset[0] = hsize_t(buffer.first);
+      block[0] = hsize_t(buffer.count);
+      H5Sselect_hyperslab(dsp, H5S_SELECT_SET, offset.data(), nullptr,
+                          block.data(), nullptr);
+      hid_t mspace = H5Screate_simple(rank, block.data(), nullptr);
+      herr_t status = H5Dread(buffer.ds, buffer.mem_type, mspace, dsp,
+                              H5P_DEFAULT, buffer.data.data());
+      H5Sclose(mspace);
+      H5Sclose(dsp);
+      if (status < 0) {
+        buffer.count = 0;
+        throw std::runtime_error("Error ReadFrame: " +
+                                 boost::lexical_cast<std::string>(status));
+      }
+    }
+    return buffer.data.data() + (frame - buffer.first) * buffer.frame_size;
   }
 
   template <typename T1>
@@ -127,9 +190,6 @@ class H5MDTrajectoryReader : public TrajectoryReader {
     }
   }
 
-  void ReadBox(hid_t ds, hid_t ds_data_type, Index row,
-               std::unique_ptr<double[]> &data_out);
-
   double ReadScaleFactor(const hid_t &ds, const std::string &unit_type);
 
   void CheckError(hid_t hid, std::string error_message) {
@@ -167,6 +227,12 @@ class H5MDTrajectoryReader : public TrajectoryReader {
   std::string fname_;
   bool first_frame_;
 
+  FrameBuffer<double> positions_;
+  FrameBuffer<double> velocities_;
+  FrameBuffer<double> forces_;
+  FrameBuffer<int> ids_;
+  FrameBuffer<double> box_edges_;
+
   // Flags about datasets.
   DatasetState has_velocity_;
   DatasetState has_force_;
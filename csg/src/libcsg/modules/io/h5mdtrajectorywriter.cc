@@ -0,0 +1,341 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Third party includes
+#include <hdf5.h>
+
+// Local VOTCA includes
+#include "votca/csg/bead.h"
+#include "votca/csg/version.h"
+
+// Local private VOTCA includes
+#include "h5mdtrajectorywriter.h"
+
+namespace votca {
+namespace csg {
+
+using namespace std;
+
+namespace {
+// chunks of about this size are a good compromise between the overhead of
+// many small chunks and reading more than needed for single frames
+const hsize_t target_chunk_bytes = 256 * 1024;
+const hsize_t max_chunk_frames = 1024;
+}  // namespace
+
+H5MDTrajectoryWriter::~H5MDTrajectoryWriter() { Close(); }
+
+void H5MDTrajectoryWriter::Open(std::string file, bool bAppend) {
+  if (bAppend) {
+    throw runtime_error("H5MD writer: appending to " + file +
+                        " is not supported");
+  }
+  if (compression_ < 0 || compression_ > 9) {
+    throw runtime_error("H5MD writer: compression level has to be in 0..9");
+  }
+  if (compression_ > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+    throw runtime_error("H5MD writer: HDF5 was built without deflate filter");
+  }
+  file_id_ = H5Fcreate(file.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(file_id_, "H5MD writer: unable to create " + file);
+  n_frames_ = 0;
+
+  // Metadata required by the H5MD specification.
+  hid_t g_h5md = H5Gcreate(file_id_, "h5md", H5P_DEFAULT, H5P_DEFAULT,
+                           H5P_DEFAULT);
+  CheckError(g_h5md, "H5MD writer: unable to create /h5md group");
+  int version[2] = {1, 1};
+  hsize_t version_dims[1] = {2};
+  hid_t version_space = H5Screate_simple(1, version_dims, nullptr);
+  hid_t at_version = H5Acreate(g_h5md, "version", H5T_NATIVE_INT,
+                               version_space, H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(H5Awrite(at_version, H5T_NATIVE_INT, version),
+             "H5MD writer: unable to write version");
+  H5Aclose(at_version);
+  H5Sclose(version_space);
+
+  hid_t g_author =
+      H5Gcreate(g_h5md, "author", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  WriteStringAttribute(g_author, "name", {"unknown"});
+  H5Gclose(g_author);
+  hid_t g_creator =
+      H5Gcreate(g_h5md, "creator", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  WriteStringAttribute(g_creator, "name", {"VOTCA"});
+  WriteStringAttribute(g_creator, "version", {CsgVersionStr()});
+  H5Gclose(g_creator);
+  H5Gclose(g_h5md);
+}
+
+void H5MDTrajectoryWriter::Close() {
+  if (file_id_ < 0) {
+    return;
+  }
+  CloseElement(position_);
+  CloseElement(velocity_);
+  CloseElement(force_);
+  CloseElement(box_edges_);
+  if (box_group_ >= 0) {
+    H5Gclose(box_group_);
+    box_group_ = -1;
+  }
+  if (particle_group_ >= 0) {
+    H5Gclose(particle_group_);
+    particle_group_ = -1;
+  }
+  H5Fclose(file_id_);
+  file_id_ = -1;
+}
+
+void H5MDTrajectoryWriter::Initialize(Topology &top) {
+  N_particles_ = top.BeadCount();
+  if (N_particles_ == 0) {
+    throw runtime_error("H5MD writer: topology contains no beads");
+  }
+  has_velocity_ = top.HasVel();
+  has_force_ = top.HasForce();
+
+  std::string group_name = top.getParticleGroup();
+  if (group_name == "unassigned") {
+    group_name = "all";
+  }
+  hid_t particles =
+      H5Gcreate(file_id_, "particles", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(particles, "H5MD writer: unable to create /particles group");
+  particle_group_ = H5Gcreate(particles, group_name.c_str(), H5P_DEFAULT,
+                              H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(particle_group_,
+             "H5MD writer: unable to create particle group " + group_name);
+  H5Gclose(particles);
+
+  const hsize_t value_bytes = single_precision_ ? sizeof(float)
+                                                : sizeof(double);
+  const hsize_t frame_bytes = hsize_t(N_particles_) * 3 * value_bytes;
+  chunk_frames_ = std::clamp(target_chunk_bytes / frame_bytes, hsize_t(1),
+                             max_chunk_frames);
+
+  const std::vector<hsize_t> vector_dims = {hsize_t(N_particles_), 3};
+  CreateElement(position_, particle_group_, "position", vector_dims);
+  if (has_velocity_) {
+    CreateElement(velocity_, particle_group_, "velocity", vector_dims);
+  }
+  if (has_force_) {
+    CreateElement(force_, particle_group_, "force", vector_dims);
+  }
+
+  box_group_ = H5Gcreate(particle_group_, "box", H5P_DEFAULT, H5P_DEFAULT,
+                         H5P_DEFAULT);
+  CheckError(box_group_, "H5MD writer: unable to create box group");
+  int dimension = 3;
+  hid_t scalar_space = H5Screate(H5S_SCALAR);
+  hid_t at_dimension = H5Acreate(box_group_, "dimension", H5T_NATIVE_INT,
+                                 scalar_space, H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(H5Awrite(at_dimension, H5T_NATIVE_INT, &dimension),
+             "H5MD writer: unable to write box dimension");
+  H5Aclose(at_dimension);
+  H5Sclose(scalar_space);
+  const std::string boundary =
+      (top.getBoxType() == BoundaryCondition::typeOpen) ? "none" : "periodic";
+  WriteStringAttribute(box_group_, "boundary", {boundary, boundary, boundary});
+  CreateElement(box_edges_, box_group_, "edges", {3});
+}
+
+void H5MDTrajectoryWriter::CreateElement(
+    Element &element, hid_t parent, const std::string &name,
+    const std::vector<hsize_t> &frame_dims) {
+  element.group = H5Gcreate(parent, name.c_str(), H5P_DEFAULT, H5P_DEFAULT,
+                            H5P_DEFAULT);
+  CheckError(element.group, "H5MD writer: unable to create group " + name);
+  element.value = CreateDataset(
+      element.group, "value",
+      single_precision_ ? H5T_IEEE_F32LE : H5T_IEEE_F64LE, frame_dims);
+  element.step = CreateDataset(element.group, "step", H5T_STD_I64LE, {});
+  element.time = CreateDataset(element.group, "time", H5T_IEEE_F64LE, {});
+}
+
+hid_t H5MDTrajectoryWriter::CreateDataset(
+    hid_t group, const std::string &name, hid_t type,
+    const std::vector<hsize_t> &frame_dims) {
+  // the first dimension are the frames, which are appended one by one
+  std::vector<hsize_t> dims = {0};
+  std::vector<hsize_t> max_dims = {H5S_UNLIMITED};
+  std::vector<hsize_t> chunk_dims = {chunk_frames_};
+  for (hsize_t d : frame_dims) {
+    dims.push_back(d);
+    max_dims.push_back(d);
+    chunk_dims.push_back(d);
+  }
+  hid_t space =
+      H5Screate_simple(int(dims.size()), dims.data(), max_dims.data());
+
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl, int(chunk_dims.size()), chunk_dims.data());
+  if (compression_ > 0) {
+    // shuffling the bytes groups the exponents of neighbouring values,
+    // which then compress a lot better
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, unsigned(compression_));
+  }
+  // keep a few chunks in the cache, so a chunk is only compressed and written
+  // once all its frames are there
+  hsize_t chunk_bytes = H5Tget_size(type);
+  for (hsize_t d : chunk_dims) {
+    chunk_bytes *= d;
+  }
+  hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  H5Pset_chunk_cache(dapl, 521, std::max(4 * chunk_bytes, hsize_t(1 << 20)),
+                     1.0);
+
+  hid_t ds = H5Dcreate(group, name.c_str(), type, space, H5P_DEFAULT, dcpl,
+                       dapl);
+  CheckError(ds, "H5MD writer: unable to create dataset " + name);
+  H5Pclose(dapl);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  return ds;
+}
+
+void H5MDTrajectoryWriter::Write(Topology *conf) {
+  if (file_id_ < 0) {
+    throw runtime_error("H5MD writer: no file opened");
+  }
+  if (n_frames_ == 0) {
+    Initialize(*conf);
+  } else if (conf->BeadCount() != N_particles_) {
+    throw runtime_error("H5MD writer: the number of beads changed from " +
+                        std::to_string(N_particles_) + " to " +
+                        std::to_string(conf->BeadCount()));
+  }
+
+  const Eigen::Matrix3d &box = conf->getBox();
+  if (!box.isDiagonal()) {
+    throw runtime_error("H5MD writer: only rectangular boxes are supported");
+  }
+
+  buffer_.resize(3 * N_particles_);
+  Eigen::Map<Eigen::Matrix3Xd> values(buffer_.data(), 3, N_particles_);
+  for (Index i = 0; i < N_particles_; ++i) {
+    values.col(i) = conf->getBead(i)->getPos();
+  }
+  AppendFrame(position_, buffer_.data(), *conf);
+  if (has_velocity_) {
+    for (Index i = 0; i < N_particles_; ++i) {
+      values.col(i) = conf->getBead(i)->getVel();
+    }
+    AppendFrame(velocity_, buffer_.data(), *conf);
+  }
+  if (has_force_) {
+    for (Index i = 0; i < N_particles_; ++i) {
+      values.col(i) = conf->getBead(i)->getF();
+    }
+    AppendFrame(force_, buffer_.data(), *conf);
+  }
+  Eigen::Vector3d edges = box.diagonal();
+  AppendFrame(box_edges_, edges.data(), *conf);
+
+  ++n_frames_;
+}
+
+void H5MDTrajectoryWriter::AppendFrame(const Element &element,
+                                       const double *data,
+                                       const Topology &top) {
+  AppendToDataset(element.value, H5T_NATIVE_DOUBLE, data);
+  std::int64_t step = top.getStep();
+  AppendToDataset(element.step, H5T_NATIVE_INT64, &step);
+  double time = top.getTime();
+  AppendToDataset(element.time, H5T_NATIVE_DOUBLE, &time);
+}
+
+void H5MDTrajectoryWriter::AppendToDataset(hid_t ds, hid_t mem_type,
+                                           const void *data) {
+  hid_t space = H5Dget_space(ds);
+  int rank = H5Sget_simple_extent_ndims(space);
+  std::vector<hsize_t> dims(rank);
+  H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+  H5Sclose(space);
+
+  // extend by one frame and write into the new frame
+  std::vector<hsize_t> offset(rank, 0);
+  offset[0] = dims[0];
+  dims[0] += 1;
+  CheckError(H5Dset_extent(ds, dims.data()),
+             "H5MD writer: unable to extend dataset");
+  std::vector<hsize_t> count = dims;
+  count[0] = 1;
+  space = H5Dget_space(ds);
+  H5Sselect_hyperslab(space, H5S_SELECT_SET, offset.data(), nullptr,
+                      count.data(), nullptr);
+  hid_t mspace = H5Screate_simple(rank, count.data(), nullptr);
+  herr_t status = H5Dwrite(ds, mem_type, mspace, space, H5P_DEFAULT, data);
+  H5Sclose(mspace);
+  H5Sclose(space);
+  CheckError(status, "H5MD writer: unable to write frame");
+}
+
+void H5MDTrajectoryWriter::CloseElement(Element &element) {
+  for (hid_t *ds : {&element.value, &element.step, &element.time}) {
+    if (*ds >= 0) {
+      H5Dclose(*ds);
+      *ds = -1;
+    }
+  }
+  if (element.group >= 0) {
+    H5Gclose(element.group);
+    element.group = -1;
+  }
+}
+
+void H5MDTrajectoryWriter::WriteStringAttribute(
+    hid_t location, const std::string &name,
+    const std::vector<std::string> &values) {
+  size_t length = 1;
+  for (const auto &value : values) {
+    length = std::max(length, value.size() + 1);
+  }
+  // fixed length, null terminated strings
+  std::vector<char> data(length * values.size(), '\0');
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::memcpy(data.data() + i * length, values[i].data(), values[i].size());
+  }
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, length);
+  H5Tset_strpad(type, H5T_STR_NULLTERM);
+  hid_t space;
+  if (values.size() == 1) {
+    space = H5Screate(H5S_SCALAR);
+  } else {
+    hsize_t dims[1] = {values.size()};
+    space = H5Screate_simple(1, dims, nullptr);
+  }
+  hid_t attr =
+      H5Acreate(location, name.c_str(), type, space, H5P_DEFAULT, H5P_DEFAULT);
+  CheckError(H5Awrite(attr, type, data.data()),
+             "H5MD writer: unable to write attribute " + name);
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+}  // namespace csg
+}  // namespace votca
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VOTCA_CSG_H5MDTRAJECTORYWRITER_PRIVATE_H
+#define VOTCA_CSG_H5MDTRAJECTORYWRITER_PRIVATE_H
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// Third party includes
+#include <hdf5.h>
+
+// Local VOTCA includes
+#include "votca/csg/topology.h"
+#include "votca/csg/trajectorywriter.h"
+
+namespace votca {
+namespace csg {
+
+/**
+    \brief class for writing H5MD trajectories.
+
+    Positions, velocities, forces and the box edges are stored as time
+   dependent elements of a single particle group, in the layout read by
+   H5MDTrajectoryReader. The name of the particle group is taken from the
+   topology, "all" is used if it is not set. All datasets are chunked along
+   the frames, they can be compressed losslessly (shuffle and deflate) and
+   stored in single precision. Lengths are in nm, as used by VOTCA internally.
+*/
+class H5MDTrajectoryWriter : public TrajectoryWriter {
+ public:
+  ~H5MDTrajectoryWriter() override;
+
+  void Open(std::string file, bool bAppend = false) override;
+  void Close() override;
+
+  void Write(Topology *conf) override;
+
+  void setSinglePrecision(bool single_precision) override {
+    single_precision_ = single_precision;
+  }
+  void setCompressionLevel(Index level) override { compression_ = level; }
+
+ private:
+  /// time dependent element of the particle group, i.e. value, step and time
+  struct Element {
+    hid_t group = -1;
+    hid_t value = -1;
+    hid_t step = -1;
+    hid_t time = -1;
+  };
+
+  /// creates the file structure at the first frame
+  void Initialize(Topology &top);
+  void CreateElement(Element &element, hid_t parent, const std::string &name,
+                     const std::vector<hsize_t> &frame_dims);
+  hid_t CreateDataset(hid_t group, const std::string &name, hid_t type,
+                      const std::vector<hsize_t> &frame_dims);
+  void AppendFrame(const Element &element, const double *data,
+                   const Topology &top);
+  void AppendToDataset(hid_t ds, hid_t mem_type, const void *data);
+  void CloseElement(Element &element);
+
+  void WriteStringAttribute(hid_t location, const std::string &name,
+                            const std::vector<std::string> &values);
+
+  void CheckError(hid_t hid, const std::string &error_message) {
+    if (hid < 0) {
+      throw std::runtime_error(error_message);
+    }
+  }
+
+  hid_t file_id_ = -1;
+  hid_t particle_group_ = -1;
+  hid_t box_group_ = -1;
+
+  Element position_;
+  Element velocity_;
+  Element force_;
+  Element box_edges_;
+
+  bool has_velocity_ = false;
+  bool has_force_ = false;
+
+  Index N_particles_ = 0;
+  Index n_frames_ = 0;
+  /// number of frames stored in one chunk of a dataset
+  hsize_t chunk_frames_ = 1;
+
+  bool single_precision_ = false;
+  /// deflate level, 0 means no compression
+  Index compression_ = 0;
+
+  /// buffer to gather the vectors of all beads
+  std::vector<double> buffer_;
+};
+
+}  // namespace csg
+}  // namespace votca
+
+#endif  // VOTCA_CSG_H5MDTRAJECTORYWRITER_PRIVATE_H
@@ -16,16 +16,26 @@
  */
 
 // Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
 #include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 // Third party includes
-#include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
 // VOTCA includes
 #include <votca/tools/constants.h>
-#include <votca/tools/getline.h>
+#include <votca/tools/tokenizer.h>
 
 // Local private VOTCA includes
 #include "lammpsdumpreader.h"
@@ -35,33 +45,178 @@ namespace csg {
 using namespace boost;
 using namespace std;
 
+namespace {
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// get the next white space separated field of [begin, end)
+bool NextField(const char *&begin, const char *end, const char *&field_end) {
+  while (begin != end && IsSpace(*begin)) {
+    ++begin;
+  }
+  field_end = begin;
+  while (field_end != end && !IsSpace(*field_end)) {
+    ++field_end;
+  }
+  return begin != end;
+}
+
+// copy a field into a terminated buffer on the stack, the mapped file is not
+// terminated
+template <typename T, typename Convert>
+T ParseNumber(const char *begin, const char *end, Convert convert) {
+  char buffer[64];
+  std::size_t n = std::size_t(end - begin);
+  if (n == 0 || n >= sizeof(buffer)) {
+    throw std::invalid_argument("invalid number in lammps file: " +
+                                string(begin, end));
+  }
+  std::memcpy(buffer, begin, n);
+  buffer[n] = '\0';
+  char *stop = nullptr;
+  T value = convert(buffer, &stop);
+  if (stop != buffer + n) {
+    throw std::invalid_argument("invalid number in lammps file: " +
+                                string(begin, end));
+  }
+  return value;
+}
+
+double ToDouble(const char *begin, const char *end) {
+  return ParseNumber<double>(begin, end, [](const char *str, char **stop) {
+    return std::strtod(str, stop);
+  });
+}
+
+Index ToIndex(const char *begin, const char *end) {
+  return ParseNumber<Index>(begin, end, [](const char *str, char **stop) {
+    return Index(std::strtoll(str, stop, 10));
+  });
+}
+
+}  // namespace
+
 bool LAMMPSDumpReader::ReadTopology(string file, Topology &top) {
   topology_ = true;
   top.Cleanup();
 
-  fl_.open(file);
-  if (!fl_.is_open()) {
-    throw std::ios_base::failure("Error on open topology file: " + file);
-  }
-  fname_ = file;
+  Map(file, "topology");
 
   NextFrame(top);
 
-  fl_.close();
+  Unmap();
 
   return true;
 }
 
 bool LAMMPSDumpReader::Open(const string &file) {
-  fl_.open(file);
-  if (!fl_.is_open()) {
-    throw std::ios_base::failure("Error on open trajectory file: " + file);
+  Map(file, "trajectory");
+  return true;
+}
+
+void LAMMPSDumpReader::Close() { Unmap(); }
+
+void LAMMPSDumpReader::Map(const string &file, const string &what) {
+  Unmap();
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::ios_base::failure("Error on open " + what + " file: " + file);
   }
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::ios_base::failure("Error on open " + what + " file: " + file);
+  }
+  size_ = std::size_t(info.st_size);
+  if (size_ > 0) {
+    void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      size_ = 0;
+      throw std::ios_base::failure("Error on mapping " + what +
+                                   " file: " + file);
+    }
+    data_ = static_cast<const char *>(data);
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+  }
+  // the mapping stays valid after closing the file
+  ::close(fd);
   fname_ = file;
+  pos_ = 0;
+  next_frame_ = 0;
+  frames_.clear();
+  indexed_ = false;
+}
+
+void LAMMPSDumpReader::Unmap() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  pos_ = 0;
+}
+
+bool LAMMPSDumpReader::GetLine(const char *&begin, const char *&end) {
+  if (pos_ >= size_) {
+    return false;
+  }
+  begin = data_ + pos_;
+  const char *newline =
+      static_cast<const char *>(std::memchr(begin, '\n', size_ - pos_));
+  end = (newline == nullptr) ? data_ + size_ : newline;
+  pos_ = std::size_t(end - data_) + 1;
+  while (begin != end && IsSpace(*begin)) {
+    ++begin;
+  }
+  while (end != begin && IsSpace(*(end - 1))) {
+    --end;
+  }
   return true;
 }
 
-void LAMMPSDumpReader::Close() { fl_.close(); }
+void LAMMPSDumpReader::BuildFrameIndex() {
+  static const string timestep = "ITEM: TIMESTEP";
+  Index nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = Index(omp_get_max_threads());
+#endif
+  // every chunk collects the frames whose first line starts in it
+  Index nchunks =
+      std::max(Index(1), std::min(4 * nthreads, Index(size_ >> 20)));
+  std::vector<std::vector<std::size_t>> found(nchunks);
+
+#pragma omp parallel for schedule(static) if (nthreads > 1 && nchunks > 1)
+  for (Index chunk = 0; chunk < nchunks; ++chunk) {
+    std::size_t first = size_ * std::size_t(chunk) / std::size_t(nchunks);
+    std::size_t last = size_ * std::size_t(chunk + 1) / std::size_t(nchunks);
+    // move to the first line starting in this chunk
+    std::size_t pos = first;
+    if (pos > 0 && data_[pos - 1] != '\n') {
+      const void *newline = std::memchr(data_ + pos, '\n', last - pos);
+      pos = (newline == nullptr)
+                ? last
+                : std::size_t(static_cast<const char *>(newline) - data_) + 1;
+    }
+    while (pos < last) {
+      if (size_ - pos >= timestep.size() &&
+          std::memcmp(data_ + pos, timestep.data(), timestep.size()) == 0) {
+        found[chunk].push_back(pos);
+      }
+      const void *newline = std::memchr(data_ + pos, '\n', size_ - pos);
+      if (newline == nullptr) {
+        break;
+      }
+      pos = std::size_t(static_cast<const char *>(newline) - data_) + 1;
+    }
+  }
+
+  frames_.clear();
+  for (const auto &chunk : found) {
+    frames_.insert(frames_.end(), chunk.begin(), chunk.end());
+  }
+  indexed_ = true;
+}
 
 bool LAMMPSDumpReader::FirstFrame(Topology &top) {
   topology_ = false;
@@ -69,11 +224,38 @@ bool LAMMPSDumpReader::FirstFrame(Topology &top) {
   return true;
 }
 
+bool LAMMPSDumpReader::AdvanceFrames(Topology &top, Index nframes) {
+  if (nframes < 1) {
+    return true;
+  }
+  if (!indexed_) {
+    BuildFrameIndex();
+  }
+  Index frame = next_frame_ + nframes - 1;
+  // the frames found must be the ones NextFrame reads, otherwise parse the
+  // file frame by frame
+  if (frames_.empty() || next_frame_ >= Index(frames_.size()) ||
+      frames_[next_frame_] != pos_) {
+    return TrajectoryReader::AdvanceFrames(top, nframes);
+  }
+  if (frame >= Index(frames_.size())) {
+    pos_ = size_;
+    next_frame_ = Index(frames_.size());
+    return false;
+  }
+  pos_ = frames_[frame];
+  next_frame_ = frame;
+  return NextFrame(top);
+}
+
 bool LAMMPSDumpReader::NextFrame(Topology &top) {
-  string line;
-  tools::getline(fl_, line);
-  boost::algorithm::trim(line);
-  while (!fl_.eof()) {
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool has_line = GetLine(begin, end);
+  bool has_frame = false;
+  while (has_line) {
+    // the item lines are few, so they can be copied
+    string line(begin, end);
     if (line.substr(0, 5) != "ITEM:") {
       throw std::ios_base::failure("unexpected line in lammps file:\n" + line);
     }
@@ -85,6 +267,7 @@ bool LAMMPSDumpReader::NextFrame(Topology &top) {
       ReadBox(top);
     } else if (line.substr(6, 5) == "ATOMS") {
       ReadAtoms(top, line);
+      has_frame = true;
       break;
     }
 
@@ -92,35 +275,47 @@ bool LAMMPSDumpReader::NextFrame(Topology &top) {
       throw std::ios_base::failure("unknown item lammps file : " +
                                    line.substr(6));
     }
-    tools::getline(fl_, line);
-    boost::algorithm::trim(line);
+    has_line = GetLine(begin, end);
   }
   if (topology_) {
     cout << "WARNING: topology created from .dump file, masses, charges, "
             "types, residue names are wrong!\n";
   }
-  return !fl_.eof();
-  ;
+  if (has_frame) {
+    ++next_frame_;
+  }
+  return has_frame;
 }
 
 void LAMMPSDumpReader::ReadTimestep(Topology &top) {
-  string s;
-  tools::getline(fl_, s);
-  boost::algorithm::trim(s);
-  top.setStep(boost::lexical_cast<Index>(s));
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  if (!GetLine(begin, end)) {
+    throw std::ios_base::failure("unexpected end of lammps file: " + fname_);
+  }
+  top.setStep(ToIndex(begin, end));
   cout << "Reading frame, timestep " << top.getStep() << endl;
 }
 
 void LAMMPSDumpReader::ReadBox(Topology &top) {
-  string s;
-
   Eigen::Matrix3d m = Eigen::Matrix3d::Zero();
 
   for (Index i = 0; i < 3; ++i) {
-    tools::getline(fl_, s);
-    boost::algorithm::trim(s);
-    vector<double> v = tools::Tokenizer(s, " ").ToVector<double>();
-    if (v.size() != 2) {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    if (!GetLine(begin, end)) {
+      throw std::ios_base::failure("invalid box format");
+    }
+    double v[2];
+    Index n = 0;
+    const char *field_end = nullptr;
+    for (; NextField(begin, end, field_end); begin = field_end, ++n) {
+      if (n == 2) {
+        throw std::ios_base::failure("invalid box format");
+      }
+      v[n] = ToDouble(begin, field_end);
+    }
+    if (n != 2) {
       throw std::ios_base::failure("invalid box format");
     }
     m(i, i) = v[1] - v[0];
@@ -129,10 +324,12 @@ void LAMMPSDumpReader::ReadBox(Topology &top) {
 }
 
 void LAMMPSDumpReader::ReadNumAtoms(Topology &top) {
-  string s;
-  tools::getline(fl_, s);
-  boost::algorithm::trim(s);
-  natoms_ = boost::lexical_cast<Index>(s);
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  if (!GetLine(begin, end)) {
+    throw std::ios_base::failure("unexpected end of lammps file: " + fname_);
+  }
+  natoms_ = ToIndex(begin, end);
   if (!topology_ && natoms_ != top.BeadCount()) {
     std::runtime_error("number of beads in topology and trajectory differ");
   }
@@ -154,26 +351,50 @@ void LAMMPSDumpReader::ReadAtoms(Topology &top, string itemline) {
   bool vel = false;
   Index id = -1;
 
-  vector<string> fields;
-
+  // resolve the columns once for the whole frame
+  vector<Column> columns;
   {
     tools::Tokenizer tok(itemline.substr(12), " ");
-    fields = tok.ToVector();
-    Index j = 0;
-    for (tools::Tokenizer::iterator i = tok.begin(); i != tok.end(); ++i, ++j) {
-      if (*i == "x" || *i == "y" || *i == "z") {
-        pos = true;
-      } else if (*i == "xu" || *i == "yu" || *i == "zu") {
-        pos = true;
-      } else if (*i == "xs" || *i == "ys" || *i == "zs") {
-        pos = true;
-      } else if (*i == "vx" || *i == "vy" || *i == "vz") {
-        vel = true;
-      } else if (*i == "fx" || *i == "fy" || *i == "fz") {
-        force = true;
-      } else if (*i == "id") {
-        id = j;
+    for (const string &field : tok) {
+      Column column = Column::none;
+      if (field == "x" || field == "xu") {
+        column = Column::x;
+      } else if (field == "y" || field == "yu") {
+        column = Column::y;
+      } else if (field == "z" || field == "zu") {
+        column = Column::z;
+      } else if (field == "xs") {
+        column = Column::xs;
+      } else if (field == "ys") {
+        column = Column::ys;
+      } else if (field == "zs") {
+        column = Column::zs;
+      } else if (field == "vx") {
+        column = Column::vx;
+      } else if (field == "vy") {
+        column = Column::vy;
+      } else if (field == "vz") {
+        column = Column::vz;
+      } else if (field == "fx") {
+        column = Column::fx;
+      } else if (field == "fy") {
+        column = Column::fy;
+      } else if (field == "fz") {
+        column = Column::fz;
+      } else if (field == "type") {
+        column = Column::type;
+      } else if (field == "id") {
+        column = Column::id;
+        id = Index(columns.size());
       }
+      pos = pos || column == Column::x || column == Column::y ||
+            column == Column::z || column == Column::xs ||
+            column == Column::ys || column == Column::zs;
+      vel = vel || column == Column::vx || column == Column::vy ||
+            column == Column::vz;
+      force = force || column == Column::fx || column == Column::fy ||
+              column == Column::fz;
+      columns.push_back(column);
     }
   }
   if (id < 0) {
@@ -181,74 +402,122 @@ void LAMMPSDumpReader::ReadAtoms(Topology &top, string itemline) {
         "error, id not found in any column of the atoms section");
   }
 
+  // find the atom lines first, so they can be parsed in parallel
+  vector<std::pair<const char *, const char *>> lines(natoms_);
   for (Index i = 0; i < natoms_; ++i) {
-    string s;
-    tools::getline(fl_, s);
-    boost::algorithm::trim(s);
-    if (fl_.eof()) {
+    if (!GetLine(lines[i].first, lines[i].second)) {
       throw std::runtime_error("Error: unexpected end of lammps file '" +
                                fname_ + "' only " +
                                boost::lexical_cast<string>(i) + " atoms of " +
                                boost::lexical_cast<string>(natoms_) + " read.");
     }
+  }
 
-    tools::Tokenizer tok(s, " ");
-    tools::Tokenizer::iterator itok = tok.begin();
-    vector<string> fields2 = tok.ToVector();
-    // internal numbering begins with 0
-    Index atom_id = boost::lexical_cast<Index>(fields2[id]);
-    if (atom_id > natoms_) {
+  Index nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = Index(omp_get_max_threads());
+#endif
+  // new bead types have to be registered one after the other
+  bool parallel = !topology_ && nthreads > 1 && natoms_ > 10000;
+  std::exception_ptr error;
+#pragma omp parallel for schedule(static) if (parallel)
+  for (Index i = 0; i < natoms_; ++i) {
+    try {
+      ParseAtom(top, lines[i].first, lines[i].second, columns, id, pos, force,
+                vel);
+    } catch (...) {
+#pragma omp critical
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void LAMMPSDumpReader::ParseAtom(Topology &top, const char *begin,
+                                 const char *end,
+                                 const vector<Column> &columns, Index idcol,
+                                 bool pos, bool force, bool vel) const {
+  // internal numbering begins with 0
+  const char *field_end = nullptr;
+  const char *field = begin;
+  for (Index j = 0; NextField(field, end, field_end) && j < idcol; ++j) {
+    field = field_end;
+  }
+  Index atom_id = ToIndex(field, field_end);
+  if (atom_id > natoms_) {
+    throw std::runtime_error(
+        "Error: found atom with id " + boost::lexical_cast<string>(atom_id) +
+        " but only " + boost::lexical_cast<string>(natoms_) +
+        " atoms defined in header of file '" + fname_ + "'");
+  }
+  Bead *b = top.getBead(atom_id - 1);
+  b->HasPos(pos);
+  b->HasF(force);
+  b->HasVel(vel);
+  const Eigen::Matrix3d &m = top.getBox();
+
+  std::size_t j = 0;
+  for (; NextField(begin, end, field_end); begin = field_end, ++j) {
+    if (j == columns.size()) {
       throw std::runtime_error(
-          "Error: found atom with id " + boost::lexical_cast<string>(atom_id) +
-          " but only " + boost::lexical_cast<string>(natoms_) +
-          " atoms defined in header of file '" + fname_ + "'");
+          "error, wrong number of columns in atoms section");
     }
-    Bead *b = top.getBead(atom_id - 1);
-    b->HasPos(pos);
-    b->HasF(force);
-    b->HasVel(vel);
-    Eigen::Matrix3d m = top.getBox();
-
-    for (size_t j = 0; itok != tok.end(); ++itok, ++j) {
-      if (j == fields.size()) {
-        throw std::runtime_error(
-            "error, wrong number of columns in atoms section");
-      } else if (fields[j] == "x") {
-        b->Pos().x() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "y") {
-        b->Pos().y() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "z") {
-        b->Pos().z() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "xu") {
-        b->Pos().x() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "yu") {
-        b->Pos().y() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "zu") {
-        b->Pos().z() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "xs") {
-        b->Pos().x() = stod(*itok) * m(0, 0);  // box is already in nm
-      } else if (fields[j] == "ys") {
-        b->Pos().y() = stod(*itok) * m(1, 1);  // box is already in nm
-      } else if (fields[j] == "zs") {
-        b->Pos().z() = stod(*itok) * m(2, 2);  // box is already in nm
-      } else if (fields[j] == "vx") {
-        b->Vel().x() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "vy") {
-        b->Vel().y() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "vz") {
-        b->Vel().z() = stod(*itok) * tools::conv::ang2nm;
-      } else if (fields[j] == "fx") {
-        b->F().x() = stod(*itok) * tools::conv::kcal2kj / tools::conv::ang2nm;
-      } else if (fields[j] == "fy") {
-        b->F().y() = stod(*itok) * tools::conv::kcal2kj / tools::conv::ang2nm;
-      } else if (fields[j] == "fz") {
-        b->F().z() = stod(*itok) * tools::conv::kcal2kj / tools::conv::ang2nm;
-      } else if ((fields[j] == "type") && topology_) {
-        if (!top.BeadTypeExist(*itok)) {
-          top.RegisterBeadType(*itok);
+    switch (columns[j]) {
+      case Column::none:
+      case Column::id:
+        break;
+      case Column::x:
+        b->Pos().x() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::y:
+        b->Pos().y() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::z:
+        b->Pos().z() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::xs:
+        b->Pos().x() = ToDouble(begin, field_end) * m(0, 0);  // box is in nm
+        break;
+      case Column::ys:
+        b->Pos().y() = ToDouble(begin, field_end) * m(1, 1);  // box is in nm
+        break;
+      case Column::zs:
+        b->Pos().z() = ToDouble(begin, field_end) * m(2, 2);  // box is in nm
+        break;
+      case Column::vx:
+        b->Vel().x() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::vy:
+        b->Vel().y() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::vz:
+        b->Vel().z() = ToDouble(begin, field_end) * tools::conv::ang2nm;
+        break;
+      case Column::fx:
+        b->F().x() = ToDouble(begin, field_end) * tools::conv::kcal2kj /
+                       tools::conv::ang2nm;
+        break;
+      case Column::fy:
+        b->F().y() = ToDouble(begin, field_end) * tools::conv::kcal2kj /
+                       tools::conv::ang2nm;
+        break;
+      case Column::fz:
+        b->F().z() = ToDouble(begin, field_end) * tools::conv::kcal2kj /
+                       tools::conv::ang2nm;
+        break;
+      case Column::type:
+        if (topology_) {
+          string type(begin, field_end);
+          if (!top.BeadTypeExist(type)) {
+            top.RegisterBeadType(type);
+          }
+          b->setType(type);
         }
-        b->setType(*itok);
-      }
+        break;
     }
   }
 }
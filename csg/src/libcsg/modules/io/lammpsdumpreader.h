@@ -20,9 +20,10 @@
 
 #include "../../../../include/votca/csg/topologyreader.h"
 #include "../../../../include/votca/csg/trajectoryreader.h"
-#include <fstream>
+#include <cstddef>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <votca/tools/unitconverter.h>
 
 namespace votca {
@@ -34,6 +35,9 @@ namespace csg {
     This class provides the TrajectoryReader + Topology reader interface
     for lammps dump files
 
+    The file is mapped into memory and parsed in place. The byte offsets of
+    the frames are indexed the first time frames are skipped, so later frames
+    can be read without parsing the ones before.
 */
 class LAMMPSDumpReader : public TrajectoryReader, public TopologyReader {
  public:
@@ -50,7 +54,7 @@ class LAMMPSDumpReader : public TrajectoryReader, public TopologyReader {
       tools::VelocityUnit::angstroms_per_femtosecond;
 
   LAMMPSDumpReader() = default;
-  ~LAMMPSDumpReader() override = default;
+  ~LAMMPSDumpReader() override { Unmap(); }
 
   /// open a topology file
   bool ReadTopology(std::string file, Topology &top) override;
@@ -61,19 +65,63 @@ class LAMMPSDumpReader : public TrajectoryReader, public TopologyReader {
   bool FirstFrame(Topology &top) override;
   /// read in the next frame
   bool NextFrame(Topology &top) override;
+  /// jump to a frame with the help of the frame index
+  bool AdvanceFrames(Topology &top, Index nframes) override;
 
   void Close() override;
 
  private:
+  /// quantity stored in a column of the atoms section
+  enum class Column {
+    none,
+    id,
+    type,
+    x,
+    y,
+    z,
+    xs,
+    ys,
+    zs,
+    vx,
+    vy,
+    vz,
+    fx,
+    fy,
+    fz
+  };
+
+  void Map(const std::string &file, const std::string &what);
+  void Unmap();
+  /// get the next line of the file without surrounding white space, false at
+  /// the end of the file
+  bool GetLine(const char *&begin, const char *&end);
+  /// find the start of all frames
+  void BuildFrameIndex();
+
   void ReadTimestep(Topology &top);
   void ReadBox(Topology &top);
   void ReadNumAtoms(Topology &top);
   void ReadAtoms(Topology &top, std::string itemline);
+  /// parse one line of the atoms section, pos, force and vel tell which
+  /// quantities are set on the bead
+  void ParseAtom(Topology &top, const char *begin, const char *end,
+                 const std::vector<Column> &columns, Index idcol, bool pos,
+                 bool force, bool vel) const;
 
-  std::ifstream fl_;
   std::string fname_;
   bool topology_;
   Index natoms_;
+
+  /// the mapped file
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  /// position of the next line to read
+  std::size_t pos_ = 0;
+  /// number of the next frame to read
+  Index next_frame_ = 0;
+  /// offsets of the frames, filled by BuildFrameIndex
+  std::vector<std::size_t> frames_;
+  bool indexed_ = false;
 };
 
 }  // namespace csg
@@ -16,6 +16,7 @@
  */
 
 // Standard library includes
+#include <cmath>
 #include <iostream>
 
 // Local VOTCA includes
@@ -49,6 +50,20 @@ void NBList::Generate(BeadList &list1, BeadList &list2, bool do_exclusions) {
   assert(&(list1.getTopology()) == &(list2.getTopology()));
   const Topology &top = list1.getTopology();
 
+  if (&list1 != &list2) {
+    InitDuplicateCheck(list1, list2);
+  }
+
+  // gather the positions of the second list once, so the shortest
+  // connections of each bead of the first list are computed in one batch
+  Eigen::Matrix3Xd pos2(3, list2.size());
+  for (Index j = 0; j < list2.size(); ++j) {
+    pos2.col(j) = (*(list2.begin() + j))->getPos();
+  }
+  Eigen::Matrix3Xd r_ij(3, list2.size());
+  Eigen::VectorXd dist2(list2.size());
+  const BoundaryCondition &bc = top.getBoundary();
+
   for (iter1 = list1.begin(); iter1 != list1.end(); ++iter1) {
     if (&list1 == &list2) {
       iter2 = iter1;
@@ -64,26 +79,49 @@ void NBList::Generate(BeadList &list1, BeadList &list2, bool do_exclusions) {
       continue;
     }
 
-    for (; iter2 != list2.end(); ++iter2) {
-      Eigen::Vector3d u = (*iter1)->getPos();
-      Eigen::Vector3d v = (*iter2)->getPos();
+    const Index start = iter2 - list2.begin();
+    const Index n = list2.size() - start;
+    bc.BCShortestConnections((*iter1)->getPos(), pos2.rightCols(n),
+                             r_ij.leftCols(n), dist2.head(n));
 
-      Eigen::Vector3d r = top.BCShortestConnection(u, v);
-      double d = r.norm();
+    for (Index k = 0; iter2 != list2.end(); ++iter2, ++k) {
+      double d = std::sqrt(dist2(k));
       if (d < cutoff_) {
         if (do_exclusions_) {
           if (top.getExclusions().IsExcluded(*iter1, *iter2)) {
             continue;
           }
         }
+        Eigen::Vector3d r = r_ij.col(k);
         if ((*match_function_)(*iter1, *iter2, r, d)) {
-          if (!FindPair(*iter1, *iter2)) {
-            AddPair(pair_creator_(*iter1, *iter2, r));
+          if (!IsDuplicate(*iter1, *iter2)) {
+            pair_creator_(*this, *iter1, *iter2, r);
           }
         }
       }
     }
   }
+  shared_beads_.clear();
+  shared_pairs_.clear();
+}
+
+void NBList::InitDuplicateCheck(BeadList &list1, BeadList &list2) {
+  shared_beads_.clear();
+  shared_pairs_.clear();
+  std::unordered_set<Bead *> beads1(list1.begin(), list1.end());
+  for (Bead *bead : list2) {
+    if (beads1.count(bead)) {
+      shared_beads_.insert(bead);
+    }
+  }
+}
+
+bool NBList::IsDuplicate(Bead *bead1, Bead *bead2) {
+  if (shared_beads_.empty() || !shared_beads_.count(bead1) ||
+      !shared_beads_.count(bead2)) {
+    return false;
+  }
+  return !shared_pairs_.insert(std::minmax(bead1, bead2)).second;
 }
 
 }  // namespace csg
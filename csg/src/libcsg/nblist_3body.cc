@@ -16,7 +16,10 @@
  */
 
 // Standard includes
+#include <exception>
 #include <iostream>
+#include <unordered_set>
+#include <vector>
 
 // Local VOTCA includes
 #include "votca/csg/nblist_3body.h"
@@ -34,98 +37,142 @@ NBList_3Body::~NBList_3Body() = default;
 
 void NBList_3Body::Generate(BeadList &list1, BeadList &list2, BeadList &list3,
                             bool do_exclusions) {
-  BeadList::iterator iter1;
-  BeadList::iterator iter2;
-  BeadList::iterator iter3;
   do_exclusions_ = do_exclusions;
-
-  if (list1.empty()) {
-    return;
-  }
-  if (list2.empty()) {
+  if (list1.empty() || list2.empty() || list3.empty()) {
     return;
   }
-  if (list3.empty()) {
+  const Topology &top = list1.getTopology();
+
+  auto add_triple = [this, &top](Bead *bead1, Bead *bead2, Bead *bead3,
+                                 const Eigen::Vector3d &r12,
+                                 const Eigen::Vector3d &r13, double d12,
+                                 double d13) {
+    Eigen::Vector3d r23 =
+        top.BCShortestConnection(bead2->getPos(), bead3->getPos());
+    if ((*match_function_)(bead1, bead2, bead3, r12, r13, r23, d12, d13,
+                           r23.norm())) {
+      AddTriple(triple_creator_(bead1, bead2, bead3, r12, r13, r23));
+    }
+  };
+  TripleVisitorWrapper<decltype(add_triple)> visitor(add_triple);
+  // the match function and the triple list are not thread safe
+  VisitTriples(list1, list2, list3, visitor, false);
+}
+
+void NBList_3Body::VisitTriples(BeadList &list1, BeadList &list2,
+                                BeadList &list3, TripleVisitor &visitor,
+                                bool parallel) {
+  if (list1.empty() || list2.empty() || list3.empty()) {
     return;
   }
 
   // check if all bead lists "have" the same topology
   assert(&(list1.getTopology()) == &(list2.getTopology()));
   assert(&(list1.getTopology()) == &(list3.getTopology()));
-  assert(&(list2.getTopology()) == &(list3.getTopology()));
   const Topology &top = list1.getTopology();
 
-  // builds neighbor lists for all cases, where all list are of different bead
-  // typess (list1 neq list2 neq list3), list2 and list3 are of the same type
-  // (list1 neq (list2 = list3)) or all three lists are the same
-  // (list1=list2=list3)!
-  for (iter1 = list1.begin(); iter1 != list1.end(); ++iter1) {
-
-    // in all cases iterate over the full bead lists list1 and list2
-    // if both lists are the same (the 3 bead types are the same),
-    // still necessary as both permutations (1,2,*) (2,1,*) included in neighbor
-    // list! (i,jneqi,k>j)
-    iter2 = list2.begin();
-
-    for (; iter2 != list2.end(); ++iter2) {
-
-      // do not include the same beads twice in one triple!
-      if (*iter1 == *iter2) {
-        continue;
-      }
-
-      // if list2 and list3 are the same, set iter3 to "iter2+1" (i,jneqi,k>j)
-      if (&list2 == &list3) {
-        iter3 = iter2;
-        ++iter3;
-      } else {
-        iter3 = list3.begin();
+  // triples (i,j,k) and (i,k,j) are the same, if j and k can be in both lists
+  // only the one with the lower id first is visited
+  shared_beads_.clear();
+  same_lists23_ = (&list2 == &list3);
+  if (!same_lists23_) {
+    std::unordered_set<Bead *> beads2(list2.begin(), list2.end());
+    for (Bead *bead : list3) {
+      if (beads2.count(bead)) {
+        shared_beads_.insert(bead);
       }
+    }
+  }
 
-      for (; iter3 != list3.end(); ++iter3) {
+  SearchTriples(top, list1, list2, list3, visitor, parallel);
+  shared_beads_.clear();
+}
 
-        // do not include the same beads twice in one triple!
-        if (*iter1 == *iter3) {
-          continue;
-        }
-        if (*iter2 == *iter3) {
-          continue;
+void NBList_3Body::SearchTriples(const Topology &top, BeadList &list1,
+                                 BeadList &list2, BeadList &list3,
+                                 TripleVisitor &visitor, bool parallel) {
+  const std::vector<Bead *> candidates2(list2.begin(), list2.end());
+  const std::vector<Bead *> candidates3(list3.begin(), list3.end());
+
+  std::exception_ptr error = nullptr;
+#pragma omp parallel if (parallel)
+  {
+    std::vector<Neighbour> neighbours2;
+    std::vector<Neighbour> neighbours3;
+#pragma omp for schedule(dynamic)
+    for (Index i = 0; i < list1.size(); ++i) {
+      try {
+        Bead *bead = *(list1.begin() + i);
+        neighbours2.clear();
+        AddNeighbours(top, bead, candidates2, neighbours2);
+        if (same_lists23_) {
+          VisitNeighbours(top, bead, neighbours2, neighbours2, visitor);
+        } else {
+          neighbours3.clear();
+          AddNeighbours(top, bead, candidates3, neighbours3);
+          VisitNeighbours(top, bead, neighbours2, neighbours3, visitor);
         }
+      } catch (...) {
+#pragma omp critical
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
 
-        Eigen::Vector3d u = (*iter1)->getPos();
-        Eigen::Vector3d v = (*iter2)->getPos();
-        Eigen::Vector3d z = (*iter3)->getPos();
-
-        Eigen::Vector3d r12 = top.BCShortestConnection(u, v);
-        Eigen::Vector3d r13 = top.BCShortestConnection(u, z);
-        Eigen::Vector3d r23 = top.BCShortestConnection(v, z);
-        double d12 = r12.norm();
-        double d13 = r13.norm();
-        double d23 = r23.norm();
-        // to do: at the moment use only one cutoff value
-        // to do: so far only check the distance between bead 1 (central bead)
-        // and bead2 and bead 3
-        if ((d12 < cutoff_) && (d13 < cutoff_)) {
-          /// experimental: at the moment exclude interaction as soon as one of
-          /// the three pairs (1,2) (1,3) (2,3) is excluded!
-          if (do_exclusions_) {
-            if ((top.getExclusions().IsExcluded(*iter1, *iter2)) ||
-                (top.getExclusions().IsExcluded(*iter1, *iter3)) ||
-                (top.getExclusions().IsExcluded(*iter2, *iter3))) {
-              continue;
-            }
-          }
-          if ((*match_function_)(*iter1, *iter2, *iter3, r12, r13, r23, d12,
-                                 d13, d23)) {
-            if (!FindTriple(*iter1, *iter2, *iter3)) {
-              AddTriple(triple_creator_(*iter1, *iter2, *iter3, r12, r13, r23));
-            }
-          }
-        }
+void NBList_3Body::AddNeighbours(const Topology &top, Bead *bead,
+                                 const std::vector<Bead *> &candidates,
+                                 std::vector<Neighbour> &neighbours) const {
+  const Eigen::Vector3d &u = bead->getPos();
+  for (Bead *candidate : candidates) {
+    // do not include the same beads twice in one triple!
+    if (candidate == bead) {
+      continue;
+    }
+    Eigen::Vector3d r = top.BCShortestConnection(u, candidate->getPos());
+    double d = r.norm();
+    // to do: at the moment use only one cutoff value
+    // to do: so far only check the distance between bead 1 (central bead)
+    // and bead2 and bead 3
+    if (d >= cutoff_) {
+      continue;
+    }
+    /// experimental: at the moment exclude interaction as soon as one of
+    /// the three pairs (1,2) (1,3) (2,3) is excluded!
+    if (do_exclusions_ && top.getExclusions().IsExcluded(bead, candidate)) {
+      continue;
+    }
+    neighbours.push_back({candidate, r, d});
+  }
+}
+
+void NBList_3Body::VisitNeighbours(const Topology &top, Bead *bead,
+                                   const std::vector<Neighbour> &neighbours2,
+                                   const std::vector<Neighbour> &neighbours3,
+                                   TripleVisitor &visitor) const {
+  for (const Neighbour &n2 : neighbours2) {
+    for (const Neighbour &n3 : neighbours3) {
+      if (n2.bead == n3.bead || IsSwappedPair(n2.bead, n3.bead)) {
+        continue;
       }
+      if (do_exclusions_ && top.getExclusions().IsExcluded(n2.bead, n3.bead)) {
+        continue;
+      }
+      visitor(bead, n2.bead, n3.bead, n2.r, n3.r, n2.dist, n3.dist);
     }
   }
 }
 
+bool NBList_3Body::IsSwappedPair(Bead *bead2, Bead *bead3) const {
+  if (bead2->getId() < bead3->getId()) {
+    return false;
+  }
+  return same_lists23_ ||
+         (shared_beads_.count(bead2) && shared_beads_.count(bead3));
+}
+
 }  // namespace csg
 }  // namespace votca
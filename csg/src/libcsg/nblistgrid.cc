@@ -15,10 +15,16 @@
  *
  */
 
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 // Local VOTCA includes
 #include "votca/csg/nblistgrid.h"
 #include "votca/csg/topology.h"
-#include "votca/tools/NDimVector.h"
 
 namespace votca {
 namespace csg {
@@ -29,6 +35,9 @@ void NBListGrid::Generate(BeadList &list1, BeadList &list2,
                           bool do_exclusions) {
 
   do_exclusions_ = do_exclusions;
+  if (skin_ > 0.0) {
+    Cleanup();
+  }
   if (list1.empty()) {
     return;
   }
@@ -39,35 +48,111 @@ void NBListGrid::Generate(BeadList &list1, BeadList &list2,
   assert(&(list1.getTopology()) == &(list2.getTopology()));
   const Topology &top = list1.getTopology();
 
-  InitializeGrid(top.getBox());
-
-  // Add all beads of list1
-  for (auto &iter : list1) {
-    getCell(iter->getPos()).beads_.push_back(iter);
+  beads_.clear();
+  in_list1_.clear();
+  in_list2_.clear();
+  // beads which are in both lists are only stored once
+  std::vector<Index> index(top.BeadCount(), -1);
+  for (Bead *bead : list1) {
+    index[bead->getId()] = Index(beads_.size());
+    beads_.push_back(bead);
+    in_list1_.push_back(1);
+    in_list2_.push_back(0);
   }
-
-  for (auto &iter : list2) {
-    cell_t &cell = getCell(iter->getPos());
-    TestBead(top, cell, iter);
+  for (Bead *bead : list2) {
+    if (index[bead->getId()] >= 0) {
+      in_list2_[index[bead->getId()]] = 1;
+      continue;
+    }
+    beads_.push_back(bead);
+    in_list1_.push_back(0);
+    in_list2_.push_back(1);
   }
+
+  Update(top);
 }
 
 void NBListGrid::Generate(BeadList &list, bool do_exclusions) {
   do_exclusions_ = do_exclusions;
+  if (skin_ > 0.0) {
+    Cleanup();
+  }
   if (list.empty()) {
     return;
   }
 
   const Topology &top = list.getTopology();
 
+  beads_.assign(list.begin(), list.end());
+  in_list1_.assign(beads_.size(), 1);
+  in_list2_.assign(beads_.size(), 1);
+
+  Update(top);
+}
+
+void NBListGrid::Update(const Topology &top) {
+  if (skin_ > 0.0 && VerletListValid(top)) {
+    ReuseVerletList(top);
+    return;
+  }
   InitializeGrid(top.getBox());
+  Search(top);
+}
+
+bool NBListGrid::VerletListValid(const Topology &top) const {
+  if (!verlet_valid_ || verlet_exclusions_ != do_exclusions_ ||
+      verlet_cutoff_ != cutoff_ || verlet_box_ != top.getBox()) {
+    return false;
+  }
+  if (beads_ != verlet_beads_ || in_list1_ != verlet_in_list1_ ||
+      in_list2_ != verlet_in_list2_) {
+    return false;
+  }
+  // no pair can have entered the cutoff if every bead moved less than half
+  // the skin
+  double max_displacement2 = 0.25 * skin_ * skin_;
+  for (std::size_t i = 0; i < beads_.size(); ++i) {
+    Eigen::Vector3d d =
+        top.BCShortestConnection(verlet_pos_[i], beads_[i]->getPos());
+    if (d.squaredNorm() > max_displacement2) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  for (auto &iter : list) {
-    cell_t &cell = getCell(iter->getPos());
-    TestBead(top, cell, iter);
-    getCell(iter->getPos()).beads_.push_back(iter);
+void NBListGrid::ReuseVerletList(const Topology &top) {
+  Index npairs = Index(verlet_pairs_.size());
+  if (npairs == 0) {
+    return;
   }
+  Index nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = Index(omp_get_max_threads());
+#endif
+  Index nblocks = std::min(npairs, 8 * nthreads);
+  std::vector<std::vector<candidate_t>> found(nblocks);
+  double cutoff2 = cutoff_ * cutoff_;
+
+#pragma omp parallel for schedule(static) if (nthreads > 1 && nblocks > 1)
+  for (Index block = 0; block < nblocks; ++block) {
+    Index first_pair = npairs * block / nblocks;
+    Index last_pair = npairs * (block + 1) / nblocks;
+    for (Index k = first_pair; k < last_pair; ++k) {
+      Index i = verlet_pairs_[k].first;
+      Index j = verlet_pairs_[k].second;
+      Eigen::Vector3d r =
+          top.BCShortestConnection(beads_[i]->getPos(), beads_[j]->getPos());
+      double d2 = r.squaredNorm();
+      if (d2 < cutoff2) {
+        found[block].push_back(candidate_t{i, j, r, std::sqrt(d2)});
+      }
+    }
+  }
+
+  CreatePairs(found);
 }
+
 void NBListGrid::InitializeGrid(const Eigen::Matrix3d &box) {
   box_a_ = box.col(0);
   box_b_ = box.col(1);
@@ -87,118 +172,226 @@ void NBListGrid::InitializeGrid(const Eigen::Matrix3d &box) {
   double lc = box_c_.dot(norm_c_);
 
   // calculate grid size, each grid has to be at least size of cut-off
-  box_Na_ = Index(std::max(std::abs(la / cutoff_), 1.0));
-  box_Nb_ = Index(std::max(std::abs(lb / cutoff_), 1.0));
-  box_Nc_ = Index(std::max(std::abs(lc / cutoff_), 1.0));
+  double cutoff = cutoff_ + skin_;
+  box_Na_ = Index(std::max(std::abs(la / cutoff), 1.0));
+  box_Nb_ = Index(std::max(std::abs(lb / cutoff), 1.0));
+  box_Nc_ = Index(std::max(std::abs(lc / cutoff), 1.0));
 
   norm_a_ = norm_a_ / box_a_.dot(norm_a_) * (double)box_Na_;
   norm_b_ = norm_b_ / box_b_.dot(norm_b_) * (double)box_Nb_;
   norm_c_ = norm_c_ / box_c_.dot(norm_c_) * (double)box_Nc_;
 
-  grid_ = tools::NDimVector<cell_t, 3>(box_Na_, box_Nb_, box_Nc_);
-
-  Index a1, a2, b1, b2, c1, c2;
-
-  a1 = b1 = c1 = -1;
-  a2 = b2 = c2 = 1;
-
-  if (box_Na_ < 3) {
-    a2 = 0;
-  }
-  if (box_Nb_ < 3) {
-    b2 = 0;
-  }
-  if (box_Nc_ < 3) {
-    c2 = 0;
-  }
-
-  if (box_Na_ < 2) {
-    a1 = 0;
-  }
-  if (box_Nb_ < 2) {
-    b1 = 0;
-  }
-  if (box_Nc_ < 2) {
-    c1 = 0;
-  }
-
-  // wow, setting up the neighbours is an ugly for construct!
-  // loop from N..2*N to avoid if and only use %
-  for (Index a = box_Na_; a < 2 * box_Na_; ++a) {
-    for (Index b = box_Nb_; b < 2 * box_Nb_; ++b) {
-      for (Index c = box_Nc_; c < 2 * box_Nc_; ++c) {
-        cell_t &cell = grid_(a % box_Na_, b % box_Nb_, c % box_Nc_);
-        for (Index aa = a + a1; aa <= a + a2; ++aa) {
-          for (Index bb = b + b1; bb <= b + b2; ++bb) {
-            for (Index cc = c + c1; cc <= c + c2; ++cc) {
-              cell_t *cell2 = &grid_(aa % box_Na_, bb % box_Nb_, cc % box_Nc_);
-              if (cell2 == &cell) {
-                continue;  // ignore self
-              }
-              cell.neighbours_.push_back(
-                  &grid_(aa % box_Na_, bb % box_Nb_, cc % box_Nc_));
-            }
+  // with at least three cells in each direction every neighbouring cell is a
+  // unique periodic image and the half shell is enough
+  shift_per_cell_ = box_Na_ >= 3 && box_Nb_ >= 3 && box_Nc_ >= 3;
+
+  offsets_.clear();
+  if (shift_per_cell_) {
+    offsets_.push_back({0, 0, 0});
+    for (Index c = 0; c <= 1; ++c) {
+      for (Index b = -1; b <= 1; ++b) {
+        for (Index a = -1; a <= 1; ++a) {
+          if (c > 0 || b > 0 || (b == 0 && a > 0)) {
+            offsets_.push_back({a, b, c});
           }
         }
       }
     }
+    return;
+  }
+
+  // for small grids only take offsets which map to different cells, the
+  // half shell is then chosen by comparing the cell indices
+  auto range = [](Index n) {
+    return std::array<Index, 2>{(n < 2) ? 0 : -1, (n < 3) ? 0 : 1};
+  };
+  std::array<Index, 2> ra = range(box_Na_);
+  std::array<Index, 2> rb = range(box_Nb_);
+  std::array<Index, 2> rc = range(box_Nc_);
+  for (Index c = rc[0]; c <= rc[1]; ++c) {
+    for (Index b = rb[0]; b <= rb[1]; ++b) {
+      for (Index a = ra[0]; a <= ra[1]; ++a) {
+        offsets_.push_back({a, b, c});
+      }
+    }
   }
 }
 
-NBListGrid::cell_t &NBListGrid::getCell(const Eigen::Vector3d &r) {
-  Index a = (Index)floor(r.dot(norm_a_));
-  Index b = (Index)floor(r.dot(norm_b_));
-  Index c = (Index)floor(r.dot(norm_c_));
+Index NBListGrid::getCell(Eigen::Vector3d &r) const {
+  Index a = (Index)std::floor(r.dot(norm_a_));
+  Index b = (Index)std::floor(r.dot(norm_b_));
+  Index c = (Index)std::floor(r.dot(norm_c_));
+
+  // number of periodic images the position is away from the box
+  auto image = [](Index i, Index n) {
+    return (i >= 0) ? i / n : -((n - 1 - i) / n);
+  };
+  Index ia = image(a, box_Na_);
+  Index ib = image(b, box_Nb_);
+  Index ic = image(c, box_Nc_);
+
+  r -= double(ia) * box_a_ + double(ib) * box_b_ + double(ic) * box_c_;
+  return getCell(a - ia * box_Na_, b - ib * box_Nb_, c - ic * box_Nc_);
+}
 
-  if (a < 0) {
-    a = box_Na_ + a % box_Na_;
+void NBListGrid::Search(const Topology &top) {
+  Index nbeads = Index(beads_.size());
+  Index ncells = box_Na_ * box_Nb_ * box_Nc_;
+
+  // sort the beads into the cells (counting sort)
+  pos_.resize(nbeads);
+  std::vector<Index> bead_cell(nbeads);
+  cell_start_.assign(ncells + 1, 0);
+  for (Index i = 0; i < nbeads; ++i) {
+    pos_[i] = beads_[i]->getPos();
+    bead_cell[i] = getCell(pos_[i]);
+    ++cell_start_[bead_cell[i] + 1];
+  }
+  for (Index cell = 0; cell < ncells; ++cell) {
+    cell_start_[cell + 1] += cell_start_[cell];
+  }
+  cell_beads_.resize(nbeads);
+  std::vector<Index> fill(cell_start_.begin(), cell_start_.end() - 1);
+  for (Index i = 0; i < nbeads; ++i) {
+    cell_beads_[fill[bead_cell[i]]++] = i;
   }
-  a %= box_Na_;
 
-  if (b < 0) {
-    b = box_Nb_ + b % box_Nb_;
+  // cells are processed in blocks, each block collects its own candidates
+  Index nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = Index(omp_get_max_threads());
+#endif
+  Index nblocks = std::min(ncells, 8 * nthreads);
+  std::vector<std::vector<candidate_t>> found(nblocks);
+  double cutoff2 = (cutoff_ + skin_) * (cutoff_ + skin_);
+
+#pragma omp parallel for schedule(dynamic) if (nthreads > 1 && nblocks > 1)
+  for (Index block = 0; block < nblocks; ++block) {
+    Index first_cell = ncells * block / nblocks;
+    Index last_cell = ncells * (block + 1) / nblocks;
+    for (Index cell = first_cell; cell < last_cell; ++cell) {
+      Index a = cell % box_Na_;
+      Index b = (cell / box_Na_) % box_Nb_;
+      Index c = cell / (box_Na_ * box_Nb_);
+      for (const auto &offset : offsets_) {
+        Index ua = a + offset[0];
+        Index ub = b + offset[1];
+        Index uc = c + offset[2];
+        Index wa = (ua + box_Na_) % box_Na_;
+        Index wb = (ub + box_Nb_) % box_Nb_;
+        Index wc = (uc + box_Nc_) % box_Nc_;
+        stencil_t neighbour;
+        neighbour.cell_ = getCell(wa, wb, wc);
+        if (!shift_per_cell_ && neighbour.cell_ < cell) {
+          continue;
+        }
+        if (!shift_per_cell_ && neighbour.cell_ == cell &&
+            offset != std::array<Index, 3>{0, 0, 0}) {
+          continue;
+        }
+        // ua - wa is either -N, 0 or N
+        neighbour.shift_ = double((ua - wa) / box_Na_) * box_a_ +
+                           double((ub - wb) / box_Nb_) * box_b_ +
+                           double((uc - wc) / box_Nc_) * box_c_;
+        TestCells(top, cell, neighbour, cutoff2, found[block]);
+      }
+    }
   }
-  b %= box_Nb_;
 
-  if (c < 0) {
-    c = box_Nc_ + c % box_Nc_;
+  ++rebuilds_;
+  if (skin_ > 0.0) {
+    // remember all pairs within cutoff + skin, but only hand out the ones
+    // within the cutoff
+    verlet_pairs_.clear();
+    double real_cutoff2 = cutoff_ * cutoff_;
+    for (auto &candidates : found) {
+      std::size_t kept = 0;
+      for (std::size_t k = 0; k < candidates.size(); ++k) {
+        verlet_pairs_.emplace_back(candidates[k].first_,
+                                   candidates[k].second_);
+        if (candidates[k].r_.squaredNorm() < real_cutoff2) {
+          candidates[kept++] = candidates[k];
+        }
+      }
+      candidates.resize(kept);
+    }
+    verlet_valid_ = true;
+    verlet_exclusions_ = do_exclusions_;
+    verlet_cutoff_ = cutoff_;
+    verlet_box_ = top.getBox();
+    verlet_beads_ = beads_;
+    verlet_in_list1_ = in_list1_;
+    verlet_in_list2_ = in_list2_;
+    verlet_pos_.resize(nbeads);
+    for (Index i = 0; i < nbeads; ++i) {
+      verlet_pos_[i] = beads_[i]->getPos();
+    }
   }
-  c %= box_Nc_;
 
-  return grid_(a, b, c);
+  CreatePairs(found);
 }
 
-void NBListGrid::TestBead(const Topology &top, NBListGrid::cell_t &cell,
-                          Bead *bead) {
-  TestCell(top, cell, bead);
-  for (auto &neighbour : cell.neighbours_) {
-    TestCell(top, *neighbour, bead);
+void NBListGrid::CreatePairs(
+    const std::vector<std::vector<candidate_t>> &found) {
+  // the match function might not be thread safe, so call it here in order
+  for (const auto &candidates : found) {
+    for (const candidate_t &pair : candidates) {
+      Bead *bead1 = beads_[pair.first_];
+      Bead *bead2 = beads_[pair.second_];
+      if ((*match_function_)(bead1, bead2, pair.r_, pair.dist_)) {
+        pair_creator_(*this, bead1, bead2, pair.r_);
+      }
+    }
   }
 }
 
-void NBListGrid::TestCell(const Topology &top, NBListGrid::cell_t &cell,
-                          Bead *bead) {
-  const Eigen::Vector3d &u = bead->getPos();
-
-  for (auto &bead_ : cell.beads_) {
-
-    const Eigen::Vector3d &v = bead_->getPos();
-    const Eigen::Vector3d &r = top.BCShortestConnection(v, u);
-    double d = r.norm();
-    if (d < cutoff_) {
-      if (do_exclusions_) {
-        if (top.getExclusions().IsExcluded(bead_, bead)) {
-          continue;
-        }
-      }
-      if ((*match_function_)(bead_, bead, r, d)) {
-        if (!FindPair(bead_, bead)) {
-          AddPair(pair_creator_(bead_, bead, r));
-        }
+void NBListGrid::TestCells(const Topology &top, Index cell,
+                           const stencil_t &neighbour, double cutoff2,
+                           std::vector<candidate_t> &found) const {
+  bool same_cell = (neighbour.cell_ == cell);
+  for (Index ii = cell_start_[cell]; ii < cell_start_[cell + 1]; ++ii) {
+    Index i = cell_beads_[ii];
+    Index jj_begin = same_cell ? ii + 1 : cell_start_[neighbour.cell_];
+    for (Index jj = jj_begin; jj < cell_start_[neighbour.cell_ + 1]; ++jj) {
+      Index j = cell_beads_[jj];
+      if (shift_per_cell_) {
+        TestPair(top, i, j, pos_[j] + neighbour.shift_ - pos_[i], cutoff2,
+                 found);
+      } else {
+        TestPair(top, i, j, top.BCShortestConnection(pos_[i], pos_[j]),
+                 cutoff2, found);
       }
     }
   }
 }
 
+void NBListGrid::TestPair(const Topology &top, Index i, Index j,
+                          const Eigen::Vector3d &r, double cutoff2,
+                          std::vector<candidate_t> &found) const {
+  // the first bead of a pair has to be from list1, the second from list2
+  bool forward = in_list1_[i] && in_list2_[j];
+  bool backward = in_list1_[j] && in_list2_[i];
+  if (!forward && !backward) {
+    return;
+  }
+  // if both are possible, keep the order of the lists
+  if (forward && backward) {
+    backward = (j < i);
+  }
+  double d2 = r.squaredNorm();
+  if (d2 >= cutoff2) {
+    return;
+  }
+  Index first = backward ? j : i;
+  Index second = backward ? i : j;
+  if (do_exclusions_ &&
+      top.getExclusions().IsExcluded(beads_[first], beads_[second])) {
+    return;
+  }
+  found.push_back(
+      candidate_t{first, second, backward ? Eigen::Vector3d(-r) : r,
+                  std::sqrt(d2)});
+}
+
 }  // namespace csg
 }  // namespace votca
@@ -15,6 +15,9 @@
  *
  */
 
+// Standard includes
+#include <exception>
+
 // Local VOTCA includes
 #include "votca/csg/nblistgrid_3body.h"
 #include "votca/csg/topology.h"
@@ -24,113 +27,53 @@ namespace csg {
 
 using namespace std;
 
-void NBListGrid_3Body::Generate(BeadList &list1, BeadList &list2,
-                                BeadList &list3, bool do_exclusions) {
-
-  do_exclusions_ = do_exclusions;
-  if (list1.empty()) {
-    return;
-  }
-  if (list2.empty()) {
-    return;
-  }
-  if (list3.empty()) {
-    return;
-  }
-
-  // check if all bead lists "have" the same topology
-  assert(&(list1.getTopology()) == &(list2.getTopology()));
-  assert(&(list1.getTopology()) == &(list3.getTopology()));
-  assert(&(list2.getTopology()) == &(list3.getTopology()));
-  const Topology &top = list1.getTopology();
-
-  InitializeGrid(top.getBox());
-
-  // Add all beads of list1 to  beads1_
-  for (auto &iter : list1) {
-    getCell(iter->getPos()).beads1_.push_back(iter);
-  }
-
-  // Add all beads of list2 to  beads2_
-  for (auto &iter : list2) {
-    getCell(iter->getPos()).beads2_.push_back(iter);
-  }
-
-  // Add all beads of list2 to  beads3_
-  for (auto &iter : list3) {
-    getCell(iter->getPos()).beads3_.push_back(iter);
-  }
-
-  // loop over beads of list 1 again to get the correlations
-  for (auto &iter : list1) {
-    cell_t &cell = getCell(iter->getPos());
-    TestBead(top, cell, iter);
-  }
-}
-
-void NBListGrid_3Body::Generate(BeadList &list1, BeadList &list2,
-                                bool do_exclusions) {
-  do_exclusions_ = do_exclusions;
-  if (list1.empty()) {
-    return;
-  }
-  if (list2.empty()) {
-    return;
-  }
-
-  // check if both bead lists "have" the same topology
-  assert(&(list1.getTopology()) == &(list2.getTopology()));
-  const Topology &top = list1.getTopology();
-
+void NBListGrid_3Body::SearchTriples(const Topology &top, BeadList &list1,
+                                     BeadList &list2, BeadList &list3,
+                                     TripleVisitor &visitor, bool parallel) {
   InitializeGrid(top.getBox());
 
-  // Add all beads of list1 to  beads1_
-  for (auto &bead : list1) {
-    getCell(bead->getPos()).beads1_.push_back(bead);
-  }
-
-  // Add all beads of list2 to  beads2_
+  // Add all beads of list2 to beads2_
   for (auto &bead : list2) {
     getCell(bead->getPos()).beads2_.push_back(bead);
   }
 
-  // In this case type2 and type3 are the same
-  for (auto &cell : grid_) {
-    cell.beads3_ = cell.beads2_;
-  }
-
-  // loop over beads of list 1 again to get the correlations
-  for (auto &bead : list1) {
-    cell_t &cell = getCell(bead->getPos());
-    TestBead(top, cell, bead);
-  }
-}
-
-void NBListGrid_3Body::Generate(BeadList &list, bool do_exclusions) {
-  do_exclusions_ = do_exclusions;
-  if (list.empty()) {
-    return;
-  }
-
-  const Topology &top = list.getTopology();
-
-  InitializeGrid(top.getBox());
-
-  // Add all beads of list to all! bead lists of the cell
-  for (auto &iter : list) {
-    getCell(iter->getPos()).beads1_.push_back(iter);
+  // Add all beads of list3 to beads3_, unless it is the same list
+  if (!same_lists23_) {
+    for (auto &bead : list3) {
+      getCell(bead->getPos()).beads3_.push_back(bead);
+    }
   }
 
-  for (auto &cell : grid_) {
-    cell.beads2_ = cell.beads1_;
-    cell.beads3_ = cell.beads1_;
+  std::exception_ptr error = nullptr;
+#pragma omp parallel if (parallel)
+  {
+    std::vector<Neighbour> neighbours2;
+    std::vector<Neighbour> neighbours3;
+    // loop over the central beads, the neighbouring cells include the cell
+    // of the bead itself
+#pragma omp for schedule(dynamic)
+    for (Index i = 0; i < list1.size(); ++i) {
+      try {
+        Bead *bead = *(list1.begin() + i);
+        const cell_t &cell = getCell(bead->getPos());
+        neighbours2.clear();
+        neighbours3.clear();
+        for (const cell_t *neighbour : cell.neighbours_) {
+          AddNeighbours(top, bead, neighbour->beads2_, neighbours2);
+          if (!same_lists23_) {
+            AddNeighbours(top, bead, neighbour->beads3_, neighbours3);
+          }
+        }
+        VisitNeighbours(top, bead, neighbours2,
+                        same_lists23_ ? neighbours2 : neighbours3, visitor);
+      } catch (...) {
+#pragma omp critical
+        error = std::current_exception();
+      }
+    }
   }
-
-  // loop over beads again to get the correlations (as all of the same type
-  // here)
-  for (auto &bead : list) {
-    cell_t &cell = getCell(bead->getPos());
-    TestBead(top, cell, bead);
+  if (error) {
+    std::rethrow_exception(error);
   }
 }
 
@@ -161,7 +104,7 @@ void NBListGrid_3Body::InitializeGrid(const Eigen::Matrix3d &box) {
   norm_b_ = norm_b_ / lb * (double)box_Nb_;
   norm_c_ = norm_c_ / lc * (double)box_Nc_;
 
-  grid_.resize(box_Na_ * box_Nb_ * box_Nc_);
+  grid_.assign(box_Na_ * box_Nb_ * box_Nc_, cell_t());
 
   Index a1, a2, b1, b2, c1, c2;
 
@@ -232,72 +175,5 @@ NBListGrid_3Body::cell_t &NBListGrid_3Body::getCell(const Eigen::Vector3d &r) {
   return getCell(a, b, c);
 }
 
-void NBListGrid_3Body::TestBead(const Topology &top,
-                                NBListGrid_3Body::cell_t &cell, Bead *bead) {
-  BeadList::iterator iter2;
-  BeadList::iterator iter3;
-  Eigen::Vector3d u = bead->getPos();
-
-  // loop over all neighbors (this now includes the cell itself!) to iterate
-  // over all beads of type2 of the cell and its neighbors
-  for (vector<cell_t *>::iterator iterc2 = cell.neighbours_.begin();
-       iterc2 != cell.neighbours_.end(); ++iterc2) {
-    for (iter2 = (*(*iterc2)).beads2_.begin();
-         iter2 != (*(*iterc2)).beads2_.end(); ++iter2) {
-
-      if (bead == *iter2) {
-        continue;
-      }
-
-      // loop again over all neighbors (this now includes the cell itself!)
-      // to iterate over all beads of type3 of the cell and its neighbors
-      for (auto &neighbour_ : cell.neighbours_) {
-        for (iter3 = (*neighbour_).beads3_.begin();
-             iter3 != (*neighbour_).beads3_.end(); ++iter3) {
-
-          // do not include the same beads twice in one triple!
-          if (bead == *iter3) {
-            continue;
-          }
-          if (*iter2 == *iter3) {
-            continue;
-          }
-
-          Eigen::Vector3d v = (*iter2)->getPos();
-          Eigen::Vector3d z = (*iter3)->getPos();
-
-          Eigen::Vector3d r12 = top.BCShortestConnection(u, v);
-          Eigen::Vector3d r13 = top.BCShortestConnection(u, z);
-          Eigen::Vector3d r23 = top.BCShortestConnection(v, z);
-          double d12 = r12.norm();
-          double d13 = r13.norm();
-          double d23 = r23.norm();
-
-          // to do: at the moment use only one cutoff value
-          // to do: so far only check the distance between bead 1 (central
-          // bead) and bead2 and bead 3
-          if ((d12 < cutoff_) && (d13 < cutoff_)) {
-            /// experimental: at the moment exclude interaction as soon as
-            /// one of the three pairs (1,2) (1,3) (2,3) is excluded!
-            if (do_exclusions_) {
-              if ((top.getExclusions().IsExcluded(bead, *iter2)) ||
-                  (top.getExclusions().IsExcluded(bead, *iter3)) ||
-                  (top.getExclusions().IsExcluded(*iter2, *iter3))) {
-                continue;
-              }
-            }
-            if ((*match_function_)(bead, *iter2, *iter3, r12, r13, r23, d12,
-                                   d13, d23)) {
-              if (!FindTriple(bead, *iter2, *iter3)) {
-                AddTriple(triple_creator_(bead, *iter2, *iter3, r12, r13, r23));
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-}
-
 }  // namespace csg
 }  // namespace votca
@@ -23,9 +23,7 @@ namespace csg {
 
 Eigen::Vector3d OrthorhombicBox::BCShortestConnection(
     const Eigen::Vector3d &r_i, const Eigen::Vector3d &r_j) const {
-  const Eigen::Array3d box = box_.diagonal();
-  const Eigen::Array3d r_ij = r_j - r_i;
-  return (r_ij - box * (r_ij / box).round()).matrix();
+  return MinimumImage<typeOrthorhombic>(r_j - r_i);
 }
 
 }  // namespace csg
@@ -101,5 +101,27 @@ void PotentialFunction::SavePotTab(const string &filename, double step,
   pot_tab.set(i, rcut, CalculateF(rcut), flag);
   pot_tab.Save(filename);
 }
+
+void PotentialFunction::CalculateDerivatives(const Eigen::VectorXd &r,
+                                             const Eigen::VectorXd &weight,
+                                             double &U, Eigen::VectorXd &dU,
+                                             Eigen::MatrixXd &d2U) const {
+  Index nopt = getOptParamSize();
+  U = 0.0;
+  dU = Eigen::VectorXd::Zero(nopt);
+  d2U = Eigen::MatrixXd::Zero(nopt, nopt);
+
+  for (Index k = 0; k < r.size(); k++) {
+    double w = weight(k);
+    U += w * CalculateF(r(k));
+    for (Index i = 0; i < nopt; i++) {
+      dU(i) += w * CalculateDF(i, r(k));
+      for (Index j = i; j < nopt; j++) {
+        d2U(i, j) += w * CalculateD2F(i, j, r(k));
+      }
+    }
+  }
+  d2U = d2U.selfadjointView<Eigen::Upper>();
+}
 }  // namespace csg
 }  // namespace votca
@@ -263,6 +263,49 @@ double PotentialFunctionCBSPL::CalculateDF(Index i, double r) const {
   }
 }
 
+void PotentialFunctionCBSPL::CalculateDerivatives(
+    const Eigen::VectorXd &r, const Eigen::VectorXd &weight, double &U,
+    Eigen::VectorXd &dU, Eigen::MatrixXd &d2U) const {
+
+  /* Each distance only contributes to the four coefficients of its knot
+   * interval, with weights given by the powers of t contracted with M_.
+   * So it suffices to sum up the powers of t per knot interval and to do
+   * the contraction once per interval instead of once per distance.
+   */
+  Index nintervals = nbreak_ - 1;
+  Eigen::MatrixXd moments = Eigen::MatrixXd::Zero(4, nintervals);
+  for (Index k = 0; k < r.size(); k++) {
+    if (r(k) > cut_off_) {
+      continue;
+    }
+    Index indx = std::min((Index)(r(k) / dr_), nbreak_ - 2);
+    double t = (r(k) - (double)indx * dr_) / dr_;
+    double w = weight(k);
+    moments(0, indx) += w;
+    moments(1, indx) += w * t;
+    moments(2, indx) += w * t * t;
+    moments(3, indx) += w * t * t * t;
+  }
+
+  // basis(m, indx) is the summed derivative w.r.t. coefficient indx + m
+  Eigen::MatrixXd basis = M_.transpose() * moments;
+
+  Index nopt = getOptParamSize();
+  U = 0.0;
+  dU = Eigen::VectorXd::Zero(nopt);
+  for (Index indx = 0; indx < nintervals; indx++) {
+    U += basis.col(indx).dot(lam_.segment<4>(indx));
+    for (Index m = 0; m < 4; m++) {
+      Index i = indx + m - nexcl_;
+      if (i >= 0 && i < nopt) {
+        dU(i) += basis(m, indx);
+      }
+    }
+  }
+  // the function is linear in the coefficients
+  d2U = Eigen::MatrixXd::Zero(nopt, nopt);
+}
+
 // calculate second derivative w.r.t. ith parameter
 double PotentialFunctionCBSPL::CalculateD2F(Index, Index, double) const {
 
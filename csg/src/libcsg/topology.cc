@@ -27,6 +27,7 @@
 
 // VOTCA includes
 #include <votca/tools/rangeparser.h>
+#include <votca/tools/tokenizer.h>
 
 // Local VOTCA includes
 #include "votca/csg/boundarycondition.h"
@@ -49,6 +50,7 @@ Topology::~Topology() { Cleanup(); }
 void Topology::Cleanup() {
   // cleanup beads
   beads_.clear();
+  coordinates_.clear();
 
   // cleanup molecules
   molecules_.clear();
@@ -56,14 +58,14 @@ void Topology::Cleanup() {
   // cleanup residues
   residues_.clear();
 
-  // cleanup interactions
-  {
-    for (InteractionContainer::iterator i = interactions_.begin();
-         i < interactions_.end(); ++i) {
-      delete (*i);
-    }
-    interactions_.clear();
-  }
+  // cleanup interactions, they are deleted by the last topology using them
+  interactions_.clear();
+  interaction_owners_.clear();
+  interaction_groups_.clear();
+  interactions_by_group_.clear();
+  // the exclusions refer to the beads
+  exclusions_.Clear();
+  ClearBeadSelections();
   // cleanup  bc_ object
   bc_ = std::make_unique<OpenBox>();
 }
@@ -130,6 +132,85 @@ void Topology::CopyTopologyData(Topology *top) {
   }
 }
 
+void Topology::ShareTopologyData(const Topology &top) {
+  Cleanup();
+
+  setBox(top.getBox(), top.getBoxType());
+  time_ = top.time_;
+  step_ = top.step_;
+  has_vel_ = top.has_vel_;
+  has_force_ = top.has_force_;
+  particle_group_ = top.particle_group_;
+
+  beadtypes_ = top.beadtypes_;
+  residues_ = top.residues_;
+  beads_ = top.beads_;
+  // the copied beads have to refer to the coordinates of this topology
+  coordinates_ = top.coordinates_;
+  for (auto &bead : beads_) {
+    bead.coordinates_ = &coordinates_;
+  }
+
+  for (const auto &molecule : top.molecules_) {
+    Molecule *mi = CreateMolecule(molecule.getName());
+    for (Index i = 0; i < molecule.BeadCount(); i++) {
+      Index beadid = molecule.getBead(i)->getId();
+      mi->AddBead(&beads_[beadid], molecule.getBeadName(i));
+    }
+    for (Interaction *ic : molecule.Interactions()) {
+      mi->AddInteraction(ic);
+    }
+  }
+
+  interactions_ = top.interactions_;
+  interaction_owners_ = top.interaction_owners_;
+  interaction_groups_ = top.interaction_groups_;
+  interactions_by_group_ = top.interactions_by_group_;
+
+  // exclusions refer to the beads, so they have to be mapped to the copies
+  exclusions_.Clear();
+  std::vector<Bead *> excluded;
+  for (const auto *exclusion : top.exclusions_) {
+    excluded.clear();
+    for (const Bead *bead : exclusion->exclude_) {
+      excluded.push_back(&beads_[bead->getId()]);
+    }
+    exclusions_.InsertExclusion(&beads_[exclusion->atom_->getId()], excluded);
+  }
+  if (top.exclusions_.HasLookupTable()) {
+    exclusions_.BuildLookupTable();
+  }
+}
+
+void Topology::CopyFrameData(const Topology &top) {
+  if (top.BeadCount() != BeadCount()) {
+    throw runtime_error(
+        "CopyFrameData: topologies have a different number of beads");
+  }
+  setBox(top.getBox(), top.getBoxType());
+  time_ = top.time_;
+  step_ = top.step_;
+  has_vel_ = top.has_vel_;
+  has_force_ = top.has_force_;
+
+  coordinates_.pos_ = top.coordinates_.pos_;
+  coordinates_.vel_ = top.coordinates_.vel_;
+  coordinates_.force_ = top.coordinates_.force_;
+  for (Index i = 0; i < BeadCount(); ++i) {
+    const Bead &from = top.beads_[i];
+    Bead &to = beads_[i];
+    to.bead_position_set_ = from.bead_position_set_;
+    to.bead_velocity_set_ = from.bead_velocity_set_;
+    to.bead_force_set_ = from.bead_force_set_;
+    to.u_ = from.u_;
+    to.v_ = from.v_;
+    to.w_ = from.w_;
+    to.bU_ = from.bU_;
+    to.bV_ = from.bV_;
+    to.bW_ = from.bW_;
+  }
+}
+
 Index Topology::getBeadTypeId(string type) const {
   assert(beadtypes_.count(type));
   return beadtypes_.at(type);
@@ -155,6 +236,33 @@ void Topology::RenameBeadType(string name, string newname) {
       bead.setType(newname);
     }
   }
+  ClearBeadSelections();
+}
+
+const std::vector<Index> &Topology::SelectBeads(const string &select) {
+  auto cached = bead_selections_.find(select);
+  if (cached != bead_selections_.end()) {
+    return cached->second;
+  }
+
+  bool selectByName = false;
+  string pSelect;  // parsed selection string
+  if (select.substr(0, 5) == "name:") {
+    // select according to bead name instead of type
+    pSelect = select.substr(5);
+    selectByName = true;
+  } else {
+    pSelect = select;
+  }
+
+  std::vector<Index> &ids = bead_selections_[select];
+  for (const auto &bead : beads_) {
+    const string &key = selectByName ? bead.getName() : bead.getType();
+    if (tools::wildcmp(pSelect, key)) {
+      ids.push_back(bead.getId());
+    }
+  }
+  return ids;
 }
 
 void Topology::SetBeadTypeMass(string name, double value) {
@@ -195,6 +303,7 @@ void Topology::AddBondedInteraction(Interaction *ic) {
     ic->setGroupId(i);
   }
   interactions_.push_back(ic);
+  interaction_owners_.emplace_back(ic);
   interactions_by_group_[ic->getGroup()].push_back(ic);
 }
 
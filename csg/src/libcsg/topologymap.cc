@@ -15,6 +15,13 @@
  *
  */
 
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
 // Local VOTCA includes
 #include "votca/csg/topologymap.h"
 #include "votca/csg/boundarycondition.h"
@@ -22,13 +29,154 @@
 namespace votca {
 namespace csg {
 
+void TopologyMap::Initialize() {
+  row_start_.assign(1, 0);
+  atom_index_.clear();
+  weight_.clear();
+  force_weight_.clear();
+  cg_index_.clear();
+  molecule_start_.assign(1, 0);
+  max_molecule_entries_ = 0;
+
+  for (const Map &map : maps_) {
+    Index molecule_entries = row_start_.back();
+    for (const auto &bead_map : map.BeadMaps()) {
+      double mass = 0;
+      for (const BeadMap::element_t &el : bead_map->Elements()) {
+        atom_index_.push_back(el.in_->getId());
+        weight_.push_back(el.weight_);
+        force_weight_.push_back(el.force_weight_);
+        mass += el.in_->getMass();
+      }
+      row_start_.push_back(Index(atom_index_.size()));
+      // the masses do not change from frame to frame
+      bead_map->getOut()->setMass(mass);
+      cg_index_.push_back(bead_map->getOut()->getId());
+    }
+    molecule_start_.push_back(Index(cg_index_.size()));
+    molecule_entries = row_start_.back() - molecule_entries;
+    max_molecule_entries_ = std::max(max_molecule_entries_, molecule_entries);
+  }
+  initialized_ = true;
+}
+
+void TopologyMap::MapMolecule(Index mol, const BoundaryCondition& bc,
+                              Eigen::Matrix3Xd& ref, Eigen::Matrix3Xd& pos,
+                              Eigen::Matrix3Xd& unwrapped,
+                              Eigen::VectorXd& dist2) {
+  const BeadCoordinates& in = in_->getBeadCoordinates();
+  BeadCoordinates& out = out_->getBeadCoordinates();
+  Index first_row = molecule_start_[mol];
+  Index last_row = molecule_start_[mol + 1];
+  Index offset = row_start_[first_row];
+  Index n = row_start_[last_row] - offset;
+
+  // connections of all atoms of the molecule to the first atom of their
+  // coarse-grained bead, at once for the whole molecule
+  for (Index row = first_row; row < last_row; ++row) {
+    const Eigen::Vector3d& r0 = in.pos_[atom_index_[row_start_[row]]];
+    for (Index k = row_start_[row]; k < row_start_[row + 1]; ++k) {
+      ref.col(k - offset) = r0;
+      pos.col(k - offset) = in.pos_[atom_index_[k]];
+    }
+  }
+  bc.BCShortestConnectionsPairwise(ref.leftCols(n), pos.leftCols(n),
+                                   unwrapped.leftCols(n), dist2.head(n));
+
+  bool check_size = bc.getBoxType() != BoundaryCondition::eBoxtype::typeOpen;
+  double max_dist = 0.5 * bc.getShortestBoxDimension();
+
+  for (Index row = first_row; row < last_row; ++row) {
+    Index begin = row_start_[row];
+    Index end = row_start_[row + 1];
+    if (begin == end) {
+      continue;
+    }
+    const Bead* first = in_->getBead(atom_index_[begin]);
+    Index cg = cg_index_[row];
+    Bead* out_bead = out_->getBead(cg);
+
+    if (first->HasPos()) {
+      const Eigen::Vector3d& r0 = in.pos_[atom_index_[begin]];
+      Eigen::Vector3d cg_pos = Eigen::Vector3d::Zero();
+      Index max_k = begin;
+      for (Index k = begin; k < end; ++k) {
+        cg_pos += weight_[k] * (unwrapped.col(k - offset) + r0);
+        if (dist2(k - offset) > dist2(max_k - offset)) {
+          max_k = k;
+        }
+      }
+      /// Safety check, if box is not open check if the bead is larger than
+      /// the boundaries
+      if (check_size && std::sqrt(dist2(max_k - offset)) > max_dist) {
+        const Bead* bead_max_dist = in_->getBead(atom_index_[max_k]);
+        throw std::runtime_error(
+            "coarse-grained bead is bigger than half the box \n "
+            "(atoms " +
+            first->getName() + " (id " + std::to_string(first->getId() + 1) +
+            ")" + ", " + bead_max_dist->getName() + " (id " +
+            std::to_string(bead_max_dist->getId() + 1) + ")" +
+            " , molecule " +
+            std::to_string(bead_max_dist->getMoleculeId() + 1) + ")");
+      }
+      out.pos_[cg] = cg_pos;
+      out_bead->HasPos(true);
+    }
+    if (first->HasVel()) {
+      Eigen::Vector3d cg_vel = Eigen::Vector3d::Zero();
+      for (Index k = begin; k < end; ++k) {
+        cg_vel += weight_[k] * in.vel_[atom_index_[k]];
+      }
+      out.vel_[cg] = cg_vel;
+      out_bead->HasVel(true);
+    }
+    if (first->HasF()) {
+      Eigen::Vector3d cg_force = Eigen::Vector3d::Zero();
+      for (Index k = begin; k < end; ++k) {
+        cg_force += force_weight_[k] * in.force_[atom_index_[k]];
+      }
+      out.force_[cg] = cg_force;
+      out_bead->HasF(true);
+    }
+  }
+
+  // e.g. the orientation of ellipsoidal beads
+  maps_[mol].Apply();
+}
+
 void TopologyMap::Apply() {
+  if (!initialized_) {
+    Initialize();
+  }
   out_->setStep(in_->getStep());
   out_->setTime(in_->getTime());
   out_->setBox(in_->getBox());
 
-  for (auto& map_ : maps_) {
-    map_.Apply(out_->getBoundary());
+  const BoundaryCondition& bc = out_->getBoundary();
+  Index nmaps = Index(maps_.size());
+  // every molecule map only writes to its own beads
+  std::exception_ptr error;
+#pragma omp parallel if (parallel_ && nmaps > 1000)
+  {
+    // scratch space for the unwrapping, shared by the molecules of a thread
+    Eigen::Matrix3Xd ref(3, max_molecule_entries_);
+    Eigen::Matrix3Xd pos(3, max_molecule_entries_);
+    Eigen::Matrix3Xd unwrapped(3, max_molecule_entries_);
+    Eigen::VectorXd dist2(max_molecule_entries_);
+#pragma omp for schedule(static)
+    for (Index i = 0; i < nmaps; ++i) {
+      try {
+        MapMolecule(i, bc, ref, pos, unwrapped, dist2);
+      } catch (...) {
+#pragma omp critical
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
   }
 }
 
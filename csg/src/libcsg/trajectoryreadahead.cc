@@ -0,0 +1,115 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard includes
+#include <stdexcept>
+
+// Local VOTCA includes
+#include "votca/csg/trajectoryreadahead.h"
+
+namespace votca {
+namespace csg {
+
+TrajectoryReadAhead::TrajectoryReadAhead(TrajectoryReader &reader,
+                                         const Topology &top, Index nbuffers,
+                                         Index nframes)
+    : reader_(reader), nframes_(nframes) {
+  if (nbuffers < 1) {
+    throw std::runtime_error("TrajectoryReadAhead needs at least one buffer");
+  }
+  for (Index i = 0; i < nbuffers; ++i) {
+    buffers_.push_back(std::make_unique<Topology>());
+    buffers_.back()->ShareTopologyData(top);
+    free_.push_back(buffers_.back().get());
+  }
+}
+
+void TrajectoryReadAhead::Run() {
+  Index nread = 0;
+  while (true) {
+    Topology *frame = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this]() { return stop_ || !free_.empty(); });
+      if (stop_) {
+        break;
+      }
+      frame = free_.front();
+      free_.pop_front();
+    }
+
+    bool ok = false;
+    if (nframes_ < 0 || nread < nframes_) {
+      try {
+        ok = reader_.NextFrame(*frame);
+      } catch (...) {
+        ok = false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (ok) {
+        ready_.push_back(frame);
+        ++nread;
+      } else {
+        free_.push_back(frame);
+        done_ = true;
+      }
+    }
+    changed_.notify_all();
+    if (!ok) {
+      break;
+    }
+  }
+}
+
+Topology *TrajectoryReadAhead::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock,
+                [this]() { return stop_ || done_ || !ready_.empty(); });
+  if (!ready_.empty()) {
+    Topology *frame = ready_.front();
+    ready_.pop_front();
+    return frame;
+  }
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return nullptr;
+}
+
+void TrajectoryReadAhead::Release(Topology *frame) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(frame);
+  }
+  changed_.notify_all();
+}
+
+void TrajectoryReadAhead::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  changed_.notify_all();
+}
+
+}  // namespace csg
+}  // namespace votca
@@ -24,6 +24,7 @@
 #include "votca/csg/xyzreader.h"
 
 // Local private VOTCA includes
+#include "modules/io/cgmdtrajectoryreader.h"
 #include "modules/io/dlpolytrajectoryreader.h"
 #ifdef H5MD
 #include "modules/io/h5mdtrajectoryreader.h"
@@ -51,6 +52,7 @@ void TrajectoryReader::RegisterPlugins(void) {
   TrjReaderFactory().Register<PDBReader>("pdb");
   TrjReaderFactory().Register<DLPOLYTrajectoryReader>("dlph");
   TrjReaderFactory().Register<DLPOLYTrajectoryReader>("dlpc");
+  TrjReaderFactory().Register<CGMDTrajectoryReader>("cgmd");
 #ifdef H5MD
   TrjReaderFactory().Register<H5MDTrajectoryReader>("h5");
 #endif
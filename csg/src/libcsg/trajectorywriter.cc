@@ -30,6 +30,9 @@
 #include "modules/io/gmxtrajectorywriter.h"
 #endif
 #include "modules/io/growriter.h"
+#ifdef H5MD
+#include "modules/io/h5mdtrajectorywriter.h"
+#endif
 #include "modules/io/lammpsdumpwriter.h"
 
 namespace votca {
@@ -48,6 +51,9 @@ void TrajectoryWriter::RegisterPlugins() {
   TrjWriterFactory().Register<GMXTrajectoryWriter>("xtc");
 #endif
   TrjWriterFactory().Register<GROWriter>("gro");
+#ifdef H5MD
+  TrjWriterFactory().Register<H5MDTrajectoryWriter>("h5");
+#endif
 }
 }  // namespace csg
 }  // namespace votca
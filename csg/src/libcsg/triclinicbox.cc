@@ -33,10 +33,7 @@ namespace csg {
  */
 Eigen::Vector3d TriclinicBox::BCShortestConnection(
     const Eigen::Vector3d &r_i, const Eigen::Vector3d &r_j) const {
-  Eigen::Vector3d r_tp = r_j - r_i;
-  Eigen::Vector3d r_dp = r_tp - box_.col(2) * std::round(r_tp.z() / box_(2, 2));
-  Eigen::Vector3d r_sp = r_dp - box_.col(1) * std::round(r_dp.y() / box_(1, 1));
-  return r_sp - box_.col(0) * std::round(r_sp.x() / box_(0, 0));
+  return MinimumImage<typeTriclinic>(r_j - r_i);
 }
 
 }  // namespace csg
@@ -20,13 +20,18 @@
 #define BOOST_TEST_MODULE bondedstatistics_test
 
 // Standard includes
+#include <cmath>
 #include <iostream>
 #include <map>
+#include <numeric>
 #include <string>
 
 // Third party includes
 #include <boost/test/unit_test.hpp>
 
+// VOTCA includes
+#include <votca/tools/histogram.h>
+
 // Local VOTCA includes
 #include "../csg_boltzmann/bondedstatistics.h"
 
@@ -142,4 +147,153 @@ BOOST_AUTO_TEST_CASE(test_evalconfiguration_begin) {
 
   top.Cleanup();
 }
+BOOST_AUTO_TEST_CASE(test_bondedaccumulator) {
+  BondedAccumulator acc(0.01, 4);
+  vector<double> values{1.0, 1.5, 2.0, 1.25, 1.75, 1.0, 2.0, 1.5};
+  for (double value : values) {
+    acc.Add(value);
+  }
+  BOOST_CHECK_EQUAL(acc.Count(), 8);
+  BOOST_CHECK_CLOSE(acc.Mean(), 1.5, 1e-10);
+  // sample variance
+  BOOST_CHECK_CLOSE(acc.Variance(), 1.125 / 7.0, 1e-10);
+  BOOST_CHECK_EQUAL(acc.Min(), 1.0);
+  BOOST_CHECK_EQUAL(acc.Max(), 2.0);
+
+  vector<double> bins;
+  vector<double> weights;
+  acc.AppendBins(bins, weights);
+  BOOST_REQUIRE_EQUAL(bins.size(), 5);
+  BOOST_CHECK_CLOSE(bins.front(), 1.005, 1e-8);
+  BOOST_CHECK_EQUAL(weights.front(), 2.0);
+  // the last bin center is clamped to the largest value
+  BOOST_CHECK_EQUAL(bins.back(), 2.0);
+  BOOST_CHECK_EQUAL(weights.back(), 2.0);
+
+  // the bins are merged once the range of values gets too large
+  BondedAccumulator wide(1e-5, 0);
+  for (votca::Index i = 0; i <= 1000; ++i) {
+    wide.Add(0.001 * double(i));
+  }
+  BOOST_CHECK_GE(wide.Resolution(),
+                 1.0 / double(BondedAccumulator::max_bins_));
+  bins.clear();
+  weights.clear();
+  wide.AppendBins(bins, weights);
+  BOOST_CHECK_LE(bins.size(), BondedAccumulator::max_bins_);
+  BOOST_CHECK_EQUAL(std::accumulate(weights.begin(), weights.end(), 0.0),
+                    1001.0);
+  BOOST_CHECK_LT(bins.front(), wide.Resolution());
+  BOOST_CHECK_GT(bins.back(), 1.0 - wide.Resolution());
+
+  BOOST_REQUIRE(acc.HasCorrelation());
+  vector<votca::Index> lags;
+  vector<double> correlation;
+  acc.Autocorrelation(lags, correlation);
+  BOOST_REQUIRE_GE(lags.size(), 2);
+  BOOST_CHECK_EQUAL(lags[0], 0);
+  double c0 = 0;
+  double c1 = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    c0 += values[i] * values[i];
+    if (i > 0) {
+      c1 += values[i] * values[i - 1];
+    }
+  }
+  BOOST_CHECK_CLOSE(correlation[0], c0 / 8.0, 1e-10);
+  BOOST_CHECK_EQUAL(lags[1], 1);
+  BOOST_CHECK_CLOSE(correlation[1], c1 / 7.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(test_seriesstore) {
+  SeriesStore store;
+  store.Open("test_seriesstore.bin", 3, 4);
+  for (votca::Index i = 0; i < 10; ++i) {
+    store.Append({double(i), 10.0 + double(i), -double(i)});
+  }
+  BOOST_CHECK_EQUAL(store.Rows(), 10);
+  vector<double> column = store.ReadColumn(1);
+  BOOST_REQUIRE_EQUAL(column.size(), 10);
+  for (votca::Index i = 0; i < 10; ++i) {
+    BOOST_CHECK_EQUAL(column[i], 10.0 + double(i));
+  }
+  column = store.ReadColumn(2);
+  BOOST_CHECK_EQUAL(column[9], -9.0);
+  store.Close();
+  BOOST_CHECK(!store.IsOpen());
+}
+
+BOOST_AUTO_TEST_CASE(test_streaming) {
+  Topology top;
+  auto bond1 = new IBond(0, 1);
+  bond1->setGroup("covalent_bond1");
+  auto bond2 = new IBond(1, 2);
+  bond2->setGroup("covalent_bond2");
+  top.AddBondedInteraction(bond1);
+  top.AddBondedInteraction(bond2);
+
+  BondedStatistics classic;
+  BondedStatistics streaming;
+  streaming.setStreaming(1e-5, 0, "test_streaming.bin");
+  classic.BeginCG(&top, nullptr);
+  streaming.BeginCG(&top, nullptr);
+  BOOST_CHECK(streaming.IsStreaming());
+  BOOST_CHECK(streaming.HasSeries());
+
+  for (votca::Index i = 0; i < 2000; ++i) {
+    vector<double> values{1.0 + 0.5 * std::sin(0.1 * double(i)),
+                          2.0 + 0.25 * std::cos(0.37 * double(i))};
+    classic.AddFrame(values);
+    streaming.AddFrame(values);
+  }
+  // nothing is kept in memory
+  BOOST_CHECK_EQUAL(streaming.BondedValues().Data().size(), 0);
+
+  vector<votca::Index> sel = streaming.Select("*bond2");
+  BOOST_REQUIRE_EQUAL(sel.size(), 1);
+  BOOST_CHECK_EQUAL(streaming.Names()[sel[0]], ":covalent_bond2");
+
+  // the histograms agree up to the resolution of the accumulators
+  Histogram::options_t options;
+  options.n_ = 21;
+  options.normalize_ = false;
+  Histogram h_classic(options);
+  DataCollection<double>::selection *sel_classic =
+      classic.SelectSeries({"*bond1"});
+  h_classic.ProcessData(sel_classic);
+  delete sel_classic;
+
+  const BondedAccumulator &acc = streaming.Accumulator(0);
+  vector<double> bins;
+  vector<double> weights;
+  acc.AppendBins(bins, weights);
+  Histogram h_streaming(options);
+  h_streaming.ProcessWeightedData(bins, weights, acc.Min(), acc.Max());
+
+  BOOST_CHECK_CLOSE(h_streaming.getMin(), h_classic.getMin(), 1e-10);
+  BOOST_CHECK_CLOSE(h_streaming.getMax(), h_classic.getMax(), 1e-10);
+  double differences = 0;
+  double total = 0;
+  for (votca::Index i = 0; i < options.n_; ++i) {
+    differences += std::abs(h_streaming.getPdf()[i] - h_classic.getPdf()[i]);
+    total += h_classic.getPdf()[i];
+  }
+  BOOST_CHECK_EQUAL(total, 2000.0);
+  BOOST_CHECK_LT(differences, 0.02 * total);
+
+  // the series are read back from the store
+  DataCollection<double>::selection *sel_streaming =
+      streaming.SelectSeries({"*bond1"});
+  sel_classic = classic.SelectSeries({"*bond1"});
+  BOOST_REQUIRE_EQUAL(sel_streaming->size(), 1);
+  BOOST_REQUIRE_EQUAL((*sel_streaming)[0].size(), 2000);
+  for (votca::Index i = 0; i < 2000; ++i) {
+    BOOST_CHECK_EQUAL((*sel_streaming)[0][i], (*sel_classic)[0][i]);
+  }
+  delete sel_streaming;
+  delete sel_classic;
+
+  top.Cleanup();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
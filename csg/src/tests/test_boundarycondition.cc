@@ -26,6 +26,9 @@
 // Third party includes
 #include <boost/test/unit_test.hpp>
 
+// VOTCA includes
+#include <votca/tools/types.h>
+
 // Local VOTCA includes
 #include "votca/csg/openbox.h"
 #include "votca/csg/orthorhombicbox.h"
@@ -126,4 +129,49 @@ BOOST_AUTO_TEST_CASE(test_boundarycondition_clone) {
   BOOST_CHECK_EQUAL(boundaries.at(1)->BoxVolume(), 0.0);
   BOOST_CHECK_EQUAL(boundaries.at(2)->BoxVolume(), 0.0);
 }
+
+BOOST_AUTO_TEST_CASE(test_boundarycondition_shortestconnections) {
+  vector<unique_ptr<BoundaryCondition>> boundaries;
+
+  boundaries.push_back(std::make_unique<OpenBox>());
+  boundaries.push_back(std::make_unique<TriclinicBox>());
+  boundaries.push_back(std::make_unique<OrthorhombicBox>());
+
+  Eigen::Matrix3d box = Eigen::Matrix3d::Zero();
+  box(0, 0) = 3.0;
+  box(1, 1) = 4.0;
+  box(2, 2) = 5.0;
+  boundaries.at(0)->setBox(box);
+  boundaries.at(2)->setBox(box);
+  box(0, 1) = 1.0;
+  box(0, 2) = 0.5;
+  box(1, 2) = 1.5;
+  boundaries.at(1)->setBox(box);
+
+  Eigen::Vector3d r_i(0.2, 0.3, 0.4);
+  Eigen::Matrix3Xd r_j(3, 5);
+  r_j << 2.9, 0.1, -3.7, 7.2, 1.0, 3.8, 0.2, 2.5, -6.1, 2.0, 4.9, 0.1, -1.2,
+      8.3, 2.5;
+
+  for (const auto &bc : boundaries) {
+    Eigen::Matrix3Xd r_ij(3, r_j.cols());
+    Eigen::VectorXd dist2(r_j.cols());
+    bc->BCShortestConnections(r_i, r_j, r_ij, dist2);
+    for (votca::Index k = 0; k < r_j.cols(); ++k) {
+      Eigen::Vector3d ref = bc->BCShortestConnection(r_i, r_j.col(k));
+      BOOST_CHECK(r_ij.col(k).isApprox(ref, 1e-12));
+      BOOST_CHECK_CLOSE(dist2(k), ref.squaredNorm(), 1e-10);
+    }
+
+    Eigen::Matrix3Xd r_i_all = r_j.rowwise().reverse();
+    bc->BCShortestConnectionsPairwise(r_i_all, r_j, r_ij, dist2);
+    for (votca::Index k = 0; k < r_j.cols(); ++k) {
+      Eigen::Vector3d ref =
+          bc->BCShortestConnection(r_i_all.col(k), r_j.col(k));
+      BOOST_CHECK(r_ij.col(k).isApprox(ref, 1e-12) || ref.norm() < 1e-12);
+      BOOST_CHECK_SMALL(dist2(k) - ref.squaredNorm(), 1e-10);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
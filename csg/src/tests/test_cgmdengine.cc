@@ -0,0 +1,136 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE cgmdengine_test
+
+// Standard includes
+#include <cmath>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// VOTCA includes
+#include <votca/tools/table.h>
+#include <votca/tools/types.h>
+
+// Local VOTCA includes
+#include "votca/csg/bead.h"
+#include "votca/csg/cgmdengine.h"
+#include "votca/csg/topology.h"
+
+using namespace votca::csg;
+
+namespace {
+
+// soft repulsion A (1 - r/rc)^2
+votca::tools::Table SoftPotential(double a, double rc) {
+  votca::tools::Table table;
+  table.GenerateGridSpacing(0.0, rc, 0.001);
+  for (votca::Index i = 0; i < table.size(); ++i) {
+    double x = 1.0 - table.x(i) / rc;
+    table.y(i) = a * x * x;
+  }
+  return table;
+}
+
+// beads on a slightly distorted cubic lattice
+void CreateTopology(Topology &top, votca::Index n, double spacing) {
+  top.RegisterBeadType("A");
+  Eigen::Matrix3d box = Eigen::Matrix3d::Identity() * double(n) * spacing;
+  top.setBox(box);
+  for (votca::Index i = 0; i < n * n * n; ++i) {
+    Bead *b = top.CreateBead(Bead::spherical, "A", "A", 0, 10.0, 0.0);
+    Eigen::Vector3d pos(double(i % n), double((i / n) % n), double(i / n / n));
+    pos += 0.1 * Eigen::Vector3d(std::sin(double(i)), std::cos(double(i)),
+                                 std::sin(2.0 * double(i)));
+    b->setPos(spacing * pos);
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(cgmdengine_test)
+
+BOOST_AUTO_TEST_CASE(test_pair_force) {
+  Topology top;
+  top.RegisterBeadType("A");
+  top.setBox(Eigen::Matrix3d::Identity() * 5.0);
+  top.CreateBead(Bead::spherical, "A1", "A", 0, 1.0, 0.0);
+  top.CreateBead(Bead::spherical, "A2", "A", 0, 1.0, 0.0);
+  Bead *b1 = top.getBead(0);
+  Bead *b2 = top.getBead(1);
+  b1->setPos(Eigen::Vector3d(1.0, 1.0, 1.0));
+  b2->setPos(Eigen::Vector3d(1.3, 1.4, 1.0));
+
+  CGMDEngine engine;
+  engine.AddNonbondedTable("A", "A", SoftPotential(100.0, 1.0));
+  engine.setSkin(0.0);
+  engine.Initialize(top);
+
+  // r = 0.5, U = 100 * 0.25, |F| = 2 * 100 * 0.5
+  BOOST_CHECK_CLOSE(engine.PotentialEnergy(), 25.0, 1e-6);
+  Eigen::Vector3d f2 = 100.0 * Eigen::Vector3d(0.6, 0.8, 0.0);
+  BOOST_CHECK(b2->getF().isApprox(f2, 1e-4));
+  BOOST_CHECK(b1->getF().isApprox(-f2, 1e-4));
+}
+
+BOOST_AUTO_TEST_CASE(test_energy_conservation) {
+  Topology top;
+  CreateTopology(top, 4, 0.8);
+
+  CGMDEngine engine;
+  engine.AddNonbondedTable("A", "A", SoftPotential(25.0, 1.0));
+  engine.setFriction(0.0);
+  engine.setTimeStep(0.005);
+  engine.setSeed(7);
+  engine.Initialize(top);
+
+  double e0 = engine.PotentialEnergy() + engine.KineticEnergy();
+  engine.Integrate(2000);
+  double e1 = engine.PotentialEnergy() + engine.KineticEnergy();
+  BOOST_CHECK_EQUAL(top.getStep(), 2000);
+  BOOST_CHECK_CLOSE(top.getTime(), 10.0, 1e-10);
+  BOOST_CHECK_SMALL((e1 - e0) / engine.KineticEnergy(), 1e-2);
+}
+
+BOOST_AUTO_TEST_CASE(test_langevin_temperature) {
+  Topology top;
+  CreateTopology(top, 5, 0.8);
+
+  CGMDEngine engine;
+  engine.AddNonbondedTable("A", "A", SoftPotential(25.0, 1.0));
+  engine.setKBT(2.0);
+  engine.setFriction(5.0);
+  engine.setTimeStep(0.005);
+  engine.setSeed(3);
+  engine.Initialize(top);
+  engine.Integrate(500);
+
+  double ekin = 0.0;
+  votca::Index samples = 200;
+  for (votca::Index i = 0; i < samples; ++i) {
+    engine.Integrate(10);
+    ekin += engine.KineticEnergy();
+  }
+  ekin /= double(samples);
+  double expected = 1.5 * double(top.BeadCount()) * 2.0;
+  BOOST_CHECK_CLOSE(ekin, expected, 5.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
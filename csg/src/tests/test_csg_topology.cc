@@ -18,13 +18,16 @@
 #define BOOST_TEST_MODULE csg_topology_test
 
 // Standard includes
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 // Third party includes
 #include <boost/test/tools/floating_point_comparison.hpp>
 #include <boost/test/unit_test.hpp>
 
 // Local VOTCA includes
+#include "votca/csg/beadlist.h"
 #include "votca/csg/topology.h"
 
 using namespace std;
@@ -155,4 +158,177 @@ BOOST_AUTO_TEST_CASE(add_bonded_interation_test) {
   top.Cleanup();
 }
 
+BOOST_AUTO_TEST_CASE(share_topology_data_test) {
+  Topology copy;
+  {
+    Topology top;
+    top.setBox(3 * Eigen::Matrix3d::Identity());
+    top.RegisterBeadType("type1");
+    Molecule *mol = top.CreateMolecule("mol");
+    for (votca::Index i = 0; i < 3; ++i) {
+      Bead *bead = top.CreateBead(Bead::spherical, "bead" + to_string(i),
+                                  "type1", 1, 1.0 + double(i), 0.1);
+      bead->setPos(Eigen::Vector3d(double(i), 0.0, 0.0));
+      mol->AddBead(bead, "b" + to_string(i));
+    }
+    auto bond1 = new IBond(0, 1);
+    bond1->setGroup("bond");
+    auto bond2 = new IBond(1, 2);
+    bond2->setGroup("bond");
+    top.AddBondedInteraction(bond1);
+    top.AddBondedInteraction(bond2);
+    mol->AddInteraction(bond1);
+    mol->AddInteraction(bond2);
+    top.RebuildExclusions();
+
+    copy.ShareTopologyData(top);
+
+    BOOST_CHECK_EQUAL(copy.BeadCount(), 3);
+    BOOST_CHECK_EQUAL(copy.MoleculeCount(), 1);
+    BOOST_CHECK(copy.getBoxType() == BoundaryCondition::typeOrthorhombic);
+    // the interactions are shared, the beads are not
+    BOOST_CHECK_EQUAL(copy.BondedInteractions().at(0), bond1);
+    BOOST_CHECK_EQUAL(copy.InteractionsInGroup("bond").size(), 2);
+    BOOST_CHECK(copy.getBead(0) != top.getBead(0));
+    BOOST_CHECK_EQUAL(copy.getMolecule(0)->getBead(2), copy.getBead(2));
+    BOOST_CHECK_EQUAL(copy.getMolecule(0)->getBeadName(1), "b1");
+    BOOST_CHECK_CLOSE(copy.getBead(2)->getMass(), 3.0, 1e-10);
+
+    // moving a bead of the copy does not affect the original
+    copy.getBead(1)->setPos(Eigen::Vector3d(1.0, 1.0, 0.0));
+    BOOST_CHECK_CLOSE(top.getBead(1)->getPos().x(), 1.0, 1e-10);
+    BOOST_CHECK_CLOSE(top.getBead(1)->getPos().y() + 1.0, 1.0, 1e-10);
+  }
+
+  // the shared interactions outlive the original topology
+  BOOST_CHECK_CLOSE(copy.BondedInteractions().at(0)->EvaluateVar(copy),
+                    std::sqrt(2.0), 1e-10);
+  BOOST_CHECK(copy.getExclusions().IsExcluded(copy.getBead(0),
+                                              copy.getBead(1)));
+  BOOST_CHECK(!copy.getExclusions().IsExcluded(copy.getBead(0),
+                                               copy.getBead(2)));
+}
+
+BOOST_AUTO_TEST_CASE(exclusion_lookup_table_test) {
+  Topology top;
+  top.setBox(3 * Eigen::Matrix3d::Identity());
+  top.RegisterBeadType("type1");
+  Molecule *mol = top.CreateMolecule("mol");
+  for (votca::Index i = 0; i < 5; ++i) {
+    Bead *bead = top.CreateBead(Bead::spherical, "bead" + to_string(i),
+                                "type1", 1, 1.0, 0.0);
+    mol->AddBead(bead, "b" + to_string(i));
+  }
+  Molecule *other = top.CreateMolecule("other");
+  Bead *single =
+      top.CreateBead(Bead::spherical, "single", "type1", 2, 1.0, 0.0);
+  other->AddBead(single, "s");
+
+  auto bond = new IBond(3, 4);
+  bond->setGroup("bond");
+  auto angle = new IAngle(2, 1, 0);
+  angle->setGroup("angle");
+  top.AddBondedInteraction(bond);
+  top.AddBondedInteraction(angle);
+  mol->AddInteraction(bond);
+  mol->AddInteraction(angle);
+  top.RebuildExclusions();
+
+  ExclusionList &excl = top.getExclusions();
+  BOOST_CHECK(excl.HasLookupTable());
+
+  auto excluded = [&](votca::Index i, votca::Index j) {
+    return excl.IsExcluded(top.getBead(i), top.getBead(j));
+  };
+  BOOST_CHECK(excluded(0, 1));
+  BOOST_CHECK(excluded(2, 0));
+  BOOST_CHECK(excluded(1, 2));
+  BOOST_CHECK(excluded(4, 3));
+  BOOST_CHECK(!excluded(0, 3));
+  BOOST_CHECK(!excluded(2, 4));
+  BOOST_CHECK(!excluded(4, 5));
+
+  // changing the exclusions drops the table, the lists are searched instead
+  excl.InsertExclusion(top.getBead(4), top.getBead(0));
+  BOOST_CHECK(!excl.HasLookupTable());
+  BOOST_CHECK(excluded(0, 4));
+  excl.BuildLookupTable();
+  BOOST_CHECK(excl.HasLookupTable());
+  BOOST_CHECK(excluded(0, 4));
+  BOOST_CHECK(excluded(1, 0));
+
+  excl.RemoveExclusion(top.getBead(0), top.getBead(4));
+  BOOST_CHECK(!excl.HasLookupTable());
+  BOOST_CHECK(!excluded(0, 4));
+  excl.BuildLookupTable();
+  BOOST_CHECK(!excluded(0, 4));
+  BOOST_CHECK(excluded(0, 2));
+
+  top.Cleanup();
+}
+
+BOOST_AUTO_TEST_CASE(select_beads_test) {
+  Topology top;
+  top.RegisterBeadType("CH2");
+  top.RegisterBeadType("CH3");
+  top.RegisterBeadType("OW");
+  top.CreateBead(Bead::spherical, "C1", "CH3", 1, 1.0, 0.0);
+  top.CreateBead(Bead::spherical, "C2", "CH2", 1, 1.0, 0.0);
+  top.CreateBead(Bead::spherical, "O", "OW", 2, 1.0, 0.0);
+
+  std::vector<votca::Index> ch{0, 1};
+  BOOST_CHECK(top.SelectBeads("CH*") == ch);
+  BOOST_CHECK(top.SelectBeads("name:C1") == std::vector<votca::Index>{0});
+  BOOST_CHECK(top.SelectBeads("N*").empty());
+  // repeated selections are served from the cache
+  BOOST_CHECK_EQUAL(&top.SelectBeads("CH*"), &top.SelectBeads("CH*"));
+
+  // changing the beads updates the selections
+  top.CreateBead(Bead::spherical, "C3", "CH3", 3, 1.0, 0.0);
+  ch.push_back(3);
+  BOOST_CHECK(top.SelectBeads("CH*") == ch);
+  top.RenameBeadType("OW", "CH4");
+  BOOST_CHECK_EQUAL(top.SelectBeads("CH*").size(), 4);
+
+  BeadList beads;
+  beads.Generate(top, "CH3");
+  BOOST_REQUIRE_EQUAL(beads.size(), 2);
+  BOOST_CHECK_EQUAL(*beads.begin(), top.getBead(0));
+  BOOST_CHECK_EQUAL(*(beads.begin() + 1), top.getBead(3));
+}
+
+BOOST_AUTO_TEST_CASE(bead_coordinates_test) {
+  Topology top;
+  top.RegisterBeadType("type1");
+  for (votca::Index i = 0; i < 4; ++i) {
+    Bead *bead = top.CreateBead(Bead::spherical, "bead" + to_string(i),
+                                "type1", 1, 1.0, 0.0);
+    bead->setPos(Eigen::Vector3d(double(i), 1.0, -double(i)));
+    bead->setF(Eigen::Vector3d(0.5, double(i), 0.0));
+  }
+  top.getBead(2)->Pos().y() = 3.0;
+
+  const BeadCoordinates &coords = top.getBeadCoordinates();
+  BOOST_REQUIRE_EQUAL(coords.size(), 4);
+  Eigen::Matrix3Xd pos = coords.Positions();
+  Eigen::Matrix3Xd forces = coords.Forces();
+  for (votca::Index i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(&top.getBead(i)->getPos(), &coords.pos_[i]);
+    BOOST_CHECK(pos.col(i) == top.getBead(i)->getPos());
+    BOOST_CHECK(forces.col(i) == top.getBead(i)->getF());
+  }
+  BOOST_CHECK_CLOSE(pos(1, 2), 3.0, 1e-10);
+
+  // frame data is copied array by array
+  Topology copy;
+  copy.ShareTopologyData(top);
+  top.getBead(1)->setPos(Eigen::Vector3d(7.0, 8.0, 9.0));
+  BOOST_CHECK_CLOSE(copy.getBead(1)->getPos().x(), 1.0, 1e-10);
+  copy.CopyFrameData(top);
+  BOOST_CHECK(copy.getBeadCoordinates().Positions() ==
+              top.getBeadCoordinates().Positions());
+  BOOST_CHECK_EQUAL(&copy.getBead(1)->getPos(),
+                    &copy.getBeadCoordinates().pos_[1]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE csgapplication_test
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// Local VOTCA includes
+#include "votca/csg/csgapplication.h"
+
+using namespace std;
+using namespace votca::csg;
+using votca::Index;
+
+namespace {
+
+const Index n_frames = 40;
+
+// the timestep of each frame is its index
+void WriteTrajectory(const string &filename) {
+  ofstream out(filename);
+  for (Index frame = 0; frame < n_frames; ++frame) {
+    out << "ITEM: TIMESTEP\n" << frame << "\n";
+    out << "ITEM: NUMBER OF ATOMS\n2\n";
+    out << "ITEM: BOX BOUNDS pp pp pp\n0 10\n0 10\n0 10\n";
+    out << "ITEM: ATOMS id type x y z\n";
+    out << "1 1 1.0 1.0 1.0\n";
+    out << "2 1 2.0 2.0 2.0\n";
+  }
+}
+
+class StepWorker : public CsgApplication::Worker {
+ public:
+  void EvalConfiguration(Topology *top, Topology *) override {
+    step_ = top->getStep();
+    // the frames take different times, so the workers finish out of order
+    std::this_thread::sleep_for(std::chrono::milliseconds((step_ * 7) % 5));
+  }
+  std::unique_ptr<CsgApplication::Worker> DetachResult() override {
+    auto result = std::make_unique<StepWorker>();
+    result->step_ = step_;
+    return result;
+  }
+  bool CanDetachResult() const override { return true; }
+
+  Index step_ = -1;
+};
+
+class OrderApp : public CsgApplication {
+ public:
+  string ProgramName() override { return "test_csgapplication"; }
+  void HelpText(ostream &out) override { out << "merges the frame steps"; }
+  bool DoTrajectory() override { return true; }
+  bool DoThreaded() override { return true; }
+  bool SynchronizeThreads() override { return true; }
+
+  std::unique_ptr<CsgApplication::Worker> ForkWorker() override {
+    return std::make_unique<StepWorker>();
+  }
+  void MergeWorker(Worker *worker) override {
+    merged_.push_back(dynamic_cast<StepWorker *>(worker)->step_);
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    max_buffered_ = std::max(max_buffered_, Index(results_.size()));
+  }
+
+  Index MaxPending() const { return max_pending_results_ * nthreads_; }
+
+  std::vector<Index> merged_;
+  Index max_buffered_ = 0;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(csgapplication_test)
+
+BOOST_AUTO_TEST_CASE(test_ordered_merge) {
+  string filename = "test_csgapplication.dump";
+  WriteTrajectory(filename);
+
+  for (string nt : {"1", "3"}) {
+    OrderApp app;
+    vector<string> args = {"test_csgapplication", "--top", filename,
+                           "--trj", filename, "--nt", nt};
+    vector<char *> argv;
+    for (string &arg : args) {
+      argv.push_back(arg.data());
+    }
+    BOOST_REQUIRE_EQUAL(app.Exec(int(argv.size()), argv.data()), 0);
+
+    // the frames are merged strictly in the order of the trajectory
+    BOOST_REQUIRE_EQUAL(Index(app.merged_.size()), n_frames);
+    for (Index frame = 0; frame < n_frames; ++frame) {
+      BOOST_CHECK_EQUAL(app.merged_[frame], frame);
+    }
+    // the reorder buffer is bounded
+    BOOST_CHECK_LE(app.max_buffered_, app.MaxPending());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
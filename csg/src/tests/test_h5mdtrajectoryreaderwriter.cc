@@ -0,0 +1,158 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE h5mdtrajectoryreaderwriter_test
+
+// Standard includes
+#include <memory>
+#include <string>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// VOTCA includes
+#include <votca/tools/types.h>
+
+// Local VOTCA includes
+#include "votca/csg/bead.h"
+#include "votca/csg/trajectoryreader.h"
+#include "votca/csg/trajectorywriter.h"
+
+using namespace std;
+using namespace votca::csg;
+
+namespace {
+
+const votca::Index n_beads = 50;
+// more frames than fit into one chunk of the writer
+const votca::Index n_frames = 300;
+
+Eigen::Vector3d Value(votca::Index frame, votca::Index bead, double shift) {
+  return Eigen::Vector3d(0.1 * double(bead) + shift, 0.01 * double(frame),
+                         0.3 + 1e-3 * double(bead * frame) - shift);
+}
+
+void CreateTopology(Topology &top) {
+  top.RegisterBeadType("CG");
+  for (votca::Index i = 0; i < n_beads; ++i) {
+    top.CreateBead(Bead::spherical, "CG", "CG", 0, 1.0, 0.0);
+  }
+  top.setParticleGroup("all");
+  top.SetHasVel(true);
+  top.SetHasForce(true);
+}
+
+bool FrameMatches(Topology &top, votca::Index frame, double tolerance) {
+  bool match = true;
+  for (votca::Index i = 0; i < n_beads; ++i) {
+    const Bead *b = top.getBead(i);
+    match = match && b->getPos().isApprox(Value(frame, i, 0.0), tolerance) &&
+            b->getVel().isApprox(Value(frame, i, 1.0), tolerance) &&
+            b->getF().isApprox(Value(frame, i, -2.0), tolerance);
+  }
+  return match;
+}
+
+// writes and reads back a trajectory, the positions, velocities and forces
+// differ per frame
+void RoundTrip(bool single_precision, votca::Index compression,
+               double tolerance) {
+  string filename = "test_h5md_" + std::to_string(single_precision) + "_" +
+                    std::to_string(compression) + ".h5";
+
+  TrajectoryWriter::RegisterPlugins();
+  std::unique_ptr<TrajectoryWriter> writer =
+      TrjWriterFactory().Create(filename);
+  if (writer == nullptr) {
+    BOOST_TEST_MESSAGE("votca_csg was built without h5md support");
+    return;
+  }
+
+  Topology top;
+  CreateTopology(top);
+  writer->setSinglePrecision(single_precision);
+  writer->setCompressionLevel(compression);
+  writer->Open(filename);
+  for (votca::Index frame = 0; frame < n_frames; ++frame) {
+    Eigen::Matrix3d box = Eigen::Matrix3d::Zero();
+    box.diagonal() = Eigen::Vector3d(5.0, 6.0, 7.0 + double(frame));
+    top.setBox(box);
+    top.setStep(10 * frame);
+    top.setTime(0.5 * double(frame));
+    for (votca::Index i = 0; i < n_beads; ++i) {
+      top.getBead(i)->setPos(Value(frame, i, 0.0));
+      top.getBead(i)->setVel(Value(frame, i, 1.0));
+      top.getBead(i)->setF(Value(frame, i, -2.0));
+    }
+    writer->Write(&top);
+  }
+  writer->Close();
+
+  Topology top_read;
+  CreateTopology(top_read);
+  TrajectoryReader::RegisterPlugins();
+  std::unique_ptr<TrajectoryReader> reader =
+      TrjReaderFactory().Create(filename);
+  BOOST_REQUIRE(reader != nullptr);
+  BOOST_REQUIRE(reader->Open(filename));
+  for (votca::Index frame = 0; frame < n_frames; ++frame) {
+    if (frame == 0) {
+      BOOST_REQUIRE(reader->FirstFrame(top_read));
+    } else {
+      BOOST_REQUIRE(reader->NextFrame(top_read));
+    }
+    BOOST_CHECK_CLOSE(top_read.getBox()(2, 2), 7.0 + double(frame), 1e-10);
+    BOOST_CHECK(FrameMatches(top_read, frame, tolerance));
+  }
+  BOOST_CHECK(!reader->NextFrame(top_read));
+  reader->Close();
+
+  // jump over frames, also into the next chunk
+  Topology top_skip;
+  CreateTopology(top_skip);
+  reader = TrjReaderFactory().Create(filename);
+  BOOST_REQUIRE(reader->Open(filename));
+  BOOST_REQUIRE(reader->FirstFrame(top_skip));
+  BOOST_REQUIRE(reader->AdvanceFrames(top_skip, 2));
+  BOOST_CHECK(FrameMatches(top_skip, 2, tolerance));
+  BOOST_REQUIRE(reader->AdvanceFrames(top_skip, 250));
+  BOOST_CHECK(FrameMatches(top_skip, 252, tolerance));
+  BOOST_REQUIRE(reader->NextFrame(top_skip));
+  BOOST_CHECK(FrameMatches(top_skip, 253, tolerance));
+  BOOST_CHECK(!reader->AdvanceFrames(top_skip, n_frames));
+  reader->Close();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(h5mdtrajectoryreaderwriter_test)
+
+BOOST_AUTO_TEST_CASE(test_h5md_roundtrip_double) {
+  RoundTrip(false, 0, 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(test_h5md_roundtrip_compressed) {
+  RoundTrip(false, 4, 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(test_h5md_roundtrip_single_compressed) {
+  RoundTrip(true, 4, 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -328,4 +328,58 @@ BOOST_AUTO_TEST_CASE(test_trajectorywriter) {
   }
 }
 
+/**
+ * \brief Test jumping to a frame with the frame index of the reader
+ */
+BOOST_AUTO_TEST_CASE(test_trajectoryreader_advance) {
+  string lammpsdumpfilename = "test_advance.dump";
+  votca::Index nframes = 6;
+  votca::Index natoms = 3;
+  {
+    ofstream out(lammpsdumpfilename);
+    for (votca::Index frame = 0; frame < nframes; ++frame) {
+      out << "ITEM: TIMESTEP\n" << 10 * frame << "\n";
+      out << "ITEM: NUMBER OF ATOMS\n" << natoms << "\n";
+      out << "ITEM: BOX BOUNDS pp pp pp\n";
+      for (votca::Index i = 0; i < 3; ++i) {
+        out << "0.0 20.0\n";
+      }
+      out << "ITEM: ATOMS id type x y z\n";
+      for (votca::Index i = 0; i < natoms; ++i) {
+        out << i + 1 << " 1 " << double(frame) << " " << double(i) << " "
+            << 0.5 * double(frame + i) << "\n";
+      }
+    }
+  }
+
+  Topology top;
+  top.RegisterBeadType("no");
+  for (votca::Index i = 0; i < natoms; ++i) {
+    top.CreateBead(Bead::spherical, "no", "no", 0, 0, 0);
+  }
+
+  TrajectoryReader::RegisterPlugins();
+  std::unique_ptr<TrajectoryReader> reader = std::unique_ptr<TrajectoryReader>(
+      TrjReaderFactory().Create(lammpsdumpfilename));
+  reader->Open(lammpsdumpfilename);
+  reader->FirstFrame(top);
+  BOOST_CHECK_EQUAL(top.getStep(), 0);
+  // the same as calling NextFrame 3 times
+  BOOST_CHECK(reader->AdvanceFrames(top, 3));
+  BOOST_CHECK_EQUAL(top.getStep(), 30);
+  for (votca::Index i = 0; i < natoms; ++i) {
+    BOOST_CHECK_CLOSE(top.getBead(i)->getPos().x(), 3.0 * conv::ang2nm, 1e-8);
+    BOOST_CHECK_CLOSE(top.getBead(i)->getPos().z(),
+                      0.5 * double(3 + i) * conv::ang2nm, 1e-8);
+  }
+  // reading continues after the frame jumped to
+  BOOST_CHECK(reader->NextFrame(top));
+  BOOST_CHECK_EQUAL(top.getStep(), 40);
+  BOOST_CHECK(reader->AdvanceFrames(top, 1));
+  BOOST_CHECK_EQUAL(top.getStep(), 50);
+  BOOST_CHECK(!reader->AdvanceFrames(top, 2));
+  BOOST_CHECK(!reader->NextFrame(top));
+  reader->Close();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
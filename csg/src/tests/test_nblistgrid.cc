@@ -0,0 +1,229 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE nblistgrid_test
+
+// Standard includes
+#include <cmath>
+#include <map>
+#include <string>
+#include <utility>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// Local VOTCA includes
+#include "votca/csg/bead.h"
+#include "votca/csg/beadlist.h"
+#include "votca/csg/nblistgrid.h"
+#include "votca/csg/topology.h"
+
+using namespace std;
+using namespace votca::csg;
+using votca::Index;
+
+namespace {
+
+// beads on a slightly distorted lattice, alternating between two types
+void FillTopology(Topology &top, Index n_per_dim, double spacing) {
+  Eigen::Matrix3d box =
+      double(n_per_dim) * spacing * Eigen::Matrix3d::Identity();
+  top.setBox(box);
+  top.RegisterBeadType("A");
+  top.RegisterBeadType("B");
+  Molecule *mol = top.CreateMolecule("UNKNOWN");
+  Index id = 0;
+  for (Index i = 0; i < n_per_dim; ++i) {
+    for (Index j = 0; j < n_per_dim; ++j) {
+      for (Index k = 0; k < n_per_dim; ++k) {
+        string type = (id % 2 == 0) ? "A" : "B";
+        Bead *b = top.CreateBead(Bead::spherical, "dummy" + to_string(id),
+                                 type, 0, 1.0, 0.0);
+        Eigen::Vector3d pos{double(i), double(j), double(k)};
+        pos *= spacing;
+        pos += 0.3 * spacing *
+               Eigen::Vector3d(std::sin(double(7 * id)), std::cos(double(id)),
+                               std::sin(double(3 * id + 1)));
+        b->setPos(pos);
+        mol->AddBead(b, type);
+        ++id;
+      }
+    }
+  }
+}
+
+// collect pairs as (smaller id, larger id) -> distance
+map<pair<Index, Index>, double> CollectPairs(NBList &nb) {
+  map<pair<Index, Index>, double> pairs;
+  for (BeadPair *pair : nb) {
+    Index id1 = pair->first()->getId();
+    Index id2 = pair->second()->getId();
+    auto result = pairs.emplace(std::minmax(id1, id2), pair->dist());
+    BOOST_CHECK(result.second);
+  }
+  return pairs;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(nblistgrid_test)
+
+BOOST_AUTO_TEST_CASE(test_pairlist_find) {
+  Topology top;
+  FillTopology(top, 2, 1.0);
+  BeadList beads;
+  beads.Generate(top, "*");
+
+  NBList nb;
+  nb.setCutoff(1.2);
+  nb.Generate(beads, false);
+  BOOST_REQUIRE(!nb.empty());
+
+  for (BeadPair *pair : nb) {
+    BOOST_CHECK_EQUAL(nb.FindPair(pair->first(), pair->second()), pair);
+    BOOST_CHECK_EQUAL(nb.FindPair(pair->second(), pair->first()), pair);
+    NBList::partners *partners = nb.FindPartners(pair->first());
+    BOOST_REQUIRE(partners != nullptr);
+    BOOST_CHECK_EQUAL(partners->at(pair->second()), pair);
+  }
+
+  Index size = nb.size();
+  nb.Cleanup();
+  BOOST_CHECK(nb.empty());
+  BOOST_CHECK(nb.FindPair(top.getBead(0), top.getBead(1)) == nullptr);
+  BOOST_CHECK(nb.FindPartners(top.getBead(0)) == nullptr);
+
+  // reusing the list after cleanup gives the same result
+  nb.Generate(beads, false);
+  BOOST_CHECK_EQUAL(nb.size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(test_nblistgrid_same_as_nblist) {
+  Topology top;
+  FillTopology(top, 8, 0.5);
+  BeadList beads;
+  beads.Generate(top, "*");
+
+  // 4 cells per direction use the half shell, 2 cells the small grid search
+  for (double cutoff : {0.9, 1.5}) {
+    NBList nb;
+    nb.setCutoff(cutoff);
+    nb.Generate(beads, false);
+
+    NBListGrid nbgrid;
+    nbgrid.setCutoff(cutoff);
+    nbgrid.Generate(beads, false);
+
+    auto ref = CollectPairs(nb);
+    auto grid = CollectPairs(nbgrid);
+    BOOST_REQUIRE_EQUAL(ref.size(), grid.size());
+    for (const auto &pair : ref) {
+      auto found = grid.find(pair.first);
+      BOOST_REQUIRE(found != grid.end());
+      BOOST_CHECK_CLOSE(found->second, pair.second, 1e-8);
+    }
+
+    // the connection vector points from the first to the second bead
+    for (BeadPair *pair : nbgrid) {
+      BOOST_CHECK_LT(pair->first()->getId(), pair->second()->getId());
+      Eigen::Vector3d r = top.BCShortestConnection(pair->first()->getPos(),
+                                                   pair->second()->getPos());
+      BOOST_CHECK_SMALL((r - pair->r()).norm(), 1e-10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_nblistgrid_two_lists) {
+  Topology top;
+  FillTopology(top, 8, 0.5);
+  BeadList beads1;
+  beads1.Generate(top, "A");
+  BeadList beads2;
+  beads2.Generate(top, "B");
+  BeadList all;
+  all.Generate(top, "*");
+
+  NBList nb;
+  nb.setCutoff(0.9);
+  nb.Generate(beads1, beads2, false);
+
+  NBListGrid nbgrid;
+  nbgrid.setCutoff(0.9);
+  nbgrid.Generate(beads1, beads2, false);
+
+  auto ref = CollectPairs(nb);
+  auto grid = CollectPairs(nbgrid);
+  BOOST_CHECK_EQUAL(ref.size(), grid.size());
+  for (const auto &pair : ref) {
+    BOOST_CHECK(grid.count(pair.first));
+  }
+
+  // overlapping lists must not give duplicate pairs
+  NBListGrid nb_overlap;
+  nb_overlap.setCutoff(0.9);
+  nb_overlap.Generate(beads1, all, false);
+  auto overlap = CollectPairs(nb_overlap);
+  BOOST_CHECK_GT(overlap.size(), ref.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_nblistgrid_verlet_skin) {
+  Topology top;
+  FillTopology(top, 8, 0.5);
+  BeadList beads;
+  beads.Generate(top, "*");
+
+  NBListGrid verlet;
+  verlet.setCutoff(0.9);
+  verlet.setSkin(0.2);
+
+  auto compare = [&]() {
+    verlet.Generate(beads, false);
+    NBListGrid nbgrid;
+    nbgrid.setCutoff(0.9);
+    nbgrid.Generate(beads, false);
+    auto ref = CollectPairs(nbgrid);
+    auto reused = CollectPairs(verlet);
+    BOOST_REQUIRE_EQUAL(ref.size(), reused.size());
+    for (const auto &pair : ref) {
+      auto found = reused.find(pair.first);
+      BOOST_REQUIRE(found != reused.end());
+      BOOST_CHECK_CLOSE(found->second, pair.second, 1e-8);
+    }
+  };
+
+  compare();
+  BOOST_CHECK_EQUAL(verlet.getRebuildCount(), 1);
+
+  // moving every bead by less than half the skin keeps the list
+  for (Index i = 0; i < top.BeadCount(); ++i) {
+    Bead *b = top.getBead(i);
+    double shift = 0.06 * std::sin(double(5 * i));
+    b->setPos(b->getPos() + Eigen::Vector3d(shift, -shift, 0.5 * shift));
+  }
+  compare();
+  BOOST_CHECK_EQUAL(verlet.getRebuildCount(), 1);
+
+  // a single bead moving further triggers a new search
+  Bead *b = top.getBead(0);
+  b->setPos(b->getPos() + Eigen::Vector3d(0.15, 0.0, 0.0));
+  compare();
+  BOOST_CHECK_EQUAL(verlet.getRebuildCount(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
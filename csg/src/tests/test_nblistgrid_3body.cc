@@ -20,6 +20,7 @@
 #define BOOST_TEST_MODULE nblist_3body_test
 
 // Standard includes
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -129,4 +130,64 @@ BOOST_AUTO_TEST_CASE(test_nblist_3body_generate_list) {
   BOOST_CHECK_CLOSE((*triple_iter)->dist23(), 1.0, 1e-4);
 }
 
+BOOST_AUTO_TEST_CASE(test_nblistgrid_3body_foreachtriple) {
+  Topology top;
+  top.setBox(6 * Eigen::Matrix3d::Identity());
+  Molecule *mol = top.CreateMolecule("UNKNOWN");
+  string bead_type_name = "CG";
+  top.RegisterBeadType(bead_type_name);
+
+  // beads on a distorted grid, so that the cells are well populated
+  for (votca::Index n = 0; n < 125; ++n) {
+    Bead *b = top.CreateBead(Bead::spherical, "dummy", bead_type_name, 0, 1.0,
+                             0.0);
+    Eigen::Vector3d pos(double(n % 5), double((n / 5) % 5), double(n / 25));
+    pos = 1.2 * pos + 0.3 * Eigen::Vector3d(std::sin(double(n)),
+                                            std::cos(3.0 * double(n)),
+                                            std::sin(7.0 * double(n)));
+    b->setPos(pos);
+    mol->AddBead(b, bead_type_name);
+  }
+
+  BeadList beads;
+  beads.Generate(top, "CG");
+
+  // reference: the stored triples of the simple search
+  NBList_3Body reference;
+  reference.setCutoff(1.5);
+  reference.Generate(beads, true);
+  double ref_sum = 0.0;
+  for (BeadTriple *triple : reference) {
+    ref_sum += triple->dist12() * triple->dist13();
+  }
+  BOOST_REQUIRE(reference.size() > 0);
+
+  for (bool parallel : {false, true}) {
+    NBListGrid_3Body nb;
+    nb.setCutoff(1.5);
+    nb.setParallel(parallel);
+    votca::Index count = 0;
+    double sum = 0.0;
+    nb.ForEachTriple(
+        beads, beads, beads,
+        [&](Bead *b1, Bead *b2, Bead *b3, const Eigen::Vector3d &r12,
+            const Eigen::Vector3d &r13, double d12, double d13) {
+          // Boost.Test is not thread safe
+#pragma omp critical
+          {
+            BOOST_CHECK(b2->getId() < b3->getId());
+            BOOST_CHECK(b1 != b2 && b1 != b3);
+            BOOST_CHECK_CLOSE(r12.norm(), d12, 1e-10);
+            BOOST_CHECK_CLOSE(r13.norm(), d13, 1e-10);
+            ++count;
+            sum += d12 * d13;
+          }
+        });
+    BOOST_CHECK_EQUAL(count, reference.size());
+    BOOST_CHECK_CLOSE(sum, ref_sum, 1e-8);
+    // nothing is stored
+    BOOST_CHECK(nb.empty());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
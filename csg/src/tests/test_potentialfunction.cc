@@ -0,0 +1,107 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE potentialfunction_test
+
+// Standard includes
+#include <cmath>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// Local VOTCA includes
+#include "votca/csg/potentialfunctions/potentialfunctioncbspl.h"
+#include "votca/csg/potentialfunctions/potentialfunctionljg.h"
+
+using namespace votca::csg;
+using votca::Index;
+
+namespace {
+
+// distances spread over the whole range, some of them beyond the cut-off
+Eigen::VectorXd Distances(Index n, double rmax) {
+  Eigen::VectorXd r(n);
+  for (Index k = 0; k < n; k++) {
+    r(k) = rmax * (0.5 + 0.5 * std::sin(double(7 * k + 1)));
+  }
+  return r;
+}
+
+// compare with the sums of the single distance values
+void CheckDerivatives(const PotentialFunction &pot, const Eigen::VectorXd &r,
+                      const Eigen::VectorXd &weight) {
+  double U;
+  Eigen::VectorXd dU;
+  Eigen::MatrixXd d2U;
+  pot.CalculateDerivatives(r, weight, U, dU, d2U);
+
+  Index nopt = pot.getOptParamSize();
+  BOOST_REQUIRE_EQUAL(dU.size(), nopt);
+  BOOST_REQUIRE_EQUAL(d2U.rows(), nopt);
+  BOOST_REQUIRE_EQUAL(d2U.cols(), nopt);
+
+  double U_ref = 0.0;
+  Eigen::VectorXd dU_ref = Eigen::VectorXd::Zero(nopt);
+  Eigen::MatrixXd d2U_ref = Eigen::MatrixXd::Zero(nopt, nopt);
+  for (Index k = 0; k < r.size(); k++) {
+    U_ref += weight(k) * pot.CalculateF(r(k));
+    for (Index i = 0; i < nopt; i++) {
+      dU_ref(i) += weight(k) * pot.CalculateDF(i, r(k));
+      for (Index j = i; j < nopt; j++) {
+        d2U_ref(i, j) += weight(k) * pot.CalculateD2F(i, j, r(k));
+        d2U_ref(j, i) = d2U_ref(i, j);
+      }
+    }
+  }
+
+  BOOST_CHECK_CLOSE(U, U_ref, 1e-9);
+  BOOST_CHECK_SMALL((dU - dU_ref).norm(), 1e-10 * dU_ref.norm());
+  BOOST_CHECK_SMALL((d2U - d2U_ref).norm(), 1e-10 * (1.0 + d2U_ref.norm()));
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(potentialfunction_test)
+
+BOOST_AUTO_TEST_CASE(test_cbspl_derivatives) {
+  PotentialFunctionCBSPL pot("CG-CG", 24, 0.25, 1.1);
+  Eigen::VectorXd lam(24);
+  for (Index i = 0; i < lam.size(); i++) {
+    lam(i) = std::cos(0.3 * double(i));
+  }
+  pot.Params() = lam;
+
+  Eigen::VectorXd r = Distances(500, 1.3);
+  Eigen::VectorXd weight = (1.0 + 0.5 * r.array().sin()).matrix();
+  CheckDerivatives(pot, r, weight);
+  CheckDerivatives(pot, r, Eigen::VectorXd::Ones(r.size()));
+}
+
+BOOST_AUTO_TEST_CASE(test_ljg_derivatives) {
+  PotentialFunctionLJG pot("CG-CG", 0.2, 1.1);
+  Eigen::VectorXd lam(5);
+  lam << 1e-6, 1e-3, 0.5, 10.0, 0.45;
+  pot.Params() = lam;
+
+  Eigen::VectorXd r = Distances(200, 1.3);
+  Eigen::VectorXd weight = (1.0 + 0.5 * r.array().sin()).matrix();
+  CheckDerivatives(pot, r, weight);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
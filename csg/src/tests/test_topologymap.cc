@@ -0,0 +1,180 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE topologymap_test
+
+// Standard includes
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// Local VOTCA includes
+#include "votca/csg/cgengine.h"
+#include "votca/csg/topology.h"
+#include "votca/csg/topologymap.h"
+
+using namespace std;
+using namespace votca::csg;
+using votca::Index;
+
+namespace {
+
+void WriteMapping(const string &filename, const string &name,
+                  Index symmetry) {
+  ofstream out(filename);
+  out << "<cg_molecule>\n"
+      << "  <name>" << name << "</name>\n"
+      << "  <ident>" << name << "</ident>\n"
+      << "  <topology>\n"
+      << "    <cg_beads>\n"
+      << "      <cg_bead>\n"
+      << "        <name>CG</name>\n"
+      << "        <type>CG</type>\n"
+      << "        <symmetry>" << symmetry << "</symmetry>\n"
+      << "        <mapping>A</mapping>\n"
+      << "        <beads>1:" << name << ":A 1:" << name << ":B 1:" << name
+      << ":C</beads>\n"
+      << "      </cg_bead>\n"
+      << "    </cg_beads>\n"
+      << "  </topology>\n"
+      << "  <maps>\n"
+      << "    <map>\n"
+      << "      <name>A</name>\n"
+      << "      <weights>16 1 1</weights>\n"
+      << "    </map>\n"
+      << "  </maps>\n"
+      << "</cg_molecule>\n";
+}
+
+// a molecule with three atoms, the positions are relative to the first one
+void AddMolecule(Topology &top, const string &name,
+                 const Eigen::Vector3d &first, const Eigen::Vector3d &second,
+                 const Eigen::Vector3d &third) {
+  Molecule *mol = top.CreateMolecule(name);
+  const string atoms[3] = {"A", "B", "C"};
+  const double masses[3] = {16.0, 1.0, 1.0};
+  const Eigen::Vector3d pos[3] = {first, first + second, first + third};
+  for (Index i = 0; i < 3; ++i) {
+    Bead *b =
+        top.CreateBead(Bead::spherical, atoms[i], "A", 0, masses[i], 0.0);
+    b->setPos(pos[i]);
+    b->setVel(Eigen::Vector3d(double(i), 0, 1));
+    b->setF(Eigen::Vector3d(0, double(i + 1), 0));
+    mol->AddBead(b, "1:" + name + ":" + atoms[i]);
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(topologymap_test)
+
+BOOST_AUTO_TEST_CASE(test_map_pbc) {
+  WriteMapping("test_topologymap_sph.xml", "SPH", 1);
+  WriteMapping("test_topologymap_ell.xml", "ELL", 3);
+
+  Topology top;
+  top.setBox(4 * Eigen::Matrix3d::Identity());
+  top.RegisterBeadType("A");
+  // the second atom is on the other side of the box
+  AddMolecule(top, "SPH", Eigen::Vector3d(3.9, 1, 1),
+              Eigen::Vector3d(0.2, 0, 0), Eigen::Vector3d(0, 0.1, 0));
+  top.getBead(1)->setPos(Eigen::Vector3d(0.1, 1, 1));
+  AddMolecule(top, "ELL", Eigen::Vector3d(2, 2, 2),
+              Eigen::Vector3d(0.1, 0, 0), Eigen::Vector3d(0, 0.1, 0.05));
+
+  CGEngine cg;
+  cg.LoadMoleculeType("test_topologymap_sph.xml;test_topologymap_ell.xml");
+  Topology top_cg;
+  std::unique_ptr<TopologyMap> map = cg.CreateCGTopology(top, top_cg);
+  map->Apply();
+
+  BOOST_REQUIRE_EQUAL(top_cg.BeadCount(), 2);
+  for (Index i = 0; i < 2; ++i) {
+    const Bead *b = top_cg.getBead(i);
+    BOOST_CHECK_CLOSE(b->getMass(), 18.0, 1e-10);
+    // the weights are normalized, the forces are summed up
+    BOOST_CHECK_SMALL((b->getVel() - Eigen::Vector3d(3.0 / 18.0, 0, 1)).norm(),
+                      1e-12);
+    BOOST_CHECK_SMALL((b->getF() - Eigen::Vector3d(0, 6, 0)).norm(), 1e-12);
+  }
+
+  // the center is taken of the unwrapped molecule
+  Eigen::Vector3d center = Eigen::Vector3d(3.9, 1, 1) +
+                           Eigen::Vector3d(0.2, 0.1, 0) / 18.0;
+  BOOST_CHECK_SMALL((top_cg.getBead(0)->getPos() - center).norm(), 1e-12);
+  center = Eigen::Vector3d(2, 2, 2) + Eigen::Vector3d(0.1, 0.1, 0.05) / 18.0;
+  BOOST_CHECK_SMALL((top_cg.getBead(1)->getPos() - center).norm(), 1e-12);
+
+  // the ellipsoidal bead also gets an orthonormal orientation
+  const Bead *ell = top_cg.getBead(1);
+  BOOST_CHECK_SMALL((ell->getV() - Eigen::Vector3d::UnitX()).norm(), 1e-12);
+  BOOST_CHECK_SMALL(ell->getU().dot(ell->getV()), 1e-12);
+  BOOST_CHECK_SMALL(ell->getW().dot(ell->getU()), 1e-12);
+  BOOST_CHECK_CLOSE(ell->getW().norm(), 1.0, 1e-10);
+
+  // the next frame is mapped with the same weights
+  top.getBead(0)->setPos(Eigen::Vector3d(1, 1, 1));
+  top.getBead(1)->setPos(Eigen::Vector3d(1.2, 1, 1));
+  top.getBead(2)->setPos(Eigen::Vector3d(1, 1.1, 1));
+  map->Apply();
+  center = Eigen::Vector3d(1, 1, 1) + Eigen::Vector3d(0.2, 0.1, 0) / 18.0;
+  BOOST_CHECK_SMALL((top_cg.getBead(0)->getPos() - center).norm(), 1e-12);
+
+  // a bead bigger than half the box cannot be unwrapped
+  top.getBead(2)->setPos(Eigen::Vector3d(2.9, 2.9, 1));
+  BOOST_CHECK_THROW(map->Apply(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_map_parallel) {
+  WriteMapping("test_topologymap_sph.xml", "SPH", 1);
+
+  // enough molecules to map them in parallel
+  Topology top;
+  top.setBox(4 * Eigen::Matrix3d::Identity());
+  top.RegisterBeadType("A");
+  const Index nmols = 1500;
+  for (Index i = 0; i < nmols; ++i) {
+    double x = 4.0 * double(i) / double(nmols);
+    AddMolecule(top, "SPH", Eigen::Vector3d(x, 3.95, 0.02),
+                Eigen::Vector3d(0.1, 0.1, -0.05), Eigen::Vector3d(-0.1, 0, 0));
+  }
+
+  CGEngine cg;
+  cg.LoadMoleculeType("test_topologymap_sph.xml");
+  Topology top_cg;
+  std::unique_ptr<TopologyMap> map = cg.CreateCGTopology(top, top_cg);
+  map->Apply();
+  std::vector<Eigen::Vector3d> parallel = top_cg.getBeadCoordinates().pos_;
+  map->setParallel(false);
+  map->Apply();
+
+  BOOST_REQUIRE_EQUAL(top_cg.BeadCount(), nmols);
+  for (Index i = 0; i < nmols; ++i) {
+    BOOST_CHECK_EQUAL(parallel[i], top_cg.getBead(i)->getPos());
+    Eigen::Vector3d center = top.getBead(3 * i)->getPos() +
+                             Eigen::Vector3d(0.0, 0.1, -0.05) / 18.0;
+    BOOST_CHECK_SMALL((top_cg.getBead(i)->getPos() - center).norm(), 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE trajectoryreadahead_test
+
+// Standard includes
+#include <stdexcept>
+#include <string>
+
+// Third party includes
+#include <boost/test/unit_test.hpp>
+
+// Local VOTCA includes
+#include "votca/csg/topology.h"
+#include "votca/csg/trajectoryreadahead.h"
+
+using namespace std;
+using namespace votca::csg;
+using votca::Index;
+
+namespace {
+
+// writes the frame number into time, step and the bead positions
+class CountingReader : public TrajectoryReader {
+ public:
+  CountingReader(Index nframes, Index fail_at = -1)
+      : nframes_(nframes), fail_at_(fail_at) {}
+
+  bool Open(const string &) override { return true; }
+  bool FirstFrame(Topology &top) override { return NextFrame(top); }
+  bool NextFrame(Topology &top) override {
+    if (frame_ == fail_at_) {
+      throw runtime_error("broken frame");
+    }
+    if (frame_ == nframes_) {
+      return false;
+    }
+    top.setStep(frame_);
+    top.setTime(0.1 * double(frame_));
+    for (Index i = 0; i < top.BeadCount(); ++i) {
+      top.getBead(i)->setPos(Eigen::Vector3d(double(frame_), double(i), 0));
+    }
+    ++frame_;
+    return true;
+  }
+
+ private:
+  Index nframes_;
+  Index fail_at_;
+  Index frame_ = 0;
+};
+
+void FillTopology(Topology &top) {
+  top.setBox(5 * Eigen::Matrix3d::Identity());
+  top.RegisterBeadType("A");
+  Molecule *mol = top.CreateMolecule("mol");
+  for (Index i = 0; i < 4; ++i) {
+    Bead *b = top.CreateBead(Bead::spherical, "A" + to_string(i), "A", 0, 1.0,
+                             0.0);
+    mol->AddBead(b, "A" + to_string(i));
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(trajectoryreadahead_test)
+
+BOOST_AUTO_TEST_CASE(test_frames_in_order) {
+  Topology top;
+  FillTopology(top);
+  CountingReader reader(20);
+  TrajectoryReadAhead read_ahead(reader, top, 3);
+  read_ahead.Start();
+
+  Index nframes = 0;
+  while (Topology *frame = read_ahead.Acquire()) {
+    top.CopyFrameData(*frame);
+    read_ahead.Release(frame);
+    BOOST_CHECK_EQUAL(top.getStep(), nframes);
+    BOOST_CHECK_CLOSE(top.getTime(), 0.1 * double(nframes), 1e-10);
+    BOOST_CHECK_EQUAL(top.getBead(3)->getPos().x(), double(nframes));
+    BOOST_CHECK_EQUAL(top.getBead(3)->getPos().y(), 3.0);
+    ++nframes;
+  }
+  BOOST_CHECK_EQUAL(nframes, 20);
+  read_ahead.WaitDone();
+}
+
+BOOST_AUTO_TEST_CASE(test_limit_and_stop) {
+  Topology top;
+  FillTopology(top);
+  CountingReader reader(20);
+  TrajectoryReadAhead read_ahead(reader, top, 2, 5);
+  read_ahead.Start();
+
+  Index nframes = 0;
+  while (Topology *frame = read_ahead.Acquire()) {
+    read_ahead.Release(frame);
+    ++nframes;
+  }
+  BOOST_CHECK_EQUAL(nframes, 5);
+  read_ahead.WaitDone();
+
+  // stopping while the buffers are full ends the reader thread
+  CountingReader reader2(20);
+  TrajectoryReadAhead read_ahead2(reader2, top, 2);
+  read_ahead2.Start();
+  Topology *frame = read_ahead2.Acquire();
+  BOOST_REQUIRE(frame != nullptr);
+  read_ahead2.Release(frame);
+  read_ahead2.Stop();
+  read_ahead2.WaitDone();
+}
+
+BOOST_AUTO_TEST_CASE(test_reader_error) {
+  Topology top;
+  FillTopology(top);
+  CountingReader reader(20, 2);
+  TrajectoryReadAhead read_ahead(reader, top, 4);
+  read_ahead.Start();
+
+  for (Index i = 0; i < 2; ++i) {
+    Topology *frame = read_ahead.Acquire();
+    BOOST_REQUIRE(frame != nullptr);
+    read_ahead.Release(frame);
+  }
+  BOOST_CHECK_THROW(read_ahead.Acquire(), runtime_error);
+  read_ahead.WaitDone();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
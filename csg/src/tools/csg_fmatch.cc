@@ -1,5 +1,5 @@
 /*
- * Copyright 2009-2021 The VOTCA Development Team (http://www.votca.org)
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -84,6 +84,28 @@ void CGForceMatching::BeginEvaluate(Topology *top, Topology *) {
   // read  constr_least_sq_ from input file
   constr_least_sq_ = options_.get("cg.fmatch.constrainedLS").as<bool>();
 
+  normal_equations_ = false;
+  if (options_.exists("cg.fmatch.normal_equations")) {
+    normal_equations_ = options_.get("cg.fmatch.normal_equations").as<bool>();
+  }
+  regularization_ = 0.0;
+  if (options_.exists("cg.fmatch.regularization")) {
+    regularization_ = options_.get("cg.fmatch.regularization").as<double>();
+  }
+  if (regularization_ != 0.0 && !normal_equations_) {
+    throw runtime_error(
+        "cg.fmatch.regularization requires cg.fmatch.normal_equations");
+  }
+  if (nthreads_ > 1 && !normal_equations_) {
+    throw runtime_error(
+        "csg_fmatch can only use more than one thread with "
+        "cg.fmatch.normal_equations");
+  }
+  if (nthreads_ > 1 && has_existing_forces_) {
+    throw runtime_error(
+        "csg_fmatch cannot use more than one thread together with --trj-force");
+  }
+
   // initializing bonded interactions
   for (votca::tools::Property *prop : bonded_) {
     // add spline to container
@@ -117,7 +139,21 @@ void CGForceMatching::BeginEvaluate(Topology *top, Topology *) {
 
   // now initialize  A_,  b_,  x_ and probably  B_constr_
   // depending on least-squares algorithm used
-  if (constr_least_sq_) {  // Constrained Least Squares
+  if (normal_equations_) {  // Normal equations, accumulated frame by frame
+
+    cout << "\nUsing normal equations with "
+         << (constr_least_sq_ ? "constrained" : "simple") << " Least Squares!\n"
+         << endl;
+    least_sq_offset_ = 0;
+
+    // the smoothing conditions are kept apart in both cases
+    B_constr_ = Eigen::MatrixXd::Zero(line_cntr_, col_cntr_);
+    FmatchAssignSmoothCondsToMatrix(B_constr_);
+
+    AtA_ = Eigen::MatrixXd::Zero(col_cntr_, col_cntr_);
+    Atb_ = Eigen::VectorXd::Zero(col_cntr_);
+    btb_ = 0.0;
+  } else if (constr_least_sq_) {  // Constrained Least Squares
 
     cout << "\nUsing constrained Least Squares!\n " << endl;
 
@@ -265,6 +301,14 @@ CGForceMatching::SplineInfo::SplineInfo(votca::Index index,
 }
 
 void CGForceMatching::EndEvaluate() {
+  // with the normal equations the remaining frames are cheap to solve, so
+  // they form a last, shorter block. Then frames_per_block can be larger
+  // than the trajectory to get a single global solve.
+  if (normal_equations_ && frame_counter_ > 0) {
+    cout << "\nThe last block only has " << frame_counter_ << " frames"
+         << endl;
+    FinishBlock();
+  }
   // sanity check
   if (nblocks_ == 0) {
     cerr << "\nERROR in CGForceMatching::EndEvaluate - No blocks have been "
@@ -380,7 +424,7 @@ void CGForceMatching::WriteOutFiles() {
   }
 }
 
-void CGForceMatching::EvalConfiguration(Topology *conf, Topology *) {
+void CGForceMatching::PrepareConfiguration(Topology *conf) {
   if (conf->BeadCount() == 0) {
     throw std::runtime_error(
         "CG Topology has 0 beads, check your mapping file!");
@@ -402,72 +446,204 @@ void CGForceMatching::EvalConfiguration(Topology *conf, Topology *) {
       }
     }
   }
+}
 
+template <typename matrix_type>
+void CGForceMatching::EvalInteractions(Topology *conf, matrix_type &A,
+                                       votca::Index offset,
+                                       NBListContainer &nb_lists) {
   for (SplineInfo &sinfo : splines_) {
     if (sinfo.bonded) {
-      EvalBonded(conf, &sinfo);
+      EvalBonded(conf, &sinfo, A, offset);
     } else {
       if (sinfo.threebody) {
-        EvalNonbonded_Threebody(conf, &sinfo);
+        EvalNonbonded_Threebody(conf, &sinfo, A, offset);
       } else {
-        EvalNonbonded(conf, &sinfo);
+        EvalNonbonded(conf, &sinfo, A, offset, nb_lists);
       }
     }
   }
+}
 
+void CGForceMatching::AssignForces(Topology *conf, Eigen::VectorXd &b,
+                                   votca::Index offset) {
   // loop for the forces vector:
   // hack, change the Has functions..
   if (conf->getBead(0)->HasF()) {
     for (votca::Index iatom = 0; iatom < nbeads_; ++iatom) {
       const Eigen::Vector3d &Force = conf->getBead(iatom)->getF();
-      b_(least_sq_offset_ + 3 * nbeads_ * frame_counter_ + iatom) = Force.x();
-      b_(least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + iatom) =
-          Force.y();
-      b_(least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ +
-         iatom) = Force.z();
+      b(offset + iatom) = Force.x();
+      b(offset + nbeads_ + iatom) = Force.y();
+      b(offset + 2 * nbeads_ + iatom) = Force.z();
     }
   } else {
     throw std::runtime_error(
         "\nERROR in csg_fmatch::EvalConfiguration - No forces in "
         "configuration!");
   }
+}
+
+void CGForceMatching::EvalConfiguration(Topology *conf, Topology *) {
+  PrepareConfiguration(conf);
+
+  votca::Index offset = least_sq_offset_ + 3 * nbeads_ * frame_counter_;
+  EvalInteractions(conf, A_, offset, nb_lists_);
+  AssignForces(conf, b_, offset);
+
   // update the frame counter
   frame_counter_ += 1;
 
   if (frame_counter_ % nframes_ == 0) {  // at this point we processed  nframes_
                                          // frames, which is enough for one
                                          // block
-                                         // update block counter
-    nblocks_++;
-    // solve FM equations and accumulate the result
-    FmatchAccumulateData();
-    // print status information
-    cout << "\nBlock No" << nblocks_ << " done!" << endl;
-    // write results to output files
-    WriteOutFiles();
-
-    // we must count frames from zero again for the next block
-    frame_counter_ = 0;
-    if (constr_least_sq_) {  // Constrained Least Squares
-      // Matrices should be cleaned after each block is evaluated
-      A_.setZero();
-      b_.setZero();
-      // clear and assign smoothing conditions to  B_constr_
-      FmatchAssignSmoothCondsToMatrix(B_constr_);
-    } else {  // Simple Least Squares
-      // Matrices should be cleaned after each block is evaluated
-      // clear and assign smoothing conditions to  A_
-      FmatchAssignSmoothCondsToMatrix(A_);
-      b_.setZero();
-    }
+    FinishBlock();
   }
   if (has_existing_forces_) {
     trjreader_force_->NextFrame(top_force_);
   }
 }
 
+std::unique_ptr<CsgApplication::Worker> CGForceMatching::ForkWorker() {
+  return std::make_unique<CGForceMatching::Worker>(this);
+}
+
+void CGForceMatching::Worker::EvalConfiguration(Topology *conf,
+                                                Topology *conf_atom) {
+  if (!fmatch_->normal_equations_) {
+    fmatch_->EvalConfiguration(conf, conf_atom);
+    return;
+  }
+  fmatch_->PrepareConfiguration(conf);
+
+  // the equations of a single frame are reduced to the normal equations right
+  // away, so the memory does not grow with the block length. Each line of A
+  // only has the few nonzeros of the spline intervals of its interactions,
+  // so A is kept sparse.
+  votca::Index nrows = 3 * fmatch_->nbeads_;
+  votca::Index ncols = fmatch_->col_cntr_;
+  A_entries_.clear();
+  b_frame_.setZero(nrows);
+  fmatch_->EvalInteractions(conf, A_entries_, 0, nb_lists_);
+  fmatch_->AssignForces(conf, b_frame_, 0);
+
+  A_frame_.resize(nrows, ncols);
+  A_entries_.toMatrix(A_frame_);
+  AtA_ = A_frame_.transpose() * A_frame_;
+  Atb_.noalias() = A_frame_.transpose() * b_frame_;
+  btb_ = b_frame_.squaredNorm();
+
+  // only possible with a single thread, the frames are read in order
+  if (fmatch_->has_existing_forces_) {
+    fmatch_->trjreader_force_->NextFrame(fmatch_->top_force_);
+  }
+}
+
+std::unique_ptr<CsgApplication::Worker>
+    CGForceMatching::Worker::DetachResult() {
+  auto result = std::make_unique<CGForceMatching::Worker>(fmatch_);
+  result->AtA_ = AtA_;
+  result->Atb_ = Atb_;
+  result->btb_ = btb_;
+  return result;
+}
+
+void CGForceMatching::MergeWorker(CsgApplication::Worker *worker) {
+  if (!normal_equations_) {
+    // the dense solvers were already updated in EvalConfiguration
+    return;
+  }
+  CGForceMatching::Worker *fmworker =
+      dynamic_cast<CGForceMatching::Worker *>(worker);
+  AtA_ += fmworker->AtA_;
+  Atb_ += fmworker->Atb_;
+  btb_ += fmworker->btb_;
+
+  frame_counter_ += 1;
+  if (frame_counter_ % nframes_ == 0) {
+    FinishBlock();
+  }
+}
+
+void CGForceMatching::FinishBlock() {
+  // update block counter
+  nblocks_++;
+  // solve FM equations and accumulate the result
+  FmatchAccumulateData();
+  // print status information
+  cout << "\nBlock No" << nblocks_ << " done!" << endl;
+  // write results to output files
+  WriteOutFiles();
+
+  // we must count frames from zero again for the next block
+  frame_counter_ = 0;
+  if (normal_equations_) {
+    // the smoothing conditions in  B_constr_ do not change
+    AtA_.setZero();
+    Atb_.setZero();
+    btb_ = 0.0;
+  } else if (constr_least_sq_) {  // Constrained Least Squares
+    // Matrices should be cleaned after each block is evaluated
+    A_.setZero();
+    b_.setZero();
+    // clear and assign smoothing conditions to  B_constr_
+    FmatchAssignSmoothCondsToMatrix(B_constr_);
+  } else {  // Simple Least Squares
+    // Matrices should be cleaned after each block is evaluated
+    // clear and assign smoothing conditions to  A_
+    FmatchAssignSmoothCondsToMatrix(A_);
+    b_.setZero();
+  }
+}
+
+Eigen::VectorXd CGForceMatching::SolveNormalEquations() const {
+  Eigen::MatrixXd M = AtA_.selfadjointView<Eigen::Lower>();
+  M.diagonal().array() += regularization_;
+
+  if (constr_least_sq_) {
+    // the solution lies in the null space of the constraints B x = 0, which
+    // is spanned by the last columns of Q of the QR decomposition of B^T
+    Eigen::HouseholderQR<Eigen::MatrixXd> QR(B_constr_.transpose());
+    Eigen::MatrixXd Q = QR.householderQ();
+    Eigen::MatrixXd Z = Q.rightCols(col_cntr_ - line_cntr_);
+    Eigen::MatrixXd MZ = Z.transpose() * M * Z;
+    // coefficients which are not sampled are fine as long as the constraints
+    // determine them, so only the projected equations have to be regular
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> MZ_QR(MZ);
+    if (!MZ_QR.isInvertible()) {
+      throw std::runtime_error(
+          "csg_fmatch: the equations of this block are singular, probably "
+          "parts of a spline grid are not sampled, check the grid or use "
+          "cg.fmatch.regularization");
+    }
+    Eigen::VectorXd z = MZ_QR.solve(Z.transpose() * Atb_);
+    return Z * z;
+  }
+
+  // for simple least squares the smoothing conditions are additional
+  // equations with zero on the right hand side
+  M.noalias() += B_constr_.transpose() * B_constr_;
+  return M.ldlt().solve(Atb_);
+}
+
 void CGForceMatching::FmatchAccumulateData() {
-  if (constr_least_sq_) {  // Constrained Least Squares
+  if (normal_equations_) {
+    x_ = SolveNormalEquations();
+    if (!constr_least_sq_) {
+      // |b - A x|^2 expressed by the normal equations, including the
+      // smoothing conditions as in the dense simple least squares
+      double fm_resid = btb_ - 2.0 * x_.dot(Atb_) +
+                        x_.dot(AtA_.selfadjointView<Eigen::Lower>() * x_) +
+                        (B_constr_ * x_).squaredNorm();
+
+      fm_resid /= (double)(3 * nbeads_ * frame_counter_);
+
+      cout << endl;
+      cout << "#### Force matching residual ####" << endl;
+      cout << "     Chi_2[(kJ/(mol*nm))^2] = " << fm_resid << endl;
+      cout << "#################################" << endl;
+      cout << endl;
+    }
+  } else if (constr_least_sq_) {  // Constrained Least Squares
                            // Solving linear equations system
     x_ = votca::tools::linalg_constrained_qrsolve(A_, b_, B_constr_);
   } else {  // Simple Least Squares
@@ -501,38 +677,33 @@ void CGForceMatching::FmatchAccumulateData() {
     // result cut before is assigned to the corresponding spline
     sinfo.Spline.setSplineData(sinfo.block_res_f, sinfo.block_res_f2);
 
-    // first output point = first grid point
-    double out_x = sinfo.Spline.getGridPoint(0);
-
-    // point in the middle of the output grid for printing debug information
-    votca::Index grid_point_debug = sinfo.num_outgrid / 2;
-
-    // loop over output grid
+    // output grid, starting at the first grid point
+    Eigen::VectorXd out_x(sinfo.num_outgrid);
+    double x = sinfo.Spline.getGridPoint(0);
     for (votca::Index i = 0; i < sinfo.num_outgrid; i++) {
-      // update resSum (add result of a particular block)
-      sinfo.resSum[i] += sinfo.Spline.Calculate(out_x);
-      // update resSum2 (add result of a particular block)
-      sinfo.resSum2[i] +=
-          sinfo.Spline.Calculate(out_x) * sinfo.Spline.Calculate(out_x);
-
-      // Only if threebody interaction, the derivatives are explicitly
-      // calculated
-      if (sinfo.threebody) {
-        sinfo.resSumDer[i] += sinfo.Spline.CalculateDerivative(out_x);
-        // update resSumDer2 (add result of a particular block)
-        sinfo.resSumDer2[i] += sinfo.Spline.CalculateDerivative(out_x) *
-                               sinfo.Spline.CalculateDerivative(out_x);
-      }
-
-      // print useful debug information
-      if (i == grid_point_debug) {
-        cout << "This should be a number: " << sinfo.Spline.Calculate(out_x)
-             << " " << endl;
-      }
+      out_x[i] = x;
+      x += sinfo.dx_out;
+    }
 
-      // output point for the next iteration
-      out_x += sinfo.dx_out;
+    // evaluate the spline on the whole output grid at once
+    Eigen::VectorXd block_res = sinfo.Spline.Calculate(out_x);
+    // update resSum and resSum2 (add result of a particular block)
+    sinfo.resSum += block_res;
+    sinfo.resSum2 += block_res.cwiseAbs2();
+
+    // Only if threebody interaction, the derivatives are explicitly
+    // calculated
+    if (sinfo.threebody) {
+      Eigen::VectorXd block_res_der = sinfo.Spline.CalculateDerivative(out_x);
+      sinfo.resSumDer += block_res_der;
+      // update resSumDer2 (add result of a particular block)
+      sinfo.resSumDer2 += block_res_der.cwiseAbs2();
     }
+
+    // print useful debug information for the point in the middle of the
+    // output grid
+    cout << "This should be a number: " << block_res[sinfo.num_outgrid / 2]
+         << " " << endl;
   }
 }
 
@@ -568,7 +739,9 @@ void CGForceMatching::LoadOptions(const string &file) {
   nonbonded_ = options_.Select("cg.non-bonded");
 }
 
-void CGForceMatching::EvalBonded(Topology *conf, SplineInfo *sinfo) {
+template <typename matrix_type>
+void CGForceMatching::EvalBonded(Topology *conf, SplineInfo *sinfo,
+                                 matrix_type &A, votca::Index offset) {
 
   std::vector<Interaction *> interList =
       conf->InteractionsInGroup(sinfo->splineName);
@@ -589,48 +762,61 @@ void CGForceMatching::EvalBonded(Topology *conf, SplineInfo *sinfo) {
       votca::Index ii = inter->getBeadId(loop);
       Eigen::Vector3d gradient = inter->Grad(*conf, loop);
 
-      SP.AddToFitMatrix(A_, var,
-                        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + ii,
+      SP.AddToFitMatrix(A, var,
+                        offset + ii,
                         mpos, -gradient.x());
       SP.AddToFitMatrix(
-          A_, var,
-          least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + ii, mpos,
+          A, var,
+          offset + nbeads_ + ii, mpos,
           -gradient.y());
       SP.AddToFitMatrix(
-          A_, var,
-          least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + ii,
+          A, var,
+          offset + 2 * nbeads_ + ii,
           mpos, -gradient.z());
     }
   }
 }
 
-void CGForceMatching::EvalNonbonded(Topology *conf, SplineInfo *sinfo) {
+template <typename matrix_type>
+void CGForceMatching::EvalNonbonded(Topology *conf, SplineInfo *sinfo,
+                                    matrix_type &A, votca::Index offset,
+                                    NBListContainer &nb_lists) {
 
-  // generate the neighbour list
-  std::unique_ptr<NBList> nb;
+  // the neighbour list of every interaction is kept between frames, so it can
+  // be reused as Verlet list
+  std::unique_ptr<NBList> &nb = nb_lists[sinfo->splineName];
 
-  bool gridsearch = false;
+  if (!nb) {
+    bool gridsearch = false;
 
-  if (options_.exists("cg.nbsearch")) {
-    if (options_.get("cg.nbsearch").as<string>() == "grid") {
-      gridsearch = true;
-    } else if (options_.get("cg.nbsearch").as<string>() == "simple") {
-      gridsearch = false;
+    if (options_.exists("cg.nbsearch")) {
+      if (options_.get("cg.nbsearch").as<string>() == "grid") {
+        gridsearch = true;
+      } else if (options_.get("cg.nbsearch").as<string>() == "simple") {
+        gridsearch = false;
+      } else {
+        throw std::runtime_error("cg.nbsearch invalid, can be grid or simple");
+      }
+    }
+    double skin = 0.0;
+    if (options_.exists("cg.nbsearch_skin")) {
+      skin = options_.get("cg.nbsearch_skin").as<double>();
+    }
+    if (gridsearch) {
+      auto nbgrid = std::make_unique<NBListGrid>();
+      nbgrid->setSkin(skin);
+      nb = std::move(nbgrid);
     } else {
-      throw std::runtime_error("cg.nbsearch invalid, can be grid or simple");
+      if (skin > 0.0) {
+        throw std::runtime_error("cg.nbsearch_skin requires cg.nbsearch grid");
+      }
+      nb = std::make_unique<NBList>();
     }
-  }
-  if (gridsearch) {
-    nb = std::make_unique<NBListGrid>();
-  } else {
-    nb = std::make_unique<NBList>();
-  }
 
-  nb->setCutoff(
-      sinfo->options_->get("fmatch.max").as<double>());  // implement different
-                                                         // cutoffs for
-                                                         // different
-                                                         // interactions!
+    // implement different cutoffs for different interactions!
+    nb->setCutoff(sinfo->options_->get("fmatch.max").as<double>());
+  }
+  nb->Cleanup();
 
   // generate the bead lists
   BeadList beads1, beads2;
@@ -656,35 +842,38 @@ void CGForceMatching::EvalNonbonded(Topology *conf, SplineInfo *sinfo) {
     votca::Index mpos = sinfo->matr_pos;
 
     // add iatom
-    SP.AddToFitMatrix(A_, var,
-                      least_sq_offset_ + 3 * nbeads_ * frame_counter_ + iatom,
+    SP.AddToFitMatrix(A, var,
+                      offset + iatom,
                       mpos, gradient.x());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + iatom, mpos,
+        A, var,
+        offset + nbeads_ + iatom, mpos,
         gradient.y());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + iatom,
+        A, var,
+        offset + 2 * nbeads_ + iatom,
         mpos, gradient.z());
 
     // add jatom
-    SP.AddToFitMatrix(A_, var,
-                      least_sq_offset_ + 3 * nbeads_ * frame_counter_ + jatom,
+    SP.AddToFitMatrix(A, var,
+                      offset + jatom,
                       mpos, -gradient.x());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + jatom, mpos,
+        A, var,
+        offset + nbeads_ + jatom, mpos,
         -gradient.y());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + jatom,
+        A, var,
+        offset + 2 * nbeads_ + jatom,
         mpos, -gradient.z());
   }
 }
 
+template <typename matrix_type>
 void CGForceMatching::EvalNonbonded_Threebody(Topology *conf,
-                                              SplineInfo *sinfo) {
+                                              SplineInfo *sinfo,
+                                              matrix_type &A,
+                                              votca::Index offset) {
   // so far option gridsearch ignored. Only simple search
 
   // generate the neighbour list
@@ -712,52 +901,14 @@ void CGForceMatching::EvalNonbonded_Threebody(Topology *conf,
   // Here, a is the distance between two beads of a triple, where the 3-body
   // interaction is zero
 
-  // generate the bead lists
-  BeadList beads1, beads2, beads3;
-  beads1.Generate(*conf, sinfo->type1);
-  beads2.Generate(*conf, sinfo->type2);
-  beads3.Generate(*conf, sinfo->type3);
-
-  // check if type1 and type2 are the same
-  if (sinfo->type1 == sinfo->type2) {
-    // if all three types are the same
-    if (sinfo->type2 == sinfo->type3) {
-      nb->Generate(beads1, true);
-    }
-    // if type2 and type3 are different, use the Generate function for 2 bead
-    // types
-    if (sinfo->type2 != sinfo->type3) {
-      nb->Generate(beads1, beads3, true);
-    }
-  }
-  // if type1 != type2
-  if (sinfo->type1 != sinfo->type2) {
-    // if the last two types are the same, use Generate function with them as
-    // the first two bead types Neighborlist_3body is constructed in a way that
-    // the two equal bead types have two be the first 2 types
-    if (sinfo->type2 == sinfo->type3) {
-      nb->Generate(beads1, beads2, true);
-    }
-    if (sinfo->type2 != sinfo->type3) {
-      // type1 = type3 !=type2
-      if (sinfo->type1 == sinfo->type3) {
-        nb->Generate(beads2, beads1, true);
-      }
-      // type1 != type2 != type3
-      if (sinfo->type1 != sinfo->type3) {
-        nb->Generate(beads1, beads2, beads3, true);
-      }
-    }
-  }
-
-  for (BeadTriple *triple : *nb) {
-    votca::Index iatom = triple->bead1()->getId();
-    votca::Index jatom = triple->bead2()->getId();
-    votca::Index katom = triple->bead3()->getId();
-    double distij = triple->dist12();
-    double distik = triple->dist13();
-    Eigen::Vector3d rij = triple->r12();
-    Eigen::Vector3d rik = triple->r13();
+  // the triples are streamed from the neighbour search, so they do not have
+  // to be stored
+  auto add_triple = [&](Bead *bead1, Bead *bead2, Bead *bead3,
+                        const Eigen::Vector3d &rij, const Eigen::Vector3d &rik,
+                        double distij, double distik) {
+    votca::Index iatom = bead1->getId();
+    votca::Index jatom = bead2->getId();
+    votca::Index katom = bead3->getId();
 
     double gamma_sigma = (sinfo->gamma) * (sinfo->sigma);
     double denomij = (distij - (sinfo->a) * (sinfo->sigma));
@@ -788,16 +939,16 @@ void CGForceMatching::EvalNonbonded_Threebody(Topology *conf,
         expij * expik;
 
     // add iatom
-    SP.AddToFitMatrix(A_, var,
-                      least_sq_offset_ + 3 * nbeads_ * frame_counter_ + iatom,
+    SP.AddToFitMatrix(A, var,
+                      offset + iatom,
                       mpos, -gradient1.x(), -gradient2.x());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + iatom, mpos,
+        A, var,
+        offset + nbeads_ + iatom, mpos,
         -gradient1.y(), -gradient2.y());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + iatom,
+        A, var,
+        offset + 2 * nbeads_ + iatom,
         mpos, -gradient1.z(), -gradient2.z());
 
     // evaluate gradient1 and gradient2 for jatom:
@@ -810,16 +961,16 @@ void CGForceMatching::EvalNonbonded_Threebody(Topology *conf,
                 expij * expik;
 
     // add jatom
-    SP.AddToFitMatrix(A_, var,
-                      least_sq_offset_ + 3 * nbeads_ * frame_counter_ + jatom,
+    SP.AddToFitMatrix(A, var,
+                      offset + jatom,
                       mpos, -gradient1.x(), -gradient2.x());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + jatom, mpos,
+        A, var,
+        offset + nbeads_ + jatom, mpos,
         -gradient1.y(), -gradient2.y());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + jatom,
+        A, var,
+        offset + 2 * nbeads_ + jatom,
         mpos, -gradient1.z(), -gradient2.z());
 
     // evaluate gradient1 and gradient2 for katom:
@@ -832,16 +983,54 @@ void CGForceMatching::EvalNonbonded_Threebody(Topology *conf,
                 expij * expik;
 
     // add katom
-    SP.AddToFitMatrix(A_, var,
-                      least_sq_offset_ + 3 * nbeads_ * frame_counter_ + katom,
+    SP.AddToFitMatrix(A, var,
+                      offset + katom,
                       mpos, -gradient1.x(), -gradient2.x());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + nbeads_ + katom, mpos,
+        A, var,
+        offset + nbeads_ + katom, mpos,
         -gradient1.y(), -gradient2.y());
     SP.AddToFitMatrix(
-        A_, var,
-        least_sq_offset_ + 3 * nbeads_ * frame_counter_ + 2 * nbeads_ + katom,
+        A, var,
+        offset + 2 * nbeads_ + katom,
         mpos, -gradient1.z(), -gradient2.z());
+  };
+
+  // generate the bead lists
+  BeadList beads1, beads2, beads3;
+  beads1.Generate(*conf, sinfo->type1);
+  beads2.Generate(*conf, sinfo->type2);
+  beads3.Generate(*conf, sinfo->type3);
+
+  // check if type1 and type2 are the same
+  if (sinfo->type1 == sinfo->type2) {
+    // if all three types are the same
+    if (sinfo->type2 == sinfo->type3) {
+      nb->ForEachTriple(beads1, beads1, beads1, add_triple, true);
+    }
+    // if type2 and type3 are different, pass the same list for the last two
+    // beads
+    if (sinfo->type2 != sinfo->type3) {
+      nb->ForEachTriple(beads1, beads3, beads3, add_triple, true);
+    }
+  }
+  // if type1 != type2
+  if (sinfo->type1 != sinfo->type2) {
+    // if the last two types are the same, pass them as the last two bead
+    // lists, Neighborlist_3body is constructed in a way that the two equal
+    // bead types have to be the last 2 types
+    if (sinfo->type2 == sinfo->type3) {
+      nb->ForEachTriple(beads1, beads2, beads2, add_triple, true);
+    }
+    if (sinfo->type2 != sinfo->type3) {
+      // type1 = type3 !=type2
+      if (sinfo->type1 == sinfo->type3) {
+        nb->ForEachTriple(beads2, beads1, beads1, add_triple, true);
+      }
+      // type1 != type2 != type3
+      if (sinfo->type1 != sinfo->type3) {
+        nb->ForEachTriple(beads1, beads2, beads3, add_triple, true);
+      }
+    }
   }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2009-2021 The VOTCA Development Team (http://www.votca.org)
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -18,12 +18,19 @@
 #ifndef VOTCA_CSG_CSG_FMATCH_H
 #define VOTCA_CSG_CSG_FMATCH_H
 
+// Standard includes
+#include <map>
+#include <memory>
+#include <vector>
+
 // VOTCA includes
 #include <votca/tools/cubicspline.h>
+#include <votca/tools/eigen.h>
 #include <votca/tools/property.h>
 
 // Local VOTCA includes
 #include "votca/csg/csgapplication.h"
+#include "votca/csg/nblist.h"
 #include "votca/csg/trajectoryreader.h"
 
 using namespace votca::csg;
@@ -49,6 +56,8 @@ class CGForceMatching : public CsgApplication {
 
   bool DoTrajectory() override { return true; }
   bool DoMapping() override { return true; }
+  bool DoThreaded() override { return true; }
+  bool SynchronizeThreads() override { return true; }
 
   void Initialize(void) override;
   bool EvaluateOptions() override;
@@ -63,7 +72,71 @@ class CGForceMatching : public CsgApplication {
   /// \brief load options from the input file
   void LoadOptions(const string &file);
 
+  std::unique_ptr<CsgApplication::Worker> ForkWorker() override;
+  void MergeWorker(CsgApplication::Worker *worker) override;
+
  protected:
+  using NBListContainer = std::map<std::string, std::unique_ptr<NBList>>;
+
+  /// \brief Collects the nonzero entries of the force matching equations.
+  /// Takes the place of the dense matrix in CubicSpline::AddToFitMatrix, each
+  /// access adds an entry and entries at the same position are summed up when
+  /// the sparse matrix is built.
+  class FitEntries {
+   public:
+    struct Entry {
+      votca::Index row_;
+      votca::Index col_;
+      double value_;
+      votca::Index row() const { return row_; }
+      votca::Index col() const { return col_; }
+      double value() const { return value_; }
+    };
+
+    double &operator()(votca::Index row, votca::Index col) {
+      entries_.push_back({row, col, 0.0});
+      return entries_.back().value_;
+    }
+    void clear() { entries_.clear(); }
+    /// \brief overwrites  matrix with the sum of the entries
+    void toMatrix(Eigen::SparseMatrix<double> &matrix) const {
+      matrix.setFromTriplets(entries_.begin(), entries_.end());
+    }
+
+   private:
+    std::vector<Entry> entries_;
+  };
+
+  /// \brief Worker for the normal equations solver: evaluates one frame
+  /// and keeps its contribution to A^T A and A^T b. For the dense solvers the
+  /// frames are passed on to CGForceMatching::EvalConfiguration.
+  class Worker : public CsgApplication::Worker {
+   public:
+    explicit Worker(CGForceMatching *fmatch) : fmatch_(fmatch) {}
+
+    void EvalConfiguration(Topology *conf, Topology *conf_atom) override;
+
+    std::unique_ptr<CsgApplication::Worker> DetachResult() override;
+    bool CanDetachResult() const override {
+      return fmatch_->normal_equations_;
+    }
+
+    /// \brief A^T A of the frame
+    Eigen::SparseMatrix<double> AtA_;
+    /// \brief A^T b of the frame
+    Eigen::VectorXd Atb_;
+    /// \brief b^T b of the frame, needed for the residual
+    double btb_ = 0.0;
+
+   private:
+    CGForceMatching *fmatch_;
+    /// \brief force matching equations of the current frame
+    FitEntries A_entries_;
+    Eigen::SparseMatrix<double> A_frame_;
+    Eigen::VectorXd b_frame_;
+    NBListContainer nb_lists_;
+  };
+
   /// \brief structure, which contains CubicSpline object with related
   /// parameters
   struct SplineInfo {
@@ -178,22 +251,60 @@ class CGForceMatching : public CsgApplication {
   /// \brief Counters for lines and columns in  B_constr_
   votca::Index line_cntr_, col_cntr_;
 
+  /// \brief Flag: accumulate the normal equations frame by frame instead of
+  /// storing  A_
+  bool normal_equations_ = false;
+  /// \brief Tikhonov parameter added to the diagonal of the normal equations
+  double regularization_ = 0.0;
+  /// \brief sum of A^T A over the frames of the block, only the lower
+  /// triangle is read
+  Eigen::MatrixXd AtA_;
+  /// \brief sum of A^T b over the frames of the block
+  Eigen::VectorXd Atb_;
+  /// \brief sum of b^T b over the frames of the block
+  double btb_ = 0.0;
+
   bool has_existing_forces_;
 
+  /// \brief neighbour lists of the non-bonded interactions, kept between
+  /// frames
+  NBListContainer nb_lists_;
+
   /// \brief Solves FM equations for one block and stores the results for
   /// further processing
   void FmatchAccumulateData();
+  /// \brief Solves the accumulated normal equations of one block
+  Eigen::VectorXd SolveNormalEquations() const;
+  /// \brief Solves and writes out the finished block, then clears the
+  /// equations for the next one
+  void FinishBlock();
+  /// \brief Checks the frame and subtracts the already known forces
+  void PrepareConfiguration(Topology *conf);
+  /// \brief Writes the equations of all interactions for one frame to  A,
+  /// starting at line  offset
+  template <typename matrix_type>
+  void EvalInteractions(Topology *conf, matrix_type &A, votca::Index offset,
+                        NBListContainer &nb_lists);
+  /// \brief Writes the reference forces of one frame to  b, starting at line
+  /// offset
+  void AssignForces(Topology *conf, Eigen::VectorXd &b, votca::Index offset);
   /// \brief Assigns smoothing conditions to matrices  A_ and  B_constr_
   void FmatchAssignSmoothCondsToMatrix(Eigen::MatrixXd &Matrix);
   /// \brief For each trajectory frame writes equations for bonded interactions
-  /// to matrix  A_
-  void EvalBonded(Topology *conf, SplineInfo *sinfo);
+  /// to  A
+  template <typename matrix_type>
+  void EvalBonded(Topology *conf, SplineInfo *sinfo, matrix_type &A,
+                  votca::Index offset);
   /// \brief For each trajectory frame writes equations for non-bonded
-  /// interactions to matrix  A_
-  void EvalNonbonded(Topology *conf, SplineInfo *sinfo);
+  /// interactions to  A
+  template <typename matrix_type>
+  void EvalNonbonded(Topology *conf, SplineInfo *sinfo, matrix_type &A,
+                     votca::Index offset, NBListContainer &nb_lists);
   /// \brief For each trajectory frame writes equations for non-bonded threebody
-  /// interactions to matrix  A_
-  void EvalNonbonded_Threebody(Topology *conf, SplineInfo *sinfo);
+  /// interactions to  A
+  template <typename matrix_type>
+  void EvalNonbonded_Threebody(Topology *conf, SplineInfo *sinfo,
+                               matrix_type &A, votca::Index offset);
   /// \brief Write results to output files
   void WriteOutFiles();
 
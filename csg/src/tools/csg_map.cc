@@ -71,6 +71,12 @@ class CsgMapApp : public CsgApplication {
                       "and "
                       "coarse-"
                       "grained");
+    AddProgramOptions()("single-precision",
+                        "  Store positions, velocities and forces in single "
+                        "precision (h5md only)")(
+        "compression",
+        boost::program_options::value<votca::Index>()->default_value(0),
+        "  Level 0-9 of lossless compression (h5md only)");
   }
 
   bool EvaluateOptions() override {
@@ -195,6 +201,8 @@ void CsgMapApp::BeginEvaluate(Topology *, Topology *) {
     do_force_ = true;
   }
 
+  writer_->setSinglePrecision(OptionsMap().count("single-precision") > 0);
+  writer_->setCompressionLevel(OptionsMap()["compression"].as<votca::Index>());
   writer_->Open(out);
 }
 
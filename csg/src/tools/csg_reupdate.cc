@@ -23,6 +23,7 @@
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 // VOTCA includes
 #include <votca/tools/constants.h>
@@ -370,90 +371,44 @@ void CsgREupdate::REUpdateLamda() {
 // do non bonded potential AA ensemble avg energy computations
 void CsgREupdate::AAavgNonbonded(PotentialInfo *potinfo) {
 
-  votca::Index pos_start = potinfo->vec_pos;
-  votca::Index pos_max = pos_start + potinfo->ucg->getOptParamSize();
-  double dU_i, d2U_ij;
-  double U;
   votca::Index indx = potinfo->potentialIndex;
 
-  // compute avg AA energy
-  U = 0.0;
-
+  // number of pairs in each bin of the AA rdf
   // assuming rdf bins are of same size
   double step = aardfs_[indx]->x(2) - aardfs_[indx]->x(1);
-
+  std::vector<double> r_hist;
+  std::vector<double> n_hist;
   for (votca::Index bin = 0; bin < aardfs_[indx]->size(); bin++) {
 
-    double r_hist = aardfs_[indx]->x(bin);
-    double r1 = r_hist - 0.5 * step;
+    double r = aardfs_[indx]->x(bin);
+    double r1 = r - 0.5 * step;
     double r2 = r1 + step;
-    double n_hist =
+    double n =
         aardfs_[indx]->y(bin) * (*aardfnorms_[indx]) *
         (4. / 3. * votca::tools::conv::Pi * (r2 * r2 * r2 - r1 * r1 * r1));
 
-    if (n_hist > 0.0) {
-      U += n_hist * potinfo->ucg->CalculateF(r_hist);
+    if (n > 0.0) {
+      r_hist.push_back(r);
+      n_hist.push_back(n);
     }
   }
 
+  double U;
+  Eigen::VectorXd dU;
+  Eigen::MatrixXd d2U;
+  Eigen::Map<Eigen::VectorXd> r_map(r_hist.data(),
+                                    votca::Index(r_hist.size()));
+  Eigen::Map<Eigen::VectorXd> n_map(n_hist.data(),
+                                    votca::Index(n_hist.size()));
+  potinfo->ucg->CalculateDerivatives(r_map, n_map, U, dU, d2U);
+
+  // compute avg AA energy, dU/dlamda and d2U/dlamda_i dlamda_j
   UavgAA_ += U;
 
-  // computing dU/dlamda and d2U/dlamda_i dlamda_j
-  for (votca::Index row = pos_start; row < pos_max; row++) {
-
-    // ith parameter of this potential
-    votca::Index lamda_i = row - pos_start;
-
-    // compute dU/dlamda and add to  DS_
-    dU_i = 0.0;
-
-    for (votca::Index bin = 0; bin < aardfs_[indx]->size(); bin++) {
-
-      double r_hist = aardfs_[indx]->x(bin);
-      double r1 = r_hist - 0.5 * step;
-      double r2 = r1 + step;
-      double n_hist =
-          aardfs_[indx]->y(bin) * (*aardfnorms_[indx]) *
-          (4. / 3. * votca::tools::conv::Pi * (r2 * r2 * r2 - r1 * r1 * r1));
-
-      if (n_hist > 0.0) {
-        dU_i += n_hist * potinfo->ucg->CalculateDF(lamda_i, r_hist);
-      }
-
-    }  // end loop over hist
-
-    DS_(row) += (beta_ * dU_i);
-
-    for (votca::Index col = row; col < pos_max; col++) {
-
-      votca::Index lamda_j = col - pos_start;
-
-      // compute d2U/dlamda_i dlamda_j and add to  HS_
-      d2U_ij = 0.0;
-
-      for (votca::Index bin = 0; bin < aardfs_[indx]->size(); bin++) {
-
-        double r_hist = aardfs_[indx]->x(bin);
-        double r1 = r_hist - 0.5 * step;
-        double r2 = r1 + step;
-        double n_hist =
-            aardfs_[indx]->y(bin) * (*aardfnorms_[indx]) *
-            (4. / 3. * votca::tools::conv::Pi * (r2 * r2 * r2 - r1 * r1 * r1));
-
-        if (n_hist > 0.0) {
-          d2U_ij +=
-              n_hist * potinfo->ucg->CalculateD2F(lamda_i, lamda_j, r_hist);
-        }
-
-      }  // end loop pair_iter
-
-      HS_(row, col) += (beta_ * d2U_ij);
-      if (row != col) {
-        HS_(col, row) += (beta_ * d2U_ij);
-      }
-    }  // end loop col
-
-  }  // end loop row
+  votca::Index pos_start = potinfo->vec_pos;
+  votca::Index nopt = potinfo->ucg->getOptParamSize();
+  DS_.segment(pos_start, nopt) += beta_ * dU;
+  HS_.block(pos_start, pos_start, nopt, nopt) += beta_ * d2U;
 }
 
 // do bonded potential AA ensemble avg energy computations
@@ -598,46 +553,26 @@ void CsgREupdateWorker::EvalNonbonded(Topology *conf, PotentialInfo *potinfo) {
     nb->Generate(beads1, beads2, true);
   }
 
-  votca::Index pos_start = potinfo->vec_pos;
-  votca::Index pos_max = pos_start + potinfo->ucg->getOptParamSize();
-
-  // compute total energy
-  double U = 0.0;
+  // collect the pair distances once and let the potential function sum up
+  // the energy and its derivatives over all of them
+  Eigen::VectorXd dist(nb->size());
+  votca::Index k = 0;
   for (auto &pair_iter : *nb) {
-    U += potinfo->ucg->CalculateF(pair_iter->dist());
+    dist(k++) = pair_iter->dist();
   }
+  Eigen::VectorXd ones = Eigen::VectorXd::Ones(dist.size());
 
-  UavgCG_ += U;
-
-  // computing dU/dlamda and d2U/dlamda_i dlamda_j
-  for (votca::Index row = pos_start; row < pos_max; row++) {
-
-    votca::Index lamda_i = row - pos_start;
-
-    double dU_i = 0.0;
-    for (auto &pair_iter : *nb) {
-      dU_i += potinfo->ucg->CalculateDF(lamda_i, pair_iter->dist());
-    }
-
-    dUFrame_(row) = dU_i;
-
-    for (votca::Index col = row; col < pos_max; col++) {
-
-      votca::Index lamda_j = col - pos_start;
-      double d2U_ij = 0.0;
-
-      for (auto &pair_iter : *nb) {
-        d2U_ij +=
-            potinfo->ucg->CalculateD2F(lamda_i, lamda_j, pair_iter->dist());
-      }
+  double U;
+  Eigen::VectorXd dU;
+  Eigen::MatrixXd d2U;
+  potinfo->ucg->CalculateDerivatives(dist, ones, U, dU, d2U);
 
-      HS_(row, col) -= beta_ * d2U_ij;
-      if (row != col) {
-        HS_(col, row) -= beta_ * d2U_ij;
-      }
-    }  // end loop col
+  UavgCG_ += U;
 
-  }  // end loop row
+  votca::Index pos_start = potinfo->vec_pos;
+  votca::Index nopt = potinfo->ucg->getOptParamSize();
+  dUFrame_.segment(pos_start, nopt) = dU;
+  HS_.block(pos_start, pos_start, nopt, nopt) -= beta_ * d2U;
 }
 
 // do bonded potential related update stuff for the current frame in evalconfig
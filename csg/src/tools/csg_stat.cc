@@ -110,6 +110,8 @@ bool CsgStatApp::EvaluateOptions() {
     imc_.IncludeIntra(true);
   }
 
+  imc_.ThreadedWorkers(nthreads_ > 1);
+
   imc_.Extension(extension_);
 
   imc_.Initialize();
@@ -282,22 +282,48 @@ void Imc::ClearAverages() {
   }
   for (auto &group : groups_) {
     group.second->corr_.setZero();
+    group.second->nbuffered_ = 0;
   }
 }
 
+// the distances are collected and histogrammed at once by Flush
 class IMCNBSearchHandler {
  public:
-  explicit IMCNBSearchHandler(votca::tools::HistogramNew *hist)
-      : hist_(*hist) {}
+  IMCNBSearchHandler(votca::tools::HistogramNew *hist,
+                     std::vector<double> *dist)
+      : hist_(*hist), dist_(*dist) {
+    dist_.clear();
+  }
 
   votca::tools::HistogramNew &hist_;
+  std::vector<double> &dist_;
 
   bool FoundPair(Bead *, Bead *, const Eigen::Vector3d &, const double dist) {
-    hist_.Process(dist);
+    dist_.push_back(dist);
     return false;
   }
+
+  void Flush() {
+    hist_.ProcessRange(dist_.data(), votca::Index(dist_.size()));
+    dist_.clear();
+  }
 };
 
+NBListGrid &Imc::Worker::getNBList(
+    std::map<std::string, std::unique_ptr<NBListGrid> > &lists,
+    const std::string &name, double cutoff) {
+  std::unique_ptr<NBListGrid> &nb = lists[name];
+  if (!nb) {
+    nb = std::make_unique<NBListGrid>();
+    nb->setCutoff(cutoff);
+    if (imc_->options_.exists("cg.nbsearch_skin")) {
+      nb->setSkin(imc_->options_.get("cg.nbsearch_skin").as<double>());
+    }
+  }
+  nb->Cleanup();
+  return *nb;
+}
+
 // process non-bonded interactions for current frame
 void Imc::Worker::DoNonbonded(Topology *top) {
   for (tools::Property *prop : imc_->nonbonded_) {
@@ -345,45 +371,50 @@ void Imc::Worker::DoNonbonded(Topology *top) {
       // Here, a is the distance between two beads of a triple, where the 3-body
       // interaction is zero
 
+      // only the angles are collected while the triples are found, so the
+      // triples do not have to be stored
+      values_.clear();
+      auto process_triple = [this](Bead *, Bead *, Bead *,
+                                   const Eigen::Vector3d &rij,
+                                   const Eigen::Vector3d &rik, double,
+                                   double) {
+        values_.push_back(std::acos(
+            rij.dot(rik) / sqrt(rij.squaredNorm() * rik.squaredNorm())));
+      };
+
       // check if type1 and type2 are the same
       if (prop->get("type1").value() == prop->get("type2").value()) {
         // if all three types are the same
         if (prop->get("type2").value() == prop->get("type3").value()) {
-          nb->Generate(beads1, true);
+          nb->ForEachTriple(beads1, beads1, beads1, process_triple, true);
         }
-        // if type2 and type3 are different, use the Generate function for 2
-        // bead types
+        // if type2 and type3 are different, pass the same list for the last
+        // two beads
         if (prop->get("type2").value() != prop->get("type3").value()) {
-          nb->Generate(beads1, beads3, true);
+          nb->ForEachTriple(beads1, beads3, beads3, process_triple, true);
         }
       }
       // if type1 != type2
       if (prop->get("type1").value() != prop->get("type2").value()) {
-        // if the last two types are the same, use Generate function with them
-        // as the first two bead types Neighborlist_3body is constructed in a
-        // way that the two equal bead types have two be the first 2 types
+        // if the last two types are the same, pass them as the last two bead
+        // lists, Neighborlist_3body is constructed in a way that the two equal
+        // bead types have to be the last 2 types
         if (prop->get("type2").value() == prop->get("type3").value()) {
-          nb->Generate(beads1, beads2, true);
+          nb->ForEachTriple(beads1, beads2, beads2, process_triple, true);
         }
         if (prop->get("type2").value() != prop->get("type3").value()) {
           // type1 = type3 !=type2
           if (prop->get("type1").value() == prop->get("type3").value()) {
-            nb->Generate(beads2, beads1, true);
+            nb->ForEachTriple(beads2, beads1, beads1, process_triple, true);
           }
           // type1 != type2 != type3
           if (prop->get("type1").value() != prop->get("type3").value()) {
-            nb->Generate(beads1, beads2, beads3, true);
+            nb->ForEachTriple(beads1, beads2, beads3, process_triple, true);
           }
         }
       }
-
-      for (auto &triple : *nb) {
-        Eigen::Vector3d rij = triple->r12();
-        Eigen::Vector3d rik = triple->r13();
-        double var = std::acos(rij.dot(rik) /
-                               sqrt(rij.squaredNorm() * rik.squaredNorm()));
-        current_hists_[i.index_].Process(var);
-      }
+      current_hists_[i.index_].ProcessRange(values_.data(),
+                                            votca::Index(values_.size()));
     }
     // 2body interaction
     if (!i.threebody_) {
@@ -395,57 +426,49 @@ void Imc::Worker::DoNonbonded(Topology *top) {
       beads2.Generate(*top, prop->get("type2").value());
 
       {
-        // generate the neighbour list
-        std::unique_ptr<NBList> nb;
-        if (gridsearch) {
-          nb = std::unique_ptr<NBList>(new NBListGrid());
-        } else {
-          nb = std::unique_ptr<NBList>(new NBListGrid());
-        }
-
-        nb->setCutoff(i.max_ + i.step_);
+        // the neighbour lists are kept per worker and interaction, so they
+        // can be reused as Verlet lists in the next frame
+        NBListGrid &nb = getNBList(nb_lists_, name, i.max_ + i.step_);
 
-        IMCNBSearchHandler h(&(current_hists_[i.index_]));
+        IMCNBSearchHandler h(&(current_hists_[i.index_]), &values_);
 
-        nb->SetMatchFunction(&h, &IMCNBSearchHandler::FoundPair);
+        nb.SetMatchFunction(&h, &IMCNBSearchHandler::FoundPair);
 
         // is it same types or different types?
         if (prop->get("type1").value() == prop->get("type2").value()) {
-          nb->Generate(beads1, !(imc_->include_intra_));
+          nb.Generate(beads1, !(imc_->include_intra_));
         } else {
-          nb->Generate(beads1, beads2, !(imc_->include_intra_));
+          nb.Generate(beads1, beads2, !(imc_->include_intra_));
         }
+        h.Flush();
       }
 
       // if one wants to calculate the mean force
       if (i.force_) {
-        std::unique_ptr<NBList> nb_force;
-        if (gridsearch) {
-          nb_force = std::unique_ptr<NBList>(new NBListGrid());
-        } else {
-          nb_force = std::unique_ptr<NBList>(new NBListGrid());
-        }
-
-        nb_force->setCutoff(i.max_ + i.step_);
+        NBListGrid &nb_force =
+            getNBList(nb_force_lists_, name, i.max_ + i.step_);
 
         // is it same types or different types?
         if (prop->get("type1").value() == prop->get("type2").value()) {
-          nb_force->Generate(beads1);
+          nb_force.Generate(beads1);
         } else {
-          nb_force->Generate(beads1, beads2);
+          nb_force.Generate(beads1, beads2);
         }
 
         // process all pairs to calculate the projection of the
         // mean force on bead 1 on the pair distance: F1 * r12
-        for (auto &pair : *nb_force) {
+        values_.clear();
+        weights_.clear();
+        for (auto &pair : nb_force) {
           Eigen::Vector3d F2 = pair->second()->getF();
           Eigen::Vector3d F1 = pair->first()->getF();
           Eigen::Vector3d r12 = pair->r();
           r12.normalize();
-          double var = pair->dist();
-          double scale = 0.5 * (F2 - F1).dot(r12);
-          current_hists_force_[i.index_].Process(var, scale);
+          values_.push_back(pair->dist());
+          weights_.push_back(0.5 * (F2 - F1).dot(r12));
         }
+        current_hists_force_[i.index_].ProcessRange(
+            values_.data(), votca::Index(values_.size()), weights_.data());
       }
     }
   }
@@ -462,10 +485,12 @@ void Imc::Worker::DoBonded(Topology *top) {
     current_hists_[i.index_].Clear();
 
     // now fill with new data
+    values_.clear();
     for (Interaction *ic : top->InteractionsInGroup(name)) {
-      double v = ic->EvaluateVar(*top);
-      current_hists_[i.index_].Process(v);
+      values_.push_back(ic->EvaluateVar(*top));
     }
+    current_hists_[i.index_].ProcessRange(values_.data(),
+                                          votca::Index(values_.size()));
   }
 }
 
@@ -507,6 +532,8 @@ void Imc::InitializeGroups() {
 
     // initialize matrix with zeroes
     M = Eigen::MatrixXd::Zero(n, n);
+    grp->frames_ = Eigen::MatrixXd::Zero(n, correlation_block_);
+    grp->nbuffered_ = 0;
 
     // now create references to the sub matrices and offsets
     votca::Index offset_i = 0;
@@ -535,20 +562,39 @@ void Imc::DoCorrelations(Imc::Worker *worker) {
     return;
   }
 
+  // the frames are collected and added as one matrix product instead of a
+  // rank-1 update of the whole matrix per frame
   for (auto &group : groups_) {
     auto &grp = group.second;
-    // update correlation for all pairs
-    for (auto &pair : grp->pairs_) {
-      Eigen::VectorXd &a = worker->current_hists_[pair.i1_->index_].data().y();
-      Eigen::VectorXd &b = worker->current_hists_[pair.i2_->index_].data().y();
-      pair_matrix &M = pair.corr_;
-
-      M = ((((double)nframes_ - 1.0) * M) + a * b.transpose()) /
-          (double)nframes_;
+    votca::Index offset = 0;
+    for (interaction_t *ic : grp->interactions_) {
+      votca::Index n = ic->average_.getNBins();
+      grp->frames_.col(grp->nbuffered_).segment(offset, n) =
+          worker->current_hists_[ic->index_].data().y();
+      offset += n;
+    }
+    ++grp->nbuffered_;
+    if (grp->nbuffered_ == correlation_block_) {
+      FlushCorrelations(*grp);
     }
   }
 }
 
+void Imc::FlushCorrelations(group_t &grp) {
+  if (grp.nbuffered_ == 0) {
+    return;
+  }
+  auto frames = grp.frames_.leftCols(grp.nbuffered_);
+  // update correlation for all pairs
+  for (auto &pair : grp.pairs_) {
+    votca::Index n1 = pair.i1_->average_.getNBins();
+    votca::Index n2 = pair.i2_->average_.getNBins();
+    pair.corr_.noalias() += frames.middleRows(pair.offset_i_, n1) *
+                            frames.middleRows(pair.offset_j_, n2).transpose();
+  }
+  grp.nbuffered_ = 0;
+}
+
 // write the distribution function
 void Imc::WriteDist(const string &suffix) {
   map<string, interaction_t *>::iterator iter;
@@ -653,7 +699,8 @@ void Imc::WriteIMCData(const string &suffix) {
 
     // build full set of equations + copy some data to make
     // code better to read
-    group_matrix gmc(grp->corr_);
+    FlushCorrelations(*grp);
+    group_matrix gmc = grp->corr_ / (double)nframes_;
     tools::Table dS;
     dS.resize(n);
     // the next two variables are to later extract the individual parts
@@ -768,7 +815,8 @@ void Imc::WriteIMCBlock(const string &suffix) {
     votca::Index n = grp->corr_.rows();
 
     // build full set of equations + copy some data to make code better to read
-    group_matrix gmc(grp->corr_);
+    FlushCorrelations(*grp);
+    group_matrix gmc = grp->corr_ / (double)nframes_;
     Eigen::VectorXd dS(n);
     Eigen::VectorXd r(n);
     // the next two variables are to later extract the individual parts
@@ -826,9 +874,9 @@ void Imc::WriteIMCBlock(const string &suffix) {
       throw runtime_error(string("error, cannot open file ") + name_cor);
     }
 
-    for (votca::Index i = 0; i < grp->corr_.rows(); ++i) {
-      for (votca::Index j = 0; j < grp->corr_.cols(); ++j) {
-        out_cor << grp->corr_(i, j) << " ";
+    for (votca::Index i = 0; i < gmc.rows(); ++i) {
+      for (votca::Index j = 0; j < gmc.cols(); ++j) {
+        out_cor << gmc(i, j) << " ";
       }
       out_cor << endl;
     }
@@ -848,16 +896,27 @@ std::unique_ptr<CsgApplication::Worker> Imc::ForkWorker() {
     auto &i = interaction.second;
     worker->current_hists_[i->index_].Initialize(
         i->average_.getMin(), i->average_.getMax(), i->average_.getNBins());
+    worker->current_hists_[i->index_].setParallel(!threaded_workers_);
     // preliminary
     if (interaction.second->force_) {
       worker->current_hists_force_[i->index_].Initialize(
           i->average_force_.getMin(), i->average_force_.getMax(),
           i->average_force_.getNBins());
+      worker->current_hists_force_[i->index_].setParallel(!threaded_workers_);
     }
   }
   return worker;
 }
 
+std::unique_ptr<CsgApplication::Worker> Imc::Worker::DetachResult() {
+  auto result = std::make_unique<Imc::Worker>();
+  result->imc_ = imc_;
+  result->cur_vol_ = cur_vol_;
+  result->current_hists_ = current_hists_;
+  result->current_hists_force_ = current_hists_force_;
+  return result;
+}
+
 void Imc::MergeWorker(CsgApplication::Worker *worker_) {
   processed_some_frames_ = true;
   Imc::Worker *worker = dynamic_cast<Imc::Worker *>(worker_);
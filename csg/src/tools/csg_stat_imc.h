@@ -25,6 +25,7 @@
 
 // Local VOTCA includes
 #include "votca/csg/csgapplication.h"
+#include "votca/csg/nblistgrid.h"
 
 namespace votca {
 namespace csg {
@@ -52,6 +53,8 @@ class Imc {
   void BlockLength(votca::Index length) { block_length_ = length; }
   void DoImc(bool do_imc) { do_imc_ = do_imc; }
   void IncludeIntra(bool include_intra) { include_intra_ = include_intra; }
+  /// the histograms of a worker only use threads if there is one worker
+  void ThreadedWorkers(bool threaded) { threaded_workers_ = threaded; }
   void Extension(std::string ext) { extension_ = ext; }
 
  protected:
@@ -87,10 +90,17 @@ class Imc {
   /// struct to store collected information for groups (e.g. crosscorrelations)
   struct group_t {
     std::vector<interaction_t *> interactions_;
+    /// sum of the correlations over all frames, normalized when written
     group_matrix corr_;
     std::vector<pair_t> pairs_;
+    /// histograms of the frames not yet added to corr_, one frame per column
+    Eigen::MatrixXd frames_;
+    votca::Index nbuffered_ = 0;
   };
 
+  /// number of frames which are added to the correlations at once
+  static constexpr votca::Index correlation_block_ = 64;
+
   /// the options parsed from cg definition file
   tools::Property options_;
   // length of the block to write out and averages are clear after every write
@@ -99,6 +109,7 @@ class Imc {
   bool do_imc_ = false;
   // include the intramolecular neighbors
   bool include_intra_ = false;
+  bool threaded_workers_ = false;
 
   // file extension for the distributions
   std::string extension_;
@@ -141,6 +152,10 @@ class Imc {
     std::vector<tools::HistogramNew> current_hists_force_;
     Imc *imc_;
     double cur_vol_;
+    /// values (and weights) of the current interaction, they are added to
+    /// the histogram at once
+    std::vector<double> values_;
+    std::vector<double> weights_;
 
     /// evaluate current conformation
     void EvalConfiguration(Topology *top, Topology *top_atom) override;
@@ -148,9 +163,25 @@ class Imc {
     void DoNonbonded(Topology *top);
     /// process bonded interactions for given frame
     void DoBonded(Topology *top);
+
+    /// copy the histograms of the current frame for the ordered merge
+    std::unique_ptr<CsgApplication::Worker> DetachResult() override;
+    bool CanDetachResult() const override { return true; }
+
+   private:
+    /// neighbour lists of the non-bonded interactions, kept between frames
+    std::map<std::string, std::unique_ptr<NBListGrid> > nb_lists_;
+    std::map<std::string, std::unique_ptr<NBListGrid> > nb_force_lists_;
+
+    /// get the neighbour list of an interaction, creates it if needed
+    NBListGrid &getNBList(
+        std::map<std::string, std::unique_ptr<NBListGrid> > &lists,
+        const std::string &name, double cutoff);
   };
   /// update the correlations after interations were processed
   void DoCorrelations(Imc::Worker *worker);
+  /// add the buffered frames of a group to the correlations
+  void FlushCorrelations(group_t &grp);
 
   bool processed_some_frames_ = false;
 
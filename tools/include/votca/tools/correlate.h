@@ -24,6 +24,7 @@
 
 // Local VOTCA includes
 #include "datacollection.h"
+#include "eigen.h"
 
 namespace votca {
 namespace tools {
@@ -43,11 +44,26 @@ class Correlate {
    */
   void CalcCorrelations(DataCollection<double>::selection &data);
 
+  /**
+      calculate the correlation of all pairs of rows in selection
+
+      The rows are centered and normalized into the columns of a matrix X, so
+      the correlation matrix is X^T X, which is calculated with one symmetric
+      rank-k update instead of one dot product per pair.
+   */
+  void CalcCorrelationMatrix(DataCollection<double>::selection &data);
+
   std::vector<double> &getData() { return corr_; }
   const std::vector<double> &getData() const { return corr_; }
 
+  const Eigen::MatrixXd &getCorrelationMatrix() const { return matrix_; }
+
  private:
   std::vector<double> corr_;
+  Eigen::MatrixXd matrix_;
+
+  /// centered rows of selection with unit norm as columns of a matrix
+  static Eigen::MatrixXd Normalize(DataCollection<double>::selection &data);
 };
 
 inline std::ostream &operator<<(std::ostream &out, const Correlate &c) {
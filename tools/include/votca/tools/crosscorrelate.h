@@ -38,13 +38,25 @@ class CrossCorrelate {
   CrossCorrelate() = default;
   ~CrossCorrelate() = default;
 
+  /// autocorrelation of the first row in selection
   void AutoCorrelate(DataCollection<double>::selection& data);
+  /**
+      autocorrelation of all rows in selection
+
+      Uses real to complex FFTs, the rows are distributed over the threads
+      and every thread reuses its FFT plan for all of its rows.
+   */
+  void AutoCorrelations(DataCollection<double>::selection& data);
 
   std::vector<double>& getData() { return corrfunc_; }
   const std::vector<double>& getData() const { return corrfunc_; }
 
+  /// column i is the autocorrelation of row i of the last AutoCorrelations
+  const Eigen::MatrixXd& getAutocorrelations() const { return corrfuncs_; }
+
  private:
   std::vector<double> corrfunc_;
+  Eigen::MatrixXd corrfuncs_;
 };
 
 inline std::ostream& operator<<(std::ostream& out, const CrossCorrelate& c) {
@@ -74,8 +74,11 @@ class CubicSpline : public Spline {
   // Calculate the function derivative
   double CalculateDerivative(double r) override;
 
-  using Spline::Calculate;
-  using Spline::CalculateDerivative;
+  // Calculate the function values for many points at once
+  Eigen::VectorXd Calculate(const Eigen::VectorXd &r) override;
+
+  // Calculate the function derivatives for many points at once
+  Eigen::VectorXd CalculateDerivative(const Eigen::VectorXd &r) override;
 
   // set spline parameters to values that were externally computed
   void setSplineData(const Eigen::VectorXd &f, const Eigen::VectorXd &f2) {
@@ -146,15 +149,16 @@ class CubicSpline : public Spline {
   // A spline can be written in the form
   // S_i(x) =   A(x,x_i,x_i+1)*f_i     + B(x,x_i,x_i+1)*f'' i_
   //          + C(x,x_i,x_i+1)*f_{i+1} + D(x,x_i,x_i+1)*f''_{i+1}
-  double A(double r);
-  double B(double r);
-  double C(double r);
-  double D(double r);
+  // the second argument is the interval i, as given by getInterval(r)
+  double A(double r, Index i);
+  double B(double r, Index i);
+  double C(double r, Index i);
+  double D(double r, Index i);
 
-  double Aprime(double r);
-  double Bprime(double r);
-  double Cprime(double r);
-  double Dprime(double r);
+  double Aprime(double r, Index i);
+  double Bprime(double r, Index i);
+  double Cprime(double r, Index i);
+  double Dprime(double r, Index i);
 
   // tabulated derivatives at grid points. Second argument: 0 - left, 1 - right
   double A_prime_l(Index i);
@@ -171,10 +175,10 @@ template <typename matrix_type>
 inline void CubicSpline::AddToFitMatrix(matrix_type &M, double x, Index offset1,
                                         Index offset2, double scale) {
   Index spi = getInterval(x);
-  M(offset1, offset2 + spi) += A(x) * scale;
-  M(offset1, offset2 + spi + 1) += B(x) * scale;
-  M(offset1, offset2 + spi + r_.size()) += C(x) * scale;
-  M(offset1, offset2 + spi + r_.size() + 1) += D(x) * scale;
+  M(offset1, offset2 + spi) += A(x, spi) * scale;
+  M(offset1, offset2 + spi + 1) += B(x, spi) * scale;
+  M(offset1, offset2 + spi + r_.size()) += C(x, spi) * scale;
+  M(offset1, offset2 + spi + r_.size() + 1) += D(x, spi) * scale;
 }
 
 // for adding f'(x)*scale1 + f(x)*scale2 as needed for threebody interactions
@@ -183,10 +187,10 @@ inline void CubicSpline::AddToFitMatrix(matrix_type &M, double x, Index offset1,
                                         Index offset2, double scale1,
                                         double scale2) {
   Index spi = getInterval(x);
-  M(offset1, offset2 + spi) += Aprime(x) * scale1;
-  M(offset1, offset2 + spi + 1) += Bprime(x) * scale1;
-  M(offset1, offset2 + spi + r_.size()) += Cprime(x) * scale1;
-  M(offset1, offset2 + spi + r_.size() + 1) += Dprime(x) * scale1;
+  M(offset1, offset2 + spi) += Aprime(x, spi) * scale1;
+  M(offset1, offset2 + spi + 1) += Bprime(x, spi) * scale1;
+  M(offset1, offset2 + spi + r_.size()) += Cprime(x, spi) * scale1;
+  M(offset1, offset2 + spi + r_.size() + 1) += Dprime(x, spi) * scale1;
 
   AddToFitMatrix(M, x, offset1, offset2, scale2);
 }
@@ -196,10 +200,10 @@ inline void CubicSpline::AddToFitMatrix(matrix_type &M, vector_type &x,
                                         Index offset1, Index offset2) {
   for (Index i = 0; i < x.size(); ++i) {
     Index spi = getInterval(x(i));
-    M(offset1 + i, offset2 + spi) = A(x(i));
-    M(offset1 + i, offset2 + spi + 1) = B(x(i));
-    M(offset1 + i, offset2 + spi + r_.size()) = C(x(i));
-    M(offset1 + i, offset2 + spi + r_.size() + 1) = D(x(i));
+    M(offset1 + i, offset2 + spi) = A(x(i), spi);
+    M(offset1 + i, offset2 + spi + 1) = B(x(i), spi);
+    M(offset1 + i, offset2 + spi + r_.size()) = C(x(i), spi);
+    M(offset1 + i, offset2 + spi + r_.size() + 1) = D(x(i), spi);
   }
 }
 
@@ -152,6 +152,7 @@ void DataCollection<T>::clear() {
     delete d;
   }
   data_.clear();
+  array_by_name_.clear();
 }
 
 template <typename T>
@@ -50,6 +50,17 @@ class Histogram {
    */
   void ProcessData(DataCollection<double>::selection *data);
 
+  /**
+      process weighted values, e.g. the bins of a finer histogram
+
+      For an automatic interval the smallest and largest value of the
+      underlying data have to be given, they are used instead of the range of
+      values.
+   */
+  void ProcessWeightedData(const std::vector<double> &values,
+                           const std::vector<double> &weights,
+                           double data_min, double data_max);
+
   /// returns the minimum value
   double getMin() const { return min_; }
   /// return the maximum value
@@ -79,6 +90,12 @@ class Histogram {
   double interval_;
 
   options_t options_;
+
+  /// set the interval from the options and the range of the data
+  void InitializeInterval(double data_min, double data_max);
+  void Add(double value, double weight);
+  /// apply the volume scaling, periodicity and normalization
+  void Finalize();
 };
 
 inline std::ostream &operator<<(std::ostream &out, Histogram &h) {
@@ -76,6 +76,15 @@ namespace tools {
  */
 class HistogramNew {
  public:
+  /// how the weight of a value is distributed over the bins
+  enum class Assignment {
+    /// the bin with the nearest center gets the whole weight, like Process
+    nearest,
+    /// the weight is split linearly between the two bins around the value
+    /// (cloud in cell)
+    linear
+  };
+
   /**
    * \brief Initialize the HistogramNew
    * @param min lower bound of interval
@@ -98,6 +107,25 @@ class HistogramNew {
   template <typename iterator_type>
   void ProcessRange(const iterator_type &begin, const iterator_type &end);
 
+  /**
+   * \brief process n contiguous values at once
+   *
+   * The bins are computed in blocks with Eigen array operations. Large ranges
+   * are split over the OpenMP threads, every thread fills a private copy of
+   * the histogram and the copies are added at the end. Values which are not
+   * finite are ignored.
+   *
+   * \param values pointer to the first value
+   * \param n number of values
+   * \param weights weight of each value, nullptr means 1 for all values
+   * \param assignment how the weight is distributed over the bins. With
+   * linear assignment the parts that fall outside of a non periodic
+   * histogram are dropped.
+   */
+  void ProcessRange(const double *values, Index n,
+                    const double *weights = nullptr,
+                    Assignment assignment = Assignment::nearest);
+
   /**
    * \brief get the lower bound of the histogram intervaö
    * \return lower limit of interval
@@ -163,12 +191,22 @@ class HistogramNew {
    */
   void setPeriodic(bool periodic) { periodic_ = periodic; }
 
+  /**
+   * \brief set whether ProcessRange may use threads, e.g. if the histogram is
+   * already filled from a threaded worker
+   */
+  void setParallel(bool parallel) { parallel_ = parallel; }
+
  private:
   void Initialize_();
+  void ProcessBlock_(const double *values, const double *weights, Index n,
+                     Assignment assignment, Eigen::ArrayXd &pos,
+                     Eigen::VectorXd &y) const;
   double min_ = 0;
   double max_ = 0;
   double step_ = 0;
   bool periodic_ = false;
+  bool parallel_ = true;
   Index nbins_ = 100;
   Table data_;
 };
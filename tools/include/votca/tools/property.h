@@ -21,11 +21,13 @@
 // Standard includes
 #include <cstdlib>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 // Third party includes
 #include <boost/algorithm/string/trim.hpp>
@@ -41,6 +43,28 @@
 namespace votca {
 namespace tools {
 
+/**
+ * \brief key of a Property, which is split into its components only once
+ *
+ * The components are separated by "." and may contain the wildcards "*" and
+ * "?" for Property::Select. A key which is looked up repeatedly, e.g. for
+ * every job of a job file, should be compiled once into a PropertyPath.
+ */
+class PropertyPath {
+ public:
+  explicit PropertyPath(const std::string &key);
+
+  const std::string &key() const { return key_; }
+  const std::vector<std::string> &components() const { return components_; }
+  /// true if the i-th component contains a wildcard
+  bool isWildcard(Index i) const { return wildcard_[i]; }
+
+ private:
+  std::string key_;
+  std::vector<std::string> components_;
+  std::vector<bool> wildcard_;
+};
+
 /**
  * \brief class to manage program options with xml serialization functionality
  *
@@ -113,6 +137,8 @@ class Property {
    */
   Property &get(const std::string &key);
   const Property &get(const std::string &key) const;
+  Property &get(const PropertyPath &key);
+  const Property &get(const PropertyPath &key) const;
 
   /**
    * \brief adds new or gets existing property
@@ -132,6 +158,7 @@ class Property {
    * @return true or false
    */
   bool exists(const std::string &key) const;
+  bool exists(const PropertyPath &key) const;
 
   template <typename T>
   T ifExistsReturnElseReturnDefault(const std::string &key,
@@ -144,9 +171,13 @@ class Property {
    *
    * returns a list of properties that match the key criteria including
    * wildcard "*". Example: "base.item*.value"
+   * Components without wildcard are looked up by name instead of comparing
+   * them with every child.
    */
   std::vector<Property *> Select(const std::string &filter);
   std::vector<const Property *> Select(const std::string &filter) const;
+  std::vector<Property *> Select(const PropertyPath &filter);
+  std::vector<const Property *> Select(const PropertyPath &filter) const;
 
   /**
    * \brief reference to value of property
@@ -267,9 +298,28 @@ class Property {
 
   void LoadFromXML(std::string filename);
 
+  /**
+   * \brief read an xml file without keeping the whole tree in memory
+   * @param filename xml file
+   * @param filter path of the elements of interest, relative to the file as
+   * in Select on a Property loaded with LoadFromXML, e.g. "jobs.job"
+   * @param callback called for every matching element, in the order of the
+   * file, with the Property tree of this element
+   *
+   * Only the subtree of one matching element is kept in memory at a time,
+   * the rest of the file is skipped. Matching elements inside of a matching
+   * element are part of its subtree.
+   */
+  static void StreamFromXML(const std::string &filename,
+                            const std::string &filter,
+                            const std::function<void(Property &)> &callback);
+
   static Index getIOindex() { return IOindex; };
 
  private:
+  /// returns nullptr if the property does not exist
+  const Property *find(const PropertyPath &key) const;
+
   std::map<std::string, std::vector<Index>> map_;
   std::map<std::string, std::string> attributes_;
   std::vector<Property> properties_;
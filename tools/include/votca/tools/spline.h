@@ -112,14 +112,14 @@ class Spline {
    * created by Interpolate() or Fit() \param vector of x data values \return
    * vector of y value
    */
-  Eigen::VectorXd Calculate(const Eigen::VectorXd &x);
+  virtual Eigen::VectorXd Calculate(const Eigen::VectorXd &x);
 
   /**
    * \brief Calculate y values for given x values on the derivative of the
    * spline created by function Interpolate or Fit \param vector of x data
    * values \return vector of y value
    */
-  Eigen::VectorXd CalculateDerivative(const Eigen::VectorXd &x);
+  virtual Eigen::VectorXd CalculateDerivative(const Eigen::VectorXd &x);
 
   /**
    * \brief Print spline values (using Calculate()) on output "out" on the
@@ -130,11 +130,21 @@ class Spline {
 
   /**
    * \brief Determine the index of the interval containing value r
+   *
+   * On equally spaced grids the index is calculated directly, otherwise the
+   * grid is bisected.
    * \param value r
    * \return interval index
    */
   Index getInterval(double r);
 
+  /**
+   * \brief Determine the indices of the intervals containing the values r
+   * \param vector of values r
+   * \return vector of interval indices
+   */
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> getInterval(const Eigen::VectorXd &r);
+
   /**
    * \brief Generate the grid for fitting from "min" to "max" in steps of "h"
    * \param left interval border "min"
@@ -165,9 +175,24 @@ class Spline {
   // const Eigen::VectorXd &getSplineF2() const { return  f_; }
 
  protected:
+  /**
+   * \brief Check if the grid is equally spaced, has to be called whenever
+   * the grid points in r_ are changed
+   */
+  void UpdateGridSpacing();
+
   eBoundary boundaries_ = eBoundary::splineNormal;
   // the grid points
   Eigen::VectorXd r_;
+
+ private:
+  // grid points up to the second last one are equally spaced, the last
+  // interval may be shorter (see GenerateGrid)
+  bool uniform_grid_ = false;
+  // inverse grid spacing of the equally spaced grid
+  double inv_spacing_ = 0.0;
+  // size of the grid UpdateGridSpacing was called for
+  Index grid_size_ = 0;
 };
 
 }  // namespace tools
@@ -46,6 +46,7 @@ void AkimaSpline::Interpolate(const Eigen::VectorXd &x,
 
   // copy the grid points into f
   r_ = x;
+  UpdateGridSpacing();
 
   // initialize vectors p1,p2,p3,p4 and t
   p0 = Eigen::VectorXd::Zero(N);
@@ -171,6 +172,34 @@ double AkimaSpline::CalculateDerivative(double r) {
   return +p1(interval) + 2.0 * p2(interval) * z + 3.0 * p3(interval) * z * z;
 }
 
+Eigen::VectorXd AkimaSpline::Calculate(const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::ArrayXd z(r.size()), c0(r.size()), c1(r.size()), c2(r.size()),
+      c3(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    Index i = intervals(k);
+    z(k) = r(k) - r_[i];
+    c0(k) = p0(i);
+    c1(k) = p1(i);
+    c2(k) = p2(i);
+    c3(k) = p3(i);
+  }
+  return (c0 + c1 * z + c2 * z * z + c3 * z * z * z).matrix();
+}
+
+Eigen::VectorXd AkimaSpline::CalculateDerivative(const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::ArrayXd z(r.size()), c1(r.size()), c2(r.size()), c3(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    Index i = intervals(k);
+    z(k) = r(k) - r_[i];
+    c1(k) = p1(i);
+    c2(k) = p2(i);
+    c3(k) = p3(i);
+  }
+  return (c1 + 2.0 * c2 * z + 3.0 * c3 * z * z).matrix();
+}
+
 double AkimaSpline::getSlope(double m1, double m2, double m3, double m4) {
   if (isApproximatelyEqual(m1, m2, 1E-15) &&
       isApproximatelyEqual(m3, m4, 1E-15)) {
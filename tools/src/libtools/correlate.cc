@@ -14,31 +14,47 @@
  *
  */
 
+// Standard includes
+#include <stdexcept>
+#include <string>
+
 // Local VOTCA includes
 #include "votca/tools/correlate.h"
-#include "votca/tools/eigen.h"
 
 namespace votca {
 namespace tools {
 
 void Correlate::CalcCorrelations(DataCollection<double>::selection &data) {
-  Index N = Index(data[0].size());
-  double Nd = (double)N;
-  Eigen::Map<Eigen::ArrayXd> m0(data[0].data(), N);
-  double xm = m0.sum();
-  xm /= Nd;
-  double xsq = m0.abs2().sum();
+  Eigen::MatrixXd x = Normalize(data);
+  Eigen::VectorXd p = x.rightCols(x.cols() - 1).transpose() * x.col(0);
+  corr_.insert(corr_.end(), p.data(), p.data() + p.size());
+}
 
-  for (Index v = 1; v < data.size(); v++) {
-    Eigen::Map<Eigen::ArrayXd> m_v(data[v].data(), N);
-    double ym = m_v.sum();
-    double ysq = m_v.abs2().sum();
-    double p = (m_v * m0).sum();
-    ym /= Nd;
-    double norm = std::sqrt((xsq - Nd * xm * xm) * (ysq - Nd * ym * ym));
-    p = (p - Nd * xm * ym) / norm;
-    corr_.push_back(p);
+void Correlate::CalcCorrelationMatrix(DataCollection<double>::selection &data) {
+  Eigen::MatrixXd x = Normalize(data);
+  matrix_ = Eigen::MatrixXd::Zero(x.cols(), x.cols());
+  matrix_.selfadjointView<Eigen::Lower>().rankUpdate(x.transpose());
+  matrix_ = matrix_.selfadjointView<Eigen::Lower>();
+}
+
+Eigen::MatrixXd Correlate::Normalize(DataCollection<double>::selection &data) {
+  Index N = Index(data[0].size());
+  Index nrows = Index(data.size());
+  for (Index v = 1; v < nrows; v++) {
+    if (Index(data[v].size()) != N) {
+      throw std::runtime_error("Correlate: " + data[v].getName() + " has " +
+                               std::to_string(data[v].size()) +
+                               " values, expected " + std::to_string(N));
+    }
+  }
+  Eigen::MatrixXd x(N, nrows);
+#pragma omp parallel for schedule(static)
+  for (Index v = 0; v < nrows; v++) {
+    x.col(v) = Eigen::Map<Eigen::VectorXd>(data[v].data(), N);
+    x.col(v).array() -= x.col(v).mean();
+    x.col(v).normalize();
   }
+  return x;
 }
 
 }  // namespace tools
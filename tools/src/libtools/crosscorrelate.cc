@@ -15,24 +15,62 @@
  *
  */
 
+// Standard includes
+#include <complex>
+#include <stdexcept>
+#include <string>
+
 // Local VOTCA includes
 #include "votca/tools/crosscorrelate.h"
 
 namespace votca {
 namespace tools {
 
+namespace {
+// circular autocorrelation of the n values in x, normalized to 1 at lag 0
+void AutoCorrelation(Eigen::FFT<double>& fft, const double* x, Index n,
+                     Eigen::VectorXcd& frequency, double* corr) {
+  // real to complex transform, only half of the spectrum is needed
+  frequency.resize(n / 2 + 1);
+  fft.fwd(frequency.data(), x, n);
+  frequency = frequency.cwiseAbs2().cast<std::complex<double>>();
+  fft.inv(corr, frequency.data(), n);
+  double norm = corr[0];
+  Eigen::Map<Eigen::VectorXd>(corr, n) /= norm;
+}
+}  // namespace
+
 void CrossCorrelate::AutoCorrelate(DataCollection<double>::selection& data) {
   Index N = data[0].size();
-  Eigen::Map<Eigen::VectorXd> input(data[0].data(), N);
   Eigen::FFT<double> fft;
-  Eigen::VectorXcd frequency = fft.fwd(input);
-  Eigen::VectorXcd magnitude = frequency.cwiseAbs2();
-
+  fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+  Eigen::VectorXcd frequency;
   corrfunc_.resize(N);
-  Eigen::Map<Eigen::VectorXd> corr_map(corrfunc_.data(), N);
-  corr_map = fft.inv(magnitude);
-  double d = corr_map(0);
-  corr_map.array() /= d;
+  AutoCorrelation(fft, data[0].data(), N, frequency, corrfunc_.data());
+}
+
+void CrossCorrelate::AutoCorrelations(DataCollection<double>::selection& data) {
+  Index N = data[0].size();
+  Index nrows = data.size();
+  for (Index v = 1; v < nrows; v++) {
+    if (Index(data[v].size()) != N) {
+      throw std::runtime_error("CrossCorrelate: " + data[v].getName() +
+                               " has " + std::to_string(data[v].size()) +
+                               " values, expected " + std::to_string(N));
+    }
+  }
+  corrfuncs_.resize(N, nrows);
+#pragma omp parallel
+  {
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+    Eigen::VectorXcd frequency;
+#pragma omp for schedule(static)
+    for (Index v = 0; v < nrows; v++) {
+      AutoCorrelation(fft, data[v].data(), N, frequency,
+                      corrfuncs_.col(v).data());
+    }
+  }
 }
 
 }  // namespace tools
@@ -46,6 +46,7 @@ void CubicSpline::Interpolate(const Eigen::VectorXd &x,
 
   // copy the grid points into f
   r_ = x;
+  UpdateGridSpacing();
   f_ = y;
   Eigen::VectorXd temp = Eigen::VectorXd::Zero(N);
 
@@ -128,61 +129,103 @@ void CubicSpline::Fit(const Eigen::VectorXd &x, const Eigen::VectorXd &y) {
 
 double CubicSpline::Calculate(double r) {
   Index interval = getInterval(r);
-  return A(r) * f_[interval] + B(r) * f_[interval + 1] + C(r) * f2_[interval] +
-         D(r) * f2_[interval + 1];
+  return A(r, interval) * f_[interval] + B(r, interval) * f_[interval + 1] +
+         C(r, interval) * f2_[interval] + D(r, interval) * f2_[interval + 1];
 }
 
 double CubicSpline::CalculateDerivative(double r) {
   Index interval = getInterval(r);
-  return Aprime(r) * f_[interval] + Bprime(r) * f_[interval + 1] +
-         Cprime(r) * f2_[interval] + Dprime(r) * f2_[interval + 1];
+  return Aprime(r, interval) * f_[interval] +
+         Bprime(r, interval) * f_[interval + 1] +
+         Cprime(r, interval) * f2_[interval] +
+         Dprime(r, interval) * f2_[interval + 1];
 }
 
-double CubicSpline::A(double r) {
-  return (1.0 - (r - r_[getInterval(r)]) /
-                    (r_[getInterval(r) + 1] - r_[getInterval(r)]));
+Eigen::VectorXd CubicSpline::Calculate(const Eigen::VectorXd &r) {
+  // gather the interval data first, so the spline terms are evaluated
+  // on whole arrays
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::ArrayXd xxi(r.size()), h(r.size()), f0(r.size()), f1(r.size()),
+      f20(r.size()), f21(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    Index i = intervals(k);
+    xxi(k) = r(k) - r_[i];
+    h(k) = r_[i + 1] - r_[i];
+    f0(k) = f_[i];
+    f1(k) = f_[i + 1];
+    f20(k) = f2_[i];
+    f21(k) = f2_[i + 1];
+  }
+  Eigen::ArrayXd xxi3_h = xxi * xxi * xxi / h;
+  return ((1.0 - xxi / h) * f0 + (xxi / h) * f1 +
+          (0.5 * xxi * xxi - (1.0 / 6.0) * xxi3_h - (1.0 / 3.0) * xxi * h) *
+              f20 +
+          ((1.0 / 6.0) * xxi3_h - (1.0 / 6.0) * xxi * h) * f21)
+      .matrix();
+}
+
+Eigen::VectorXd CubicSpline::CalculateDerivative(const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::ArrayXd xxi(r.size()), h(r.size()), f0(r.size()), f1(r.size()),
+      f20(r.size()), f21(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    Index i = intervals(k);
+    xxi(k) = r(k) - r_[i];
+    h(k) = r_[i + 1] - r_[i];
+    f0(k) = f_[i];
+    f1(k) = f_[i + 1];
+    f20(k) = f2_[i];
+    f21(k) = f2_[i + 1];
+  }
+  Eigen::ArrayXd xxi2_h = xxi * xxi / h;
+  return ((-1.0 / h) * f0 + (1.0 / h) * f1 + (xxi - 0.5 * xxi2_h - h / 3) * f20 +
+          (0.5 * xxi2_h - (1.0 / 6.0) * h) * f21)
+      .matrix();
+}
+
+double CubicSpline::A(double r, Index i) {
+  return (1.0 - (r - r_[i]) / (r_[i + 1] - r_[i]));
 }
 
-double CubicSpline::Aprime(double r) {
-  return -1.0 / (r_[getInterval(r) + 1] - r_[getInterval(r)]);
+double CubicSpline::Aprime(double, Index i) {
+  return -1.0 / (r_[i + 1] - r_[i]);
 }
 
-double CubicSpline::B(double r) {
-  return (r - r_[getInterval(r)]) /
-         (r_[getInterval(r) + 1] - r_[getInterval(r)]);
+double CubicSpline::B(double r, Index i) {
+  return (r - r_[i]) / (r_[i + 1] - r_[i]);
 }
 
-double CubicSpline::Bprime(double r) {
-  return 1.0 / (r_[getInterval(r) + 1] - r_[getInterval(r)]);
+double CubicSpline::Bprime(double, Index i) {
+  return 1.0 / (r_[i + 1] - r_[i]);
 }
 
-double CubicSpline::C(double r) {
+double CubicSpline::C(double r, Index i) {
 
-  double xxi = r - r_[getInterval(r)];
-  double h = r_[getInterval(r) + 1] - r_[getInterval(r)];
+  double xxi = r - r_[i];
+  double h = r_[i + 1] - r_[i];
 
   return (0.5 * xxi * xxi - (1.0 / 6.0) * xxi * xxi * xxi / h -
           (1.0 / 3.0) * xxi * h);
 }
 
-double CubicSpline::Cprime(double r) {
-  double xxi = r - r_[getInterval(r)];
-  double h = r_[getInterval(r) + 1] - r_[getInterval(r)];
+double CubicSpline::Cprime(double r, Index i) {
+  double xxi = r - r_[i];
+  double h = r_[i + 1] - r_[i];
 
   return (xxi - 0.5 * xxi * xxi / h - h / 3);
 }
 
-double CubicSpline::D(double r) {
+double CubicSpline::D(double r, Index i) {
 
-  double xxi = r - r_[getInterval(r)];
-  double h = r_[getInterval(r) + 1] - r_[getInterval(r)];
+  double xxi = r - r_[i];
+  double h = r_[i + 1] - r_[i];
 
   return ((1.0 / 6.0) * xxi * xxi * xxi / h - (1.0 / 6.0) * xxi * h);
 }
 
-double CubicSpline::Dprime(double r) {
-  double xxi = r - r_[getInterval(r)];
-  double h = r_[getInterval(r) + 1] - r_[getInterval(r)];
+double CubicSpline::Dprime(double r, Index i) {
+  double xxi = r - r_[i];
+  double h = r_[i + 1] - r_[i];
 
   return (0.5 * xxi * xxi / h - (1.0 / 6.0) * h);
 }
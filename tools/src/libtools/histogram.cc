@@ -16,6 +16,7 @@
  */
 
 // Standard includes
+#include <cassert>
 #include <cmath>
 #include <functional>
 #include <limits>
@@ -34,7 +35,38 @@ Histogram::Histogram(const options_t& op) : options_(op) {}
 Histogram::~Histogram() = default;
 
 void Histogram::ProcessData(DataCollection<double>::selection* data) {
+  double data_min = std::numeric_limits<double>::max();
+  double data_max = std::numeric_limits<double>::min();
+  if (options_.extend_interval_ || options_.auto_interval_) {
+    for (auto& array : *data) {
+      for (auto& value : *array) {
+        data_min = std::min(value, data_min);
+        data_max = std::max(value, data_max);
+      }
+    }
+  }
+  InitializeInterval(data_min, data_max);
+
+  for (auto& array : *data) {
+    for (auto& value : *array) {
+      Add(value, 1.);
+    }
+  }
+  Finalize();
+}
 
+void Histogram::ProcessWeightedData(const std::vector<double>& values,
+                                    const std::vector<double>& weights,
+                                    double data_min, double data_max) {
+  assert(values.size() == weights.size());
+  InitializeInterval(data_min, data_max);
+  for (size_t i = 0; i < values.size(); ++i) {
+    Add(values[i], weights[i]);
+  }
+  Finalize();
+}
+
+void Histogram::InitializeInterval(double data_min, double data_max) {
   pdf_.assign(options_.n_, 0);
 
   if (options_.auto_interval_) {
@@ -45,38 +77,33 @@ void Histogram::ProcessData(DataCollection<double>::selection* data) {
     min_ = options_.min_;
     max_ = options_.max_;
   }
-  for (auto& array : *data) {
-    if (options_.extend_interval_ || options_.auto_interval_) {
-      for (auto& value : *array) {
-        min_ = std::min(value, min_);
-        max_ = std::max(value, max_);
-      }
-    }
+  if (options_.extend_interval_) {
+    min_ = std::min(data_min, min_);
+    max_ = std::max(data_max, max_);
   }
 
   interval_ = (max_ - min_) / (double)(options_.n_ - 1);
+}
 
-  double v = 1.;
-  for (auto& array : *data) {
-    for (auto& value : *array) {
-      Index ii = (Index)floor((value - min_) / interval_ +
-                              0.5);  // the interval should
-                                     // be centered around
-                                     // the sampling point
-      if (ii < 0 || ii >= options_.n_) {
-        if (options_.periodic_) {
-          while (ii < 0) {
-            ii += options_.n_;
-          }
-          ii = ii % options_.n_;
-        } else {
-          continue;
-        }
+void Histogram::Add(double value, double weight) {
+  Index ii = (Index)floor((value - min_) / interval_ +
+                          0.5);  // the interval should
+                                 // be centered around
+                                 // the sampling point
+  if (ii < 0 || ii >= options_.n_) {
+    if (options_.periodic_) {
+      while (ii < 0) {
+        ii += options_.n_;
       }
-      pdf_[ii] += v;
+      ii = ii % options_.n_;
+    } else {
+      return;
     }
   }
+  pdf_[ii] += weight;
+}
 
+void Histogram::Finalize() {
   if (options_.scale_ == "bond") {
     for (size_t i = 0; i < pdf_.size(); ++i) {
       double r = min_ + interval_ * (double)i;
@@ -17,6 +17,7 @@
 
 // Standard includes
 #include <algorithm>
+#include <cmath>
 
 // Local VOTCA includes
 #include "votca/tools/histogramnew.h"
@@ -25,6 +26,13 @@ using namespace std;
 namespace votca {
 namespace tools {
 
+namespace {
+// values are converted to bin positions in blocks of this size
+constexpr Index block_size = 1024;
+// below this number of values threads do not pay off
+constexpr Index parallel_threshold = 100000;
+}  // namespace
+
 void HistogramNew::Initialize_() {
   if (periodic_) {
     step_ = (max_ - min_) / double(nbins_);
@@ -57,11 +65,7 @@ void HistogramNew::Process(const double &v, double scale) {
   Index i = (Index)floor((v - min_) / step_ + 0.5);
   if (i < 0 || i >= nbins_) {
     if (periodic_) {
-      if (i < 0) {
-        i = nbins_ - ((-i) % nbins_);
-      } else {
-        i = i % nbins_;
-      }
+      i = ((i % nbins_) + nbins_) % nbins_;
     } else {
       return;
     }
@@ -69,6 +73,94 @@ void HistogramNew::Process(const double &v, double scale) {
   data_.y(i) += scale;
 }
 
+void HistogramNew::ProcessRange(const double *values, Index n,
+                                const double *weights, Assignment assignment) {
+  if (n <= 0) {
+    return;
+  }
+  Eigen::VectorXd &y = data_.y();
+  Index nblocks = (n + block_size - 1) / block_size;
+  if (!parallel_ || n <= parallel_threshold) {
+    Eigen::ArrayXd pos(std::min(block_size, n));
+    for (Index block = 0; block < nblocks; ++block) {
+      Index start = block * block_size;
+      Index size = std::min(block_size, n - start);
+      ProcessBlock_(values + start, weights ? weights + start : nullptr, size,
+                    assignment, pos, y);
+    }
+    return;
+  }
+  // every thread fills its own copy, so no bin is written concurrently
+#pragma omp parallel
+  {
+    Eigen::VectorXd local = Eigen::VectorXd::Zero(nbins_);
+    Eigen::ArrayXd pos(block_size);
+#pragma omp for schedule(static)
+    for (Index block = 0; block < nblocks; ++block) {
+      Index start = block * block_size;
+      Index size = std::min(block_size, n - start);
+      ProcessBlock_(values + start, weights ? weights + start : nullptr, size,
+                    assignment, pos, local);
+    }
+#pragma omp critical
+    y += local;
+  }
+}
+
+void HistogramNew::ProcessBlock_(const double *values, const double *weights,
+                                 Index n, Assignment assignment,
+                                 Eigen::ArrayXd &pos,
+                                 Eigen::VectorXd &y) const {
+  // position in units of bins, the bin centers are at integer positions
+  auto pos_n = pos.head(n);
+  pos_n = (Eigen::Map<const Eigen::ArrayXd>(values, n) - min_) / step_;
+  double nbins = double(nbins_);
+
+  // the comparisons are written such that NaN fails them, the bins are only
+  // converted to integers if they are inside of the histogram
+  if (assignment == Assignment::nearest) {
+    pos_n = (pos_n + 0.5).floor();
+    if (periodic_) {
+      pos_n -= nbins * (pos_n / nbins).floor();
+    }
+    for (Index k = 0; k < n; ++k) {
+      double bin = pos_n[k];
+      if (bin >= 0.0 && bin < nbins) {
+        y[Index(bin)] += weights ? weights[k] : 1.0;
+      }
+    }
+    return;
+  }
+
+  if (periodic_) {
+    pos_n -= nbins * (pos_n / nbins).floor();
+  }
+  for (Index k = 0; k < n; ++k) {
+    double lower = std::floor(pos_n[k]);
+    double fraction = pos_n[k] - lower;
+    // the wrapped position can be rounded up to nbins
+    if (periodic_ && lower == nbins) {
+      lower = 0.0;
+    }
+    if (!(lower >= -1.0 && lower < nbins)) {
+      continue;
+    }
+    double weight = weights ? weights[k] : 1.0;
+    double upper_part = fraction * weight;
+    Index bin = Index(lower);
+    Index next = bin + 1;
+    if (periodic_ && next == nbins_) {
+      next = 0;
+    }
+    if (bin >= 0) {
+      y[bin] += weight - upper_part;
+    }
+    if (next < nbins_) {
+      y[next] += upper_part;
+    }
+  }
+}
+
 double HistogramNew::getMinBinVal() const { return data_.getMinY(); }
 
 double HistogramNew::getMaxBinVal() const { return data_.getMaxY(); }
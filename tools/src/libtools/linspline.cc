@@ -37,6 +37,25 @@ double LinSpline::CalculateDerivative(double r) {
   return a(interval);
 }
 
+Eigen::VectorXd LinSpline::Calculate(const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::ArrayXd ai(r.size()), bi(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    ai(k) = a(intervals(k));
+    bi(k) = b(intervals(k));
+  }
+  return (ai * r.array() + bi).matrix();
+}
+
+Eigen::VectorXd LinSpline::CalculateDerivative(const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals = getInterval(r);
+  Eigen::VectorXd ai(r.size());
+  for (Index k = 0; k < r.size(); ++k) {
+    ai(k) = a(intervals(k));
+  }
+  return ai;
+}
+
 void LinSpline::Interpolate(const Eigen::VectorXd &x,
                             const Eigen::VectorXd &y) {
   if (x.size() != y.size()) {
@@ -58,6 +77,7 @@ void LinSpline::Interpolate(const Eigen::VectorXd &x,
 
   // copy the grid points into f
   r_ = x;
+  UpdateGridSpacing();
 
   // LINEAR SPLINE: a(i) * x + b(i)
   // where i=number of interval
@@ -22,9 +22,12 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_set>
 
 // Third party includes
 #include <boost/algorithm/string.hpp>
@@ -45,41 +48,43 @@ using namespace std;
 // ostream modifier defines the output format, level, indentation
 const Index Property::IOindex = std::ios_base::xalloc();
 
-const Property &Property::get(const string &key) const {
-  Tokenizer tok(key, ".");
-  Tokenizer::iterator n = tok.begin();
-  if (n == tok.end()) {
-    return *this;
+PropertyPath::PropertyPath(const std::string &key) : key_(key) {
+  components_ = Tokenizer(key, ".").ToVector();
+  for (const std::string &component : components_) {
+    wildcard_.push_back(component.find_first_of("*?") != std::string::npos);
   }
+}
 
-  const Property *p;
-  map<string, std::vector<Index>>::const_iterator iter;
-  if (*n == "") {
-    p = this;
-  } else {
-    iter = map_.find(*n);
-    if (iter == map_.end()) {
-      throw std::runtime_error("property not found: " + key);
-    }
-    p = &properties_[iter->second.back()];
-  }
-  ++n;
-  try {
-    for (; n != tok.end(); ++n) {
-      p = &p->get(*n);
+const Property *Property::find(const PropertyPath &key) const {
+  const Property *p = this;
+  for (const std::string &component : key.components()) {
+    auto iter = p->map_.find(component);
+    if (iter == p->map_.end()) {
+      return nullptr;
     }
-  } catch (std::runtime_error &) {  // catch here to get full key in
-                                    // exception
-    throw std::runtime_error("property not found: " + key);
+    p = &p->properties_[iter->second.back()];
   }
+  return p;
+}
 
+const Property &Property::get(const PropertyPath &key) const {
+  const Property *p = find(key);
+  if (p == nullptr) {
+    throw std::runtime_error("property not found: " + key.key());
+  }
   return *p;
 }
 
-Property &Property::get(const string &key) {
+Property &Property::get(const PropertyPath &key) {
   return const_cast<Property &>(static_cast<const Property &>(*this).get(key));
 }
 
+const Property &Property::get(const string &key) const {
+  return get(PropertyPath(key));
+}
+
+Property &Property::get(const string &key) { return get(PropertyPath(key)); }
+
 Property &Property::set(const std::string &key, const std::string &value) {
   Property &p = get(key);
   p.value() = value;
@@ -120,12 +125,11 @@ bool Property::hasAttribute(const std::string &attribute) const {
 }
 
 bool Property::exists(const std::string &key) const {
-  try {
-    get(key);
-  } catch (std::exception &) {
-    return false;
-  }
-  return true;
+  return exists(PropertyPath(key));
+}
+
+bool Property::exists(const PropertyPath &key) const {
+  return find(key) != nullptr;
 }
 
 void FixPath(tools::Property &prop, std::string path) {
@@ -161,46 +165,54 @@ Property &Property::getOradd(const std::string &key) {
   }
 }
 
-std::vector<const Property *> Property::Select(const string &filter) const {
-  Tokenizer tok(filter, ".");
+std::vector<const Property *> Property::Select(
+    const PropertyPath &filter) const {
   std::vector<const Property *> selection;
-  if (tok.begin() == tok.end()) {
+  if (filter.components().empty()) {
     return selection;
   }
   selection.push_back(this);
-  for (const auto &n : tok) {
+  for (Index i = 0; i < Index(filter.components().size()); ++i) {
+    const std::string &name = filter.components()[i];
     std::vector<const Property *> selected;
     for (const Property *p : selection) {
+      if (!filter.isWildcard(i)) {
+        auto iter = p->map_.find(name);
+        if (iter != p->map_.end()) {
+          for (Index index : iter->second) {
+            selected.push_back(&p->properties_[index]);
+          }
+        }
+        continue;
+      }
       for (const Property &child : *p) {
-        if (wildcmp(n, child.name())) {
+        if (wildcmp(name, child.name())) {
           selected.push_back(&child);
         }
       }
     }
-    selection = selected;
+    selection = std::move(selected);
   }
   return selection;
 }
 
-std::vector<Property *> Property::Select(const string &filter) {
-  Tokenizer tok(filter, ".");
-  std::vector<Property *> selection;
-  if (tok.begin() == tok.end()) {
-    return selection;
-  }
-  selection.push_back(this);
-  for (const auto &n : tok) {
-    std::vector<Property *> selected;
-    for (Property *p : selection) {
-      for (Property &child : *p) {
-        if (wildcmp(n, child.name())) {
-          selected.push_back(&child);
-        }
-      }
-    }
-    selection = selected;
+std::vector<Property *> Property::Select(const PropertyPath &filter) {
+  std::vector<const Property *> selection =
+      static_cast<const Property &>(*this).Select(filter);
+  std::vector<Property *> result;
+  result.reserve(selection.size());
+  for (const Property *p : selection) {
+    result.push_back(const_cast<Property *>(p));
   }
-  return selection;
+  return result;
+}
+
+std::vector<const Property *> Property::Select(const string &filter) const {
+  return Select(PropertyPath(filter));
+}
+
+std::vector<Property *> Property::Select(const string &filter) {
+  return Select(PropertyPath(filter));
 }
 
 void Property::deleteAttribute(const std::string &attribute) {
@@ -273,6 +285,136 @@ void Property::LoadFromXML(string filename) {
   XML_ParserFree(parser);
 }
 
+namespace {
+// state of StreamFromXML, which is passed to the expat handlers
+struct XMLStream {
+  explicit XMLStream(const std::string &key) : filter(key) {}
+  XML_Parser parser = nullptr;
+  PropertyPath filter;
+  const std::function<void(Property &)> *callback = nullptr;
+  // tag names outside of matching elements are interned, the path only
+  // references them
+  std::unordered_set<std::string> names;
+  std::vector<const std::string *> path;
+  // tree of the current matching element and its open elements
+  std::unique_ptr<Property> current;
+  std::vector<Property *> open;
+  // exceptions must not pass through expat
+  std::exception_ptr error;
+};
+
+bool MatchesFilter(const XMLStream &s) {
+  const std::vector<std::string> &components = s.filter.components();
+  if (components.size() != s.path.size()) {
+    return false;
+  }
+  for (Index i = 0; i < Index(components.size()); ++i) {
+    if (s.filter.isWildcard(i) ? !wildcmp(components[i], *s.path[i])
+                               : components[i] != *s.path[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void stream_start_hndl(void *data, const char *el, const char **attr) {
+  XMLStream *s = static_cast<XMLStream *>(data);
+  try {
+    Property *np;
+    if (s->current) {
+      np = &s->open.back()->add(el, "");
+    } else {
+      s->path.push_back(&*s->names.insert(el).first);
+      if (!MatchesFilter(*s)) {
+        return;
+      }
+      // same path as if the file was loaded with LoadFromXML
+      std::string path;
+      for (Index i = 0; i + 1 < Index(s->path.size()); ++i) {
+        path += (i == 0) ? *s->path[i] : "." + *s->path[i];
+      }
+      s->current = std::make_unique<Property>(el, "", path);
+      np = s->current.get();
+    }
+    for (Index i = 0; attr[i]; i += 2) {
+      np->setAttribute(attr[i], attr[i + 1]);
+    }
+    s->open.push_back(np);
+  } catch (...) {
+    s->error = std::current_exception();
+    XML_StopParser(s->parser, XML_FALSE);
+  }
+}
+
+void stream_end_hndl(void *data, const char *) {
+  XMLStream *s = static_cast<XMLStream *>(data);
+  if (s->current) {
+    s->open.pop_back();
+    if (!s->open.empty()) {
+      return;
+    }
+    try {
+      (*s->callback)(*s->current);
+    } catch (...) {
+      s->error = std::current_exception();
+      XML_StopParser(s->parser, XML_FALSE);
+    }
+    s->current.reset();
+  }
+  s->path.pop_back();
+}
+
+void stream_char_hndl(void *data, const char *txt, int txtlen) {
+  XMLStream *s = static_cast<XMLStream *>(data);
+  if (s->current) {
+    s->open.back()->value().append(txt, txtlen);
+  }
+}
+}  // namespace
+
+void Property::StreamFromXML(const std::string &filename,
+                             const std::string &filter,
+                             const std::function<void(Property &)> &callback) {
+  ifstream fl(filename, std::ios::binary);
+  if (!fl.is_open()) {
+    throw std::ios_base::failure("Error on open xml file: " + filename);
+  }
+
+  std::unique_ptr<std::remove_pointer_t<XML_Parser>, void (*)(XML_Parser)>
+      parser(XML_ParserCreate(nullptr), XML_ParserFree);
+  if (!parser) {
+    throw std::runtime_error("Couldn't allocate memory for xml parser");
+  }
+
+  XMLStream state(filter);
+  state.parser = parser.get();
+  state.callback = &callback;
+  XML_SetUserData(parser.get(), &state);
+  XML_SetElementHandler(parser.get(), stream_start_hndl, stream_end_hndl);
+  XML_SetCharacterDataHandler(parser.get(), stream_char_hndl);
+
+  std::vector<char> buffer(1 << 16);
+  bool done = false;
+  while (!done) {
+    fl.read(buffer.data(), std::streamsize(buffer.size()));
+    if (fl.bad()) {
+      throw std::ios_base::failure("Error on reading xml file: " + filename);
+    }
+    done = fl.eof();
+    if (XML_Parse(parser.get(), buffer.data(), int(fl.gcount()), done) ==
+        XML_STATUS_ERROR) {
+      if (state.error) {
+        std::rethrow_exception(state.error);
+      }
+      throw std::ios_base::failure(
+          filename + ": Parse error at line " +
+          boost::lexical_cast<string>(
+              XML_GetCurrentLineNumber(parser.get())) +
+          "\n" + XML_ErrorString(XML_GetErrorCode(parser.get())));
+    }
+  }
+}
+
 void PrintNodeTXT(std::ostream &out, const Property &p, const Index start_level,
                   Index level = 0, string prefix = "", string offset = "") {
   if ((p.value() != "") || p.HasChildren()) {
@@ -15,6 +15,10 @@
  *
  */
 
+// Standard includes
+#include <algorithm>
+#include <cmath>
+
 // Local VOTCA includes
 #include "votca/tools/spline.h"
 
@@ -34,9 +38,30 @@ Index Spline::GenerateGrid(double min, double max, double h) {
     r_[i++] = r_init;
   }
   r_[i] = max;
+  UpdateGridSpacing();
   return r_.size();
 }
 
+void Spline::UpdateGridSpacing() {
+  grid_size_ = r_.size();
+  uniform_grid_ = false;
+  if (r_.size() < 2) {
+    return;
+  }
+  double h = r_[1] - r_[0];
+  if (!(h > 0.0)) {
+    return;
+  }
+  // the last grid point only limits the last interval, so it is not checked
+  for (Index i = 2; i < r_.size() - 1; ++i) {
+    if (std::abs(r_[i] - r_[0] - double(i) * h) > 1e-6 * h) {
+      return;
+    }
+  }
+  inv_spacing_ = 1.0 / h;
+  uniform_grid_ = true;
+}
+
 Eigen::VectorXd Spline::Calculate(const Eigen::VectorXd &x) {
   Eigen::VectorXd y(x.size());
   for (Index i = 0; i < x.size(); ++i) {
@@ -60,19 +85,37 @@ void Spline::Print(std::ostream &out, double interval) {
 }
 
 Index Spline::getInterval(double r) {
-  if (r < r_[0]) {
+  // also catches NaN, which must not reach the index computation below
+  if (!(r >= r_[0])) {
     return 0;
   }
-  if (r > r_[r_.size() - 2]) {
-    return r_.size() - 2;
+  const Index last = r_.size() - 2;
+  if (r > r_[last]) {
+    return last;
   }
-  Index i;
-  for (i = 0; i < r_.size(); ++i) {
-    if (r_[i] > r) {
-      break;
+  if (uniform_grid_ && grid_size_ == r_.size()) {
+    Index i = std::min(Index((r - r_[0]) * inv_spacing_), last);
+    // the grid points are only equally spaced within rounding errors
+    while (i > 0 && r_[i] > r) {
+      --i;
+    }
+    while (i < last && r_[i + 1] <= r) {
+      ++i;
     }
+    return i;
+  }
+  // index of the first grid point larger than r
+  const double *upper = std::upper_bound(r_.data(), r_.data() + r_.size(), r);
+  return Index(upper - r_.data()) - 1;
+}
+
+Eigen::Matrix<Index, Eigen::Dynamic, 1> Spline::getInterval(
+    const Eigen::VectorXd &r) {
+  Eigen::Matrix<Index, Eigen::Dynamic, 1> intervals(r.size());
+  for (Index i = 0; i < r.size(); ++i) {
+    intervals(i) = getInterval(r(i));
   }
-  return i - 1;
+  return intervals;
 }
 
 double Spline::getGridPoint(int i) {
@@ -23,6 +23,7 @@
 #include <cmath>
 #include <exception>
 #include <iostream>
+#include <string>
 
 // Third party includes
 #include <boost/test/unit_test.hpp>
@@ -60,4 +61,40 @@ BOOST_AUTO_TEST_CASE(correlation_test) {
   BOOST_CHECK_CLOSE(cor.getData()[1], -1, 1e-9);
 }
 
+BOOST_AUTO_TEST_CASE(correlation_matrix_test) {
+
+  DataCollection<double> d;
+  std::vector<DataCollection<double>::array*> rows;
+  for (Index r = 0; r < 4; r++) {
+    rows.push_back(d.CreateArray("row" + std::to_string(r)));
+    rows.back()->resize(40);
+    for (Index i = 0; i < 40; i++) {
+      (*rows.back())[i] = std::sin(double(i) * 0.3 * double(r + 1)) +
+                          0.1 * double(r) * double(i);
+    }
+  }
+  DataCollection<double>::selection s;
+  for (auto* row : rows) {
+    s.push_back(row);
+  }
+
+  Correlate cor;
+  cor.CalcCorrelations(s);
+  cor.CalcCorrelationMatrix(s);
+  const Eigen::MatrixXd& m = cor.getCorrelationMatrix();
+  BOOST_REQUIRE_EQUAL(m.rows(), 4);
+  BOOST_REQUIRE_EQUAL(m.cols(), 4);
+  BOOST_CHECK(m.isApprox(m.transpose(), 1e-12));
+  for (Index r = 0; r < 4; r++) {
+    BOOST_CHECK_CLOSE(m(r, r), 1, 1e-9);
+  }
+  for (Index r = 1; r < 4; r++) {
+    BOOST_CHECK_CLOSE(m(0, r), cor.getData()[r - 1], 1e-9);
+  }
+
+  // the rows have to have the same length
+  rows.back()->pop_back();
+  BOOST_CHECK_THROW(cor.CalcCorrelationMatrix(s), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
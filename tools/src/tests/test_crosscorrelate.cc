@@ -23,6 +23,7 @@
 #include <cmath>
 #include <exception>
 #include <iostream>
+#include <string>
 
 // Third party includes
 #include <boost/test/unit_test.hpp>
@@ -71,4 +72,45 @@ BOOST_AUTO_TEST_CASE(crosscorrelate) {
   BOOST_CHECK_EQUAL(equal_val, true);
 }
 
+BOOST_AUTO_TEST_CASE(autocorrelations) {
+
+  DataCollection<double> d;
+  DataCollection<double>::selection s;
+  for (Index r = 0; r < 3; r++) {
+    DataCollection<double>::array* x = d.CreateArray("row" + std::to_string(r));
+    x->resize(37);
+    for (Index i = 0; i < Index(x->size()); i++) {
+      (*x)[i] = std::sin(double(i) * 0.5 * double(r + 1)) + 0.1 * double(i);
+    }
+    s.push_back(x);
+  }
+
+  CrossCorrelate cor;
+  cor.AutoCorrelations(s);
+  const Eigen::MatrixXd& all = cor.getAutocorrelations();
+  BOOST_REQUIRE_EQUAL(all.rows(), 37);
+  BOOST_REQUIRE_EQUAL(all.cols(), 3);
+
+  for (Index r = 0; r < 3; r++) {
+    // reference: direct circular autocorrelation
+    Eigen::Map<Eigen::VectorXd> x(s[r].data(), 37);
+    Eigen::VectorXd ref(37);
+    for (Index lag = 0; lag < 37; lag++) {
+      double sum = 0;
+      for (Index i = 0; i < 37; i++) {
+        sum += x(i) * x((i + lag) % 37);
+      }
+      ref(lag) = sum;
+    }
+    ref /= ref(0);
+    BOOST_CHECK(all.col(r).isApprox(ref, 1e-10));
+
+    DataCollection<double>::selection single;
+    single.push_back(&s[r]);
+    cor.AutoCorrelate(single);
+    Eigen::Map<const Eigen::VectorXd> m(cor.getData().data(), 37);
+    BOOST_CHECK(m.isApprox(ref, 1e-10));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
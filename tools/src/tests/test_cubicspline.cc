@@ -1,5 +1,5 @@
 /*
- * Copyright 2009-2020 The VOTCA Development Team (http://www.votca.org)
+ * Copyright 2009-2023 The VOTCA Development Team (http://www.votca.org)
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -21,6 +21,8 @@
 
 // Standard includes
 #include <iostream>
+#include <limits>
+#include <vector>
 
 // Third party includes
 #include <boost/test/unit_test.hpp>
@@ -30,6 +32,18 @@
 
 using namespace votca::tools;
 
+namespace {
+// reference: index of the last grid point not larger than r, clamped to the
+// first and the last interval
+votca::Index ScanInterval(const Eigen::VectorXd &grid, double r) {
+  votca::Index i = 0;
+  while (i < grid.size() - 2 && grid[i + 1] <= r) {
+    ++i;
+  }
+  return i;
+}
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(cubicspline_test)
 
 BOOST_AUTO_TEST_CASE(spline_grid_high) {
@@ -189,4 +203,56 @@ BOOST_AUTO_TEST_CASE(cubicspline_matrix_test) {
   BOOST_CHECK_EQUAL(equalMatrix, true);
 }
 
+BOOST_AUTO_TEST_CASE(cubicspline_interval_test) {
+  CubicSpline uniform;
+  uniform.GenerateGrid(0.24, 0.5, 0.02);
+
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(12);
+  Eigen::VectorXd y = Eigen::VectorXd::Zero(12);
+  for (votca::Index i = 0; i < x.size(); ++i) {
+    x(i) = 0.1 * double(i * i);
+    y(i) = std::sin(x(i));
+  }
+  CubicSpline nonuniform;
+  nonuniform.Interpolate(x, y);
+
+  // the last interval of a generated grid can be shorter
+  CubicSpline shortlast;
+  shortlast.GenerateGrid(0, 9, 2);
+
+  for (CubicSpline *spline : {&uniform, &nonuniform, &shortlast}) {
+    const Eigen::VectorXd &grid = spline->getX();
+    double min = grid[0];
+    double max = grid[grid.size() - 1];
+    std::vector<double> rs;
+    for (votca::Index i = 0; i < grid.size(); ++i) {
+      rs.push_back(grid[i]);
+    }
+    for (votca::Index i = -10; i <= 1010; ++i) {
+      rs.push_back(min + (max - min) * double(i) / 1000.0);
+    }
+    for (double r : rs) {
+      BOOST_CHECK_EQUAL(spline->getInterval(r), ScanInterval(grid, r));
+    }
+    // non-finite values end up in the outer intervals
+    BOOST_CHECK_EQUAL(
+        spline->getInterval(std::numeric_limits<double>::quiet_NaN()), 0);
+    BOOST_CHECK_EQUAL(
+        spline->getInterval(-std::numeric_limits<double>::infinity()), 0);
+    BOOST_CHECK_EQUAL(
+        spline->getInterval(std::numeric_limits<double>::infinity()),
+        grid.size() - 2);
+  }
+
+  // the batched evaluation agrees with the evaluation point by point
+  Eigen::VectorXd rs = Eigen::VectorXd::LinSpaced(200, -0.5, 13.0);
+  Eigen::VectorXd values = nonuniform.Calculate(rs);
+  Eigen::VectorXd derivatives = nonuniform.CalculateDerivative(rs);
+  for (votca::Index i = 0; i < rs.size(); ++i) {
+    BOOST_CHECK_SMALL(values(i) - nonuniform.Calculate(rs(i)), 1e-9);
+    BOOST_CHECK_SMALL(
+        derivatives(i) - nonuniform.CalculateDerivative(rs(i)), 1e-9);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
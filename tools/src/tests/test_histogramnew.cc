@@ -19,8 +19,10 @@
 #define BOOST_TEST_MODULE histogramnew_test
 
 // Standard includes
+#include <cmath>
 #include <exception>
 #include <iostream>
+#include <limits>
 
 // Third party includes
 #include <boost/test/unit_test.hpp>
@@ -114,4 +116,88 @@ BOOST_AUTO_TEST_CASE(minmax_test) {
   BOOST_CHECK_EQUAL(static_cast<votca::Index>(hn.getMaxBinVal()), 2);
 }
 
+BOOST_AUTO_TEST_CASE(processrange_pointer_test) {
+  for (bool periodic : {false, true}) {
+    HistogramNew range;
+    HistogramNew single;
+    range.setPeriodic(periodic);
+    single.setPeriodic(periodic);
+    range.Initialize(0.0, 10.0, 11);
+    single.Initialize(0.0, 10.0, 11);
+
+    // more values than needed for the threads, some outside of the interval
+    votca::Index n = 250000;
+    vector<double> values(n);
+    vector<double> weights(n);
+    for (votca::Index k = 0; k < n; ++k) {
+      values[k] = -2.0 + 14.0 * std::fmod(double(k) * 0.6180339887, 1.0);
+      weights[k] = 0.5 * double(k % 3);
+      single.Process(values[k], weights[k]);
+    }
+    range.ProcessRange(values.data(), n, weights.data());
+    for (votca::Index i = 0; i < range.getNBins(); ++i) {
+      BOOST_CHECK_EQUAL(range.data().y(i), single.data().y(i));
+    }
+
+    range.Clear();
+    single.Clear();
+    range.setParallel(false);
+    range.ProcessRange(values.data(), 1000);
+    single.ProcessRange(values.begin(), values.begin() + 1000);
+    for (votca::Index i = 0; i < range.getNBins(); ++i) {
+      BOOST_CHECK_EQUAL(range.data().y(i), single.data().y(i));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(processrange_linear_test) {
+  HistogramNew hn;
+  hn.Initialize(0.0, 4.0, 5);
+  vector<double> values = {1.25, 3.5, 4.5, -0.25, 7.0};
+  vector<double> weights = {1.0, 2.0, 1.0, 1.0, 1.0};
+  hn.ProcessRange(values.data(), votca::Index(values.size()), weights.data(),
+                  HistogramNew::Assignment::linear);
+  BOOST_CHECK_CLOSE(hn.data().y(0), 0.75, 1e-10);
+  BOOST_CHECK_CLOSE(hn.data().y(1), 0.75, 1e-10);
+  BOOST_CHECK_CLOSE(hn.data().y(2), 0.25, 1e-10);
+  BOOST_CHECK_CLOSE(hn.data().y(3), 1.0, 1e-10);
+  BOOST_CHECK_CLOSE(hn.data().y(4), 1.5, 1e-10);
+
+  HistogramNew periodic;
+  periodic.setPeriodic(true);
+  periodic.Initialize(0.0, 4.0, 4);
+  values = {3.75, -0.25, 4.5, -1e-17};
+  periodic.ProcessRange(values.data(), votca::Index(values.size()), nullptr,
+                        HistogramNew::Assignment::linear);
+  BOOST_CHECK_CLOSE(periodic.data().y(0), 0.75 + 0.75 + 0.5 + 1.0, 1e-10);
+  BOOST_CHECK_CLOSE(periodic.data().y(3), 0.25 + 0.25, 1e-10);
+  BOOST_CHECK_CLOSE(periodic.data().y(1), 0.5, 1e-10);
+  BOOST_CHECK_CLOSE(periodic.data().y().sum(), 4.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(processrange_nonfinite_test) {
+  HistogramNew hn;
+  hn.setPeriodic(true);
+  hn.Initialize(0.0, 4.0, 4);
+  vector<double> values = {std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::infinity(), 1.0};
+  hn.ProcessRange(values.data(), votca::Index(values.size()));
+  hn.ProcessRange(values.data(), votca::Index(values.size()), nullptr,
+                  HistogramNew::Assignment::linear);
+  BOOST_CHECK_EQUAL(hn.data().y().sum(), 2.0);
+  BOOST_CHECK_EQUAL(hn.data().y(1), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(periodic_wrap_test) {
+  HistogramNew hn;
+  hn.setPeriodic(true);
+  hn.Initialize(0.0, 4.0, 4);
+  hn.Process(-4.0);
+  hn.Process(-1.0);
+  hn.Process(9.0);
+  BOOST_CHECK_EQUAL(hn.data().y(0), 1.0);
+  BOOST_CHECK_EQUAL(hn.data().y(3), 1.0);
+  BOOST_CHECK_EQUAL(hn.data().y(1), 1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
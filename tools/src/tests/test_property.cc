@@ -123,6 +123,97 @@ BOOST_AUTO_TEST_CASE(select) {
   BOOST_CHECK_EQUAL(s8.size(), 4);
 }
 
+BOOST_AUTO_TEST_CASE(propertypath) {
+  Property prop;
+  Property& b = prop.add("A", "").add("B", "");
+  b.add("Ca", "1");
+  b.add("Cb", "2");
+  b.add("Ca", "3");
+
+  PropertyPath path("A.B.Ca");
+  BOOST_CHECK_EQUAL(path.key(), "A.B.Ca");
+  BOOST_CHECK_EQUAL(path.components().size(), 3);
+  BOOST_CHECK(!path.isWildcard(2));
+  // the last added property is returned
+  BOOST_CHECK_EQUAL(prop.get(path).as<votca::Index>(), 3);
+  BOOST_CHECK(prop.exists(path));
+  BOOST_CHECK(!prop.exists(PropertyPath("A.C")));
+  BOOST_CHECK_THROW(prop.get(PropertyPath("A.B.D")), std::runtime_error);
+
+  // selections keep the order of the children
+  std::vector<Property*> s1 = prop.Select(path);
+  BOOST_REQUIRE_EQUAL(s1.size(), 2);
+  BOOST_CHECK_EQUAL(s1[0]->value(), "1");
+  BOOST_CHECK_EQUAL(s1[1]->value(), "3");
+
+  PropertyPath wildcard("A.?.C*");
+  BOOST_CHECK(wildcard.isWildcard(1));
+  std::vector<const Property*> s2 =
+      static_cast<const Property&>(prop).Select(wildcard);
+  BOOST_REQUIRE_EQUAL(s2.size(), 3);
+  BOOST_CHECK_EQUAL(s2[1]->value(), "2");
+}
+
+BOOST_AUTO_TEST_CASE(streamfromxml) {
+  std::ofstream xmlfile("test_stream.xml");
+  xmlfile << "<jobs>" << std::endl;
+  for (votca::Index i = 0; i < 3; i++) {
+    xmlfile << "  <job id=\"" << i << "\">" << std::endl;
+    xmlfile << "    <tag>job" << i << "</tag>" << std::endl;
+    xmlfile << "    <input><job>nested</job></input>" << std::endl;
+    xmlfile << "  </job>" << std::endl;
+    xmlfile << "  <other><job>skipped</job></other>" << std::endl;
+  }
+  xmlfile << "</jobs>" << std::endl;
+  xmlfile.close();
+
+  Property loaded;
+  loaded.LoadFromXML("test_stream.xml");
+  std::vector<Property*> reference = loaded.Select("jobs.job");
+
+  votca::Index count = 0;
+  Property::StreamFromXML(
+      "test_stream.xml", "jobs.job", [&](Property& job) {
+        BOOST_REQUIRE_LT(count, reference.size());
+        const Property& ref = *reference[count];
+        BOOST_CHECK_EQUAL(job.name(), ref.name());
+        BOOST_CHECK_EQUAL(job.path(), ref.path());
+        BOOST_CHECK_EQUAL(job.getAttribute<votca::Index>("id"), count);
+        BOOST_CHECK_EQUAL(job.get("tag").as<std::string>(),
+                          ref.get("tag").as<std::string>());
+        BOOST_CHECK_EQUAL(job.get("input.job").path(),
+                          ref.get("input.job").path());
+        BOOST_CHECK_EQUAL(job.get("input.job").value(), "nested");
+        count++;
+      });
+  BOOST_CHECK_EQUAL(count, 3);
+
+  count = 0;
+  Property::StreamFromXML("test_stream.xml", "jobs.*.job",
+                          [&](Property& job) {
+                            BOOST_CHECK_EQUAL(job.value(), "skipped");
+                            count++;
+                          });
+  BOOST_CHECK_EQUAL(count, 3);
+
+  // exceptions of the callback stop the reading
+  count = 0;
+  BOOST_CHECK_THROW(Property::StreamFromXML("test_stream.xml", "jobs.job",
+                                            [&](Property&) {
+                                              count++;
+                                              throw std::runtime_error("stop");
+                                            }),
+                    std::runtime_error);
+  BOOST_CHECK_EQUAL(count, 1);
+
+  std::ofstream broken("test_stream_broken.xml");
+  broken << "<jobs><job></jobs>" << std::endl;
+  broken.close();
+  BOOST_CHECK_THROW(Property::StreamFromXML("test_stream_broken.xml",
+                                            "jobs.job", [](Property&) {}),
+                    std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_CASE(printtostream) {
 
   Property prop;
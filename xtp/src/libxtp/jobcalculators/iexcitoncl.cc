@@ -223,18 +223,16 @@ void IEXCITON::ReadJobFile(Topology& top) {
 
   Logger log;
   log.setReportLevel(Log::current_level);
-  Property xml;
-  xml.LoadFromXML(jobfile_);
-  std::vector<Property*> jobProps = xml.Select("jobs.job");
-
+  Index number_of_jobs = 0;
   Index updated_jobs = 0;
   Index incomplete_jobs = 0;
 
-  // loop over all jobs = pair records in the job file
-  for (const Property* prop : jobProps) {
+  // the jobs = pair records in the job file are read one by one
+  auto read_job = [&](const Property& prop) {
+    number_of_jobs++;
     // if job produced an output, then continue with analysis
-    if (prop->exists("output") && prop->exists("output.pair")) {
-      const Property& poutput = prop->get("output.pair");
+    if (prop.exists("output") && prop.exists("output.pair")) {
+      const Property& poutput = prop.get("output.pair");
       Index idA = poutput.getAttribute<Index>("idA");
       Index idB = poutput.getAttribute<Index>("idB");
       Segment& segA = top.getSegment(idA);
@@ -255,13 +253,14 @@ void IEXCITON::ReadJobFile(Topology& top) {
     } else {
       incomplete_jobs++;
     }
-  }
+  };
+  Property::StreamFromXML(jobfile_, "jobs.job", read_job);
 
   XTP_LOG(Log::error, log) << "Neighborlist size " << top.NBList().size()
                            << std::flush;
 
   XTP_LOG(Log::error, log) << "Pairs in jobfile [total:updated:incomplete] "
-                           << jobProps.size() << ":" << updated_jobs << ":"
+                           << number_of_jobs << ":" << updated_jobs << ":"
                            << incomplete_jobs << std::flush;
   std::cout << log;
 }
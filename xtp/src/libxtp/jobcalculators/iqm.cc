@@ -679,26 +679,22 @@ void IQM::ReadJobFile(Topology& top) {
   Logger log;
   log.setReportLevel(Log::current_level);
 
-  tools::Property xml;
-  // load the QC results in a vector indexed by the pair ID
-  xml.LoadFromXML(jobfile_);
-
-  // loop over all jobs = pair records in the job file
-  for (tools::Property* job : xml.Select("jobs.job")) {
-    if (!job->exists("status")) {
+  // the jobs = pair records in the job file are read one by one
+  auto read_job = [&](tools::Property& job) {
+    if (!job.exists("status")) {
       throw std::runtime_error(
           "Jobfile is malformed. <status> tag missing on job.");
     }
-    if (job->get("status").as<std::string>() != "COMPLETE" ||
-        !job->exists("output")) {
+    if (job.get("status").as<std::string>() != "COMPLETE" ||
+        !job.exists("output")) {
       incomplete_jobs++;
-      continue;
+      return;
     }
 
     // job file is stupid, because segment ids are only in input have to get
     // them out l
     std::vector<Index> id;
-    for (tools::Property* segment : job->Select("input.segment")) {
+    for (tools::Property* segment : job.Select("input.segment")) {
       id.push_back(segment->getAttribute<Index>("id"));
     }
     if (id.size() != 2) {
@@ -717,17 +713,17 @@ void IQM::ReadJobFile(Topology& top) {
       XTP_LOG(Log::error, log)
           << "No pair " << id[0] << ":" << id[1]
           << " found in the neighbor list. Ignoring" << std::flush;
-      continue;
+      return;
     }
     if (qmp->getType() != QMPair::PairType::Hopping) {
       XTP_LOG(Log::error, log) << "WARNING Pair " << qmp->getId()
                                << " is not of any of the "
                                   "Hopping type. Skipping pair"
                                << std::flush;
-      continue;
+      return;
     }
 
-    const tools::Property& pair_property = job->get("output");
+    const tools::Property& pair_property = job.get("output");
 
     if (pair_property.exists("dftcoupling")) {
       const tools::Property& dftprop = pair_property.get("dftcoupling");
@@ -785,7 +781,8 @@ void IQM::ReadJobFile(Topology& top) {
         }
       }
     }
-  }
+  };
+  tools::Property::StreamFromXML(jobfile_, "jobs.job", read_job);
   XTP_LOG(Log::error, log) << "Pairs [total:updated(e,h,s,t)] "
                            << number_of_pairs << ":(" << dft_e << "," << dft_h
                            << "," << bse_s << "," << bse_t